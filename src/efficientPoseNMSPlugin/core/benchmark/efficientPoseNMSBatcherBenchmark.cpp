@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures EfficientPoseNMSHostBatcher with many producers, such as one per camera, that each submit single images and
+// wait for their results. The same producers are first run with direct batch size 1 calls, each on its own workspace,
+// as the baseline. Both share one executor. The results of the batched calls are checked against the direct ones.
+//
+// Usage: efficientposenms_batcher_benchmark [--producers=P] [--frames=N] [--max-batch=B] [--max-delay-us=D]
+//                                           [--anchors=A] [--classes=C] [--threads=T]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "efficientPoseNMSHostBatcher.h"
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSHostBatcher;
+using nvinfer1::plugin::EfficientPoseNMSHostBatcherStats;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSHostFrame;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+// Small deterministic generator, so that every run processes the same inputs.
+uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+// The outputs of one image.
+struct FrameOutputs
+{
+    int32_t numDetections{0};
+    std::vector<float> boxes;
+    std::vector<float> keypoints;
+    std::vector<float> scores;
+    std::vector<int32_t> classes;
+
+    explicit FrameOutputs(int32_t numOutputBoxes)
+        : boxes(numOutputBoxes * 4)
+        , keypoints(numOutputBoxes * 3)
+        , scores(numOutputBoxes)
+        , classes(numOutputBoxes)
+    {
+    }
+
+    bool operator==(FrameOutputs const& other) const
+    {
+        return numDetections == other.numDetections && boxes == other.boxes && scores == other.scores
+            && classes == other.classes;
+    }
+};
+
+template <typename F>
+double runProducers(int32_t numProducers, F&& producer)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int32_t p = 0; p < numProducers; p++)
+    {
+        threads.emplace_back(producer, p);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int32_t numProducers = 16;
+    int32_t numFrames = 200;
+    int32_t maxBatchSize = 8;
+    int32_t maxDelay = 1000;
+    int32_t numAnchors = 8400;
+    int32_t numClasses = 1;
+    int32_t numThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--producers=", 12))
+        {
+            numProducers = std::atoi(argv[i] + 12);
+        }
+        else if (!std::strncmp(argv[i], "--frames=", 9))
+        {
+            numFrames = std::atoi(argv[i] + 9);
+        }
+        else if (!std::strncmp(argv[i], "--max-batch=", 12))
+        {
+            maxBatchSize = std::atoi(argv[i] + 12);
+        }
+        else if (!std::strncmp(argv[i], "--max-delay-us=", 15))
+        {
+            maxDelay = std::atoi(argv[i] + 15);
+        }
+        else if (!std::strncmp(argv[i], "--anchors=", 10))
+        {
+            numAnchors = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--classes=", 10))
+        {
+            numClasses = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--threads=", 10))
+        {
+            numThreads = std::atoi(argv[i] + 10);
+        }
+        else
+        {
+            std::fprintf(stderr,
+                "Usage: %s [--producers=P] [--frames=N] [--max-batch=B] [--max-delay-us=D] [--anchors=A] "
+                "[--classes=C] [--threads=T]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+    if (numProducers < 1 || numFrames < 1 || maxBatchSize < 1 || maxDelay < 0 || numAnchors < 1 || numClasses < 1
+        || numThreads < 1)
+    {
+        std::fprintf(stderr, "all options must be positive\n");
+        return 1;
+    }
+
+    EfficientPoseNMSParameters param;
+    param.scoreThreshold = 0.25F;
+    param.iouThreshold = 0.5F;
+    param.numOutputBoxes = 100;
+    param.numSelectedBoxes = 5000;
+    param.batchSize = 1;
+    param.numClasses = numClasses;
+    param.numAnchors = numAnchors;
+    param.numScoreElements = numAnchors * numClasses;
+    param.numBoxElements = numAnchors * 4;
+
+    // Inputs: a few different images, which the producers cycle through. Boxes [A, 4] as corners, and scores [A, C]
+    // with most of them below the score threshold, like the output of a real detector.
+    int32_t const numImages = 8;
+    uint32_t state = 1;
+    std::vector<std::vector<float>> boxes(numImages, std::vector<float>(static_cast<size_t>(numAnchors) * 4));
+    std::vector<std::vector<float>> scores(
+        numImages, std::vector<float>(static_cast<size_t>(numAnchors) * numClasses));
+    for (int32_t image = 0; image < numImages; image++)
+    {
+        for (size_t i = 0; i < boxes[image].size(); i += 4)
+        {
+            float y = (nextRandom(state) % 1000) / 1000.F;
+            float x = (nextRandom(state) % 1000) / 1000.F;
+            boxes[image][i + 0] = y;
+            boxes[image][i + 1] = x;
+            boxes[image][i + 2] = y + 0.02F + (nextRandom(state) % 200) / 1000.F;
+            boxes[image][i + 3] = x + 0.02F + (nextRandom(state) % 200) / 1000.F;
+        }
+        for (auto& score : scores[image])
+        {
+            score = (nextRandom(state) % 10000) / 10000.F;
+            score = score * score * score;
+        }
+    }
+
+    EfficientPoseNMSHostExecutor executor(numThreads - 1);
+    size_t const workspaceSize
+        = EfficientPoseNMSHostWorkspaceSize(1, param.numScoreElements, numClasses, DataType::kFLOAT);
+
+    // Reference results, one per image.
+    std::vector<FrameOutputs> references(numImages, FrameOutputs(param.numOutputBoxes));
+    {
+        std::vector<char> workspace(workspaceSize);
+        for (int32_t image = 0; image < numImages; image++)
+        {
+            FrameOutputs& outputs = references[image];
+            EfficientPoseNMSHostInference(param, boxes[image].data(), scores[image].data(), nullptr, nullptr,
+                &outputs.numDetections, outputs.boxes.data(), outputs.keypoints.data(), outputs.scores.data(),
+                outputs.classes.data(), nullptr, nullptr, workspace.data());
+        }
+    }
+
+    std::printf("%d producers, %d frames each, anchors %d, classes %d, %d threads\n", numProducers, numFrames,
+        numAnchors, numClasses, numThreads);
+
+    // Direct batch size 1 calls.
+    double directSeconds = runProducers(numProducers, [&](int32_t producer) {
+        FrameOutputs outputs(param.numOutputBoxes);
+        std::vector<char> workspace(workspaceSize);
+        for (int32_t frame = 0; frame < numFrames; frame++)
+        {
+            int32_t image = (producer + frame) % numImages;
+            EfficientPoseNMSHostInference(param, boxes[image].data(), scores[image].data(), nullptr, nullptr,
+                &outputs.numDetections, outputs.boxes.data(), outputs.keypoints.data(), outputs.scores.data(),
+                outputs.classes.data(), nullptr, nullptr, workspace.data(), &executor);
+        }
+    });
+
+    // Batched calls.
+    std::vector<int32_t> numMismatches(numProducers, 0);
+    std::vector<double> totalLatency(numProducers, 0.);
+    EfficientPoseNMSHostBatcherStats stats;
+    double batchedSeconds = 0.;
+    {
+        EfficientPoseNMSHostBatcher batcher(param, maxBatchSize, nullptr, &executor);
+        batchedSeconds = runProducers(numProducers, [&](int32_t producer) {
+            FrameOutputs outputs(param.numOutputBoxes);
+            for (int32_t frame = 0; frame < numFrames; frame++)
+            {
+                int32_t image = (producer + frame) % numImages;
+                EfficientPoseNMSHostFrame request;
+                request.boxesInput = boxes[image].data();
+                request.scoresInput = scores[image].data();
+                request.numDetectionsOutput = &outputs.numDetections;
+                request.nmsBoxesOutput = outputs.boxes.data();
+                request.nmsKptsOutput = outputs.keypoints.data();
+                request.nmsScoresOutput = outputs.scores.data();
+                request.nmsClassesOutput = outputs.classes.data();
+                request.maxDelay = std::chrono::microseconds(maxDelay);
+                auto start = std::chrono::steady_clock::now();
+                pluginStatus_t status = batcher.submit(request).get();
+                auto const elapsed = std::chrono::steady_clock::now() - start;
+                totalLatency[producer] += std::chrono::duration<double>(elapsed).count();
+                if (status != STATUS_SUCCESS || !(outputs == references[image]))
+                {
+                    numMismatches[producer]++;
+                }
+            }
+        });
+        stats = batcher.getStats();
+    }
+
+    int64_t const numCalls = static_cast<int64_t>(numProducers) * numFrames;
+    int32_t mismatches = 0;
+    double latency = 0.;
+    for (int32_t producer = 0; producer < numProducers; producer++)
+    {
+        mismatches += numMismatches[producer];
+        latency += totalLatency[producer];
+    }
+    std::printf("%-10s %14s\n", "mode", "frames/s");
+    std::printf("%-10s %14.1f\n", "direct", numCalls / directSeconds);
+    std::printf("%-10s %14.1f\n", "batched", numCalls / batchedSeconds);
+    std::printf("max batch %d, max delay %d us: %lld batches, %lld full, fill rate %.2f\n", maxBatchSize, maxDelay,
+        static_cast<long long>(stats.numBatches), static_cast<long long>(stats.numFullBatches),
+        stats.batchFillRate(maxBatchSize));
+    std::printf("queueing delay avg %.1f us, max %.1f us, request latency avg %.1f us, %d mismatches\n",
+        stats.numFrames > 0 ? stats.totalQueueDelay / 1e3 / stats.numFrames : 0., stats.maxQueueDelay / 1e3,
+        latency * 1e6 / numCalls, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,567 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the throughput of the host implementation of EfficientPoseNMSInference for every thread count and thread
+// placement: unpinned, pinned to consecutive CPUs, and pinned to the CPUs of each NUMA node. The inputs, outputs and
+// workspace of every run are allocated through the executor, so that they are local to the threads of that run.
+// With --ring, the detections are published into a ring buffer instead, which a separate consumer thread drains, and
+// the number of frames dropped because the ring was full is reported as well. With --packed, the detections are
+// written in the packed format for an image of the given size, and the output sizes and the unpacking throughput are
+// reported as well. With --compact, the detections of all images are written back to back, and the output bytes and
+// the throughput of one thread are compared with those of the padded output. With --oks, boxes are suppressed on the
+// OKS of K keypoints per anchor as well. With --fp16, the inputs and outputs are fp16. With --sort, the filter and
+// sort stage of fp16 inputs is timed with the counting sort on BITS score bits and with the full sort, over a range of
+// score thresholds, and so of candidate counts.
+//
+// Usage: efficientposenms_host_benchmark [--iterations=N] [--batch=B] [--anchors=A] [--classes=C] [--class-argmax]
+//                                       [--huge-pages] [--ring] [--packed=HEIGHTxWIDTH] [--compact] [--oks=K] [--fp16]
+//                                       [--sort=BITS]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSIndexing.h"
+#include "efficientPoseNMSPacked.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSDetectionRing;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSOutputKeypoints;
+using nvinfer1::plugin::EfficientPoseNMSPackedDetection;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+struct Placement
+{
+    std::string name;
+    // CPUs to pin to, in order: the calling thread takes the first one, and the workers the next ones. An empty list
+    // leaves all threads unpinned.
+    std::vector<int32_t> cpus;
+    int32_t maxThreads;
+};
+
+// Small deterministic generator, so that every run processes the same inputs.
+uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+// Converts the generated inputs to the input type. The fp16 conversion truncates, and flushes values below the normal
+// range to zero, which is good enough for generated inputs.
+std::vector<char> encodeInput(std::vector<float> const& values, bool fp16)
+{
+    std::vector<char> encoded(values.size() * (fp16 ? sizeof(uint16_t) : sizeof(float)));
+    if (!fp16)
+    {
+        std::memcpy(encoded.data(), values.data(), encoded.size());
+        return encoded;
+    }
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        uint16_t half = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        if (exponent >= 31)
+        {
+            half |= 0x7C00;
+        }
+        else if (exponent > 0)
+        {
+            half |= static_cast<uint16_t>((exponent << 10) | ((bits >> 13) & 0x3FF));
+        }
+        std::memcpy(encoded.data() + i * sizeof(uint16_t), &half, sizeof(half));
+    }
+    return encoded;
+}
+
+// Executor owned buffer, released with the executor allocation size.
+struct HostBuffer
+{
+    void* data{nullptr};
+    size_t size{0};
+
+    HostBuffer(EfficientPoseNMSHostExecutor& executor, size_t bytes, bool hugePages)
+        : data(executor.allocate(bytes, hugePages))
+        , size(bytes)
+    {
+    }
+
+    ~HostBuffer()
+    {
+        EfficientPoseNMSHostExecutor::deallocate(data, size);
+    }
+
+    HostBuffer(HostBuffer const&) = delete;
+    HostBuffer& operator=(HostBuffer const&) = delete;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int32_t numIterations = 200;
+    int32_t batchSize = 8;
+    int32_t numAnchors = 8400;
+    int32_t numClasses = 1;
+    bool classArgmax = false;
+    bool hugePages = false;
+    bool ring = false;
+    int32_t packedHeight = 0;
+    int32_t packedWidth = 0;
+    bool compact = false;
+    int32_t numKeypoints = 0;
+    bool fp16 = false;
+    int32_t sortScoreBits = 0;
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--iterations=", 13))
+        {
+            numIterations = std::atoi(argv[i] + 13);
+        }
+        else if (!std::strncmp(argv[i], "--batch=", 8))
+        {
+            batchSize = std::atoi(argv[i] + 8);
+        }
+        else if (!std::strncmp(argv[i], "--anchors=", 10))
+        {
+            numAnchors = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--classes=", 10))
+        {
+            numClasses = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strcmp(argv[i], "--class-argmax"))
+        {
+            classArgmax = true;
+        }
+        else if (!std::strcmp(argv[i], "--huge-pages"))
+        {
+            hugePages = true;
+        }
+        else if (!std::strcmp(argv[i], "--ring"))
+        {
+            ring = true;
+        }
+        else if (!std::strncmp(argv[i], "--packed=", 9))
+        {
+            if (std::sscanf(argv[i] + 9, "%dx%d", &packedHeight, &packedWidth) != 2 || packedHeight < 1
+                || packedWidth < 1 || packedHeight > 32767 || packedWidth > 32767)
+            {
+                std::fprintf(stderr, "--packed must be HEIGHTxWIDTH, each between 1 and 32767\n");
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--compact"))
+        {
+            compact = true;
+        }
+        else if (!std::strncmp(argv[i], "--oks=", 6))
+        {
+            numKeypoints = std::atoi(argv[i] + 6);
+            if (numKeypoints < 1 || numKeypoints > EFFICIENT_POSE_NMS_MAX_KEYPOINTS)
+            {
+                std::fprintf(stderr, "--oks must be between 1 and %d\n", EFFICIENT_POSE_NMS_MAX_KEYPOINTS);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--fp16"))
+        {
+            fp16 = true;
+        }
+        else if (!std::strncmp(argv[i], "--sort=", 7))
+        {
+            sortScoreBits = std::atoi(argv[i] + 7);
+            if (sortScoreBits < 1 || sortScoreBits > 10)
+            {
+                std::fprintf(stderr, "--sort must be between 1 and 10\n");
+                return 1;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr,
+                "Usage: %s [--iterations=N] [--batch=B] [--anchors=A] [--classes=C] [--class-argmax] [--huge-pages] "
+                "[--ring] [--packed=HEIGHTxWIDTH] [--compact] [--oks=K] [--fp16] [--sort=BITS]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+    if (numIterations < 1 || batchSize < 1 || numAnchors < 1 || numClasses < 1)
+    {
+        std::fprintf(stderr, "--iterations, --batch, --anchors and --classes must be positive\n");
+        return 1;
+    }
+
+    EfficientPoseNMSParameters param;
+    param.scoreThreshold = 0.25F;
+    param.iouThreshold = 0.5F;
+    param.numOutputBoxes = 100;
+    param.numSelectedBoxes = 5000;
+    param.batchSize = batchSize;
+    param.numClasses = numClasses;
+    param.datatype = fp16 ? DataType::kHALF : DataType::kFLOAT;
+    param.classArgmax = classArgmax;
+    param.packedOutput = packedHeight > 0;
+    param.packedImageHeight = std::max(packedHeight, 1);
+    param.packedImageWidth = std::max(packedWidth, 1);
+    param.compactOutput = compact;
+    param.numAnchors = numAnchors;
+    param.numScoreElements = numAnchors * numClasses;
+    param.numBoxElements = numAnchors * 4;
+    if (numKeypoints > 0)
+    {
+        param.oksThreshold = 0.5F;
+        param.numKeypoints = numKeypoints;
+        for (int32_t j = 0; j < numKeypoints; j++)
+        {
+            param.keypointSigmas[j] = 0.05F;
+        }
+    }
+
+    size_t const numBoxes = static_cast<size_t>(batchSize) * numAnchors * 4;
+    size_t const numScores = static_cast<size_t>(batchSize) * numAnchors * numClasses;
+    size_t const numKeypointValues = static_cast<size_t>(batchSize) * numAnchors * 3 * numKeypoints;
+    size_t const numOutputs = static_cast<size_t>(batchSize) * param.numOutputBoxes;
+    size_t const numOutputKeypointValues = 3 * static_cast<size_t>(EfficientPoseNMSOutputKeypoints(param));
+    size_t const workspaceSize = EfficientPoseNMSHostWorkspaceSize(
+        batchSize, param.numScoreElements, numClasses, DataType::kFLOAT, numKeypoints);
+
+    // Inputs: boxes [B, A, 4] as corners, and scores [B, A, C] with most of them below the score threshold, like the
+    // output of a real detector. They are generated once, and copied into the buffers of each run.
+    uint32_t state = 1;
+    std::vector<float> boxes(numBoxes);
+    for (size_t i = 0; i < boxes.size(); i += 4)
+    {
+        float y = (nextRandom(state) % 1000) / 1000.F;
+        float x = (nextRandom(state) % 1000) / 1000.F;
+        float h = 0.02F + (nextRandom(state) % 200) / 1000.F;
+        float w = 0.02F + (nextRandom(state) % 200) / 1000.F;
+        boxes[i + 0] = y;
+        boxes[i + 1] = x;
+        boxes[i + 2] = y + h;
+        boxes[i + 3] = x + w;
+    }
+    std::vector<float> scores(numScores);
+    for (auto& score : scores)
+    {
+        score = (nextRandom(state) % 10000) / 10000.F;
+        score = score * score * score;
+    }
+    // Keypoints [B, A, K * 3] within their box, of which about one in four is not visible.
+    std::vector<float> keypoints(numKeypointValues);
+    for (size_t i = 0; i < keypoints.size(); i += 3)
+    {
+        size_t const box = i / (3 * numKeypoints) * 4;
+        keypoints[i + 0] = boxes[box + 0] + (boxes[box + 2] - boxes[box + 0]) * (nextRandom(state) % 1000) / 1000.F;
+        keypoints[i + 1] = boxes[box + 1] + (boxes[box + 3] - boxes[box + 1]) * (nextRandom(state) % 1000) / 1000.F;
+        keypoints[i + 2] = (nextRandom(state) % 4) == 0 ? 0.F : 1.F;
+    }
+    std::vector<char> const boxesInput = encodeInput(boxes, fp16);
+    std::vector<char> const scoresInput = encodeInput(scores, fp16);
+    std::vector<char> const keypointsInput = encodeInput(keypoints, fp16);
+
+    int32_t const numCpus = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    std::vector<Placement> placements;
+    placements.push_back({"unpinned", {}, numCpus});
+    std::vector<int32_t> compactCpus(numCpus);
+    for (int32_t cpu = 0; cpu < numCpus; cpu++)
+    {
+        compactCpus[cpu] = cpu;
+    }
+    placements.push_back({"compact", compactCpus, numCpus});
+    for (int32_t node = 0;; node++)
+    {
+        std::vector<int32_t> nodeCpus = EfficientPoseNMSHostExecutor::getNodeCpus(node);
+        if (nodeCpus.empty())
+        {
+            break;
+        }
+        int32_t nodeThreads = static_cast<int32_t>(nodeCpus.size());
+        placements.push_back({"node" + std::to_string(node), std::move(nodeCpus), nodeThreads});
+    }
+
+    std::printf("batch %d, anchors %d, classes %d, %d iterations%s%s%s%s%s", batchSize, numAnchors, numClasses,
+        numIterations, fp16 ? ", fp16" : "", classArgmax ? ", class argmax" : "", hugePages ? ", huge pages" : "",
+        ring ? ", ring" : "", compact ? ", compact" : "");
+    if (numKeypoints > 0)
+    {
+        std::printf(", oks with %d keypoints", numKeypoints);
+    }
+    std::printf("\n");
+    if (param.packedOutput)
+    {
+        // Both with the detection count of each image, and the standard one with fp32 boxes, keypoints and scores.
+        size_t const standardBytes = param.numOutputBoxes * (4 + 3 + 1 + 1) * sizeof(float) + sizeof(int32_t);
+        size_t const packedBytes = param.numOutputBoxes * sizeof(EfficientPoseNMSPackedDetection) + sizeof(int32_t);
+        std::printf("packed %dx%d, output bytes per image: %zu standard, %zu packed\n", packedHeight, packedWidth,
+            standardBytes, packedBytes);
+    }
+    std::printf(
+        "%-12s %8s %14s %14s%s\n", "placement", "threads", "avg us/call", "images/s", ring ? "    dropped" : "");
+    for (Placement const& placement : placements)
+    {
+        for (int32_t numThreads = 1; numThreads <= placement.maxThreads; numThreads *= 2)
+        {
+            // Each run pins the calling thread as well, as it takes part in the work. It gets the first CPU of the
+            // placement, and the workers the following ones.
+            std::vector<int32_t> workerCpus;
+            if (!placement.cpus.empty())
+            {
+                EfficientPoseNMSHostExecutor::pinCurrentThread({placement.cpus[0]});
+                workerCpus.assign(placement.cpus.begin() + 1, placement.cpus.begin() + numThreads);
+            }
+            else
+            {
+                EfficientPoseNMSHostExecutor::pinCurrentThread(compactCpus);
+            }
+            EfficientPoseNMSHostExecutor executor(numThreads - 1, workerCpus);
+
+            HostBuffer boxesBuffer(executor, boxesInput.size(), hugePages);
+            HostBuffer scoresBuffer(executor, scoresInput.size(), hugePages);
+            HostBuffer keypointsBuffer(executor, keypointsInput.size(), hugePages);
+            // Boxes, keypoints, scores and classes, followed by the detection counts and the compact offsets. The
+            // packed detections are written to the boxes, and are smaller than all four.
+            size_t const outputsSize
+                = numOutputs * (4 + numOutputKeypointValues + 1 + 1) * sizeof(float)
+                + (2 * batchSize + 1) * sizeof(int32_t);
+            HostBuffer outputsBuffer(executor, outputsSize, hugePages);
+            HostBuffer workspaceBuffer(executor, workspaceSize, hugePages);
+            if (boxesBuffer.data == nullptr || scoresBuffer.data == nullptr || outputsBuffer.data == nullptr
+                || (numKeypointValues > 0 && keypointsBuffer.data == nullptr)
+                || (workspaceSize > 0 && workspaceBuffer.data == nullptr))
+            {
+                std::fprintf(stderr, "allocation failed\n");
+                return 1;
+            }
+            std::memcpy(boxesBuffer.data, boxesInput.data(), boxesInput.size());
+            std::memcpy(scoresBuffer.data, scoresInput.data(), scoresInput.size());
+            if (numKeypointValues > 0)
+            {
+                std::memcpy(keypointsBuffer.data, keypointsInput.data(), keypointsInput.size());
+            }
+            float* nmsBoxes = static_cast<float*>(outputsBuffer.data);
+            float* nmsKpts = nmsBoxes + numOutputs * 4;
+            float* nmsScores = nmsKpts + numOutputs * numOutputKeypointValues;
+            int32_t* nmsClasses = reinterpret_cast<int32_t*>(nmsScores + numOutputs);
+            int32_t* numDetections = nmsClasses + numOutputs;
+            int32_t* nmsOffsets = numDetections + batchSize;
+
+            // The ring holds a few batches worth of detections, and its consumer only counts what it reads.
+            EfficientPoseNMSDetectionRing detectionRing(static_cast<size_t>(numOutputs) * 4);
+            std::atomic<bool> consumerDone{false};
+            std::thread consumer;
+            if (ring)
+            {
+                consumer = std::thread([&]() {
+                    while (!consumerDone.load(std::memory_order_relaxed))
+                    {
+                        size_t available = detectionRing.available();
+                        if (available == 0)
+                        {
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        detectionRing.release(available);
+                    }
+                });
+            }
+            int64_t frameId = 0;
+            int64_t numDroppedFrames = 0;
+            auto run = [&]() {
+                if (!ring)
+                {
+                    return EfficientPoseNMSHostInference(param, boxesBuffer.data, scoresBuffer.data, nullptr,
+                        keypointsBuffer.data, numDetections, nmsBoxes, nmsKpts, nmsScores, nmsClasses, nullptr,
+                        compact ? nmsOffsets : nullptr, workspaceBuffer.data, &executor);
+                }
+                int32_t numPublishedFrames = 0;
+                pluginStatus_t ringStatus = EfficientPoseNMSHostInferenceToRing(param, boxesBuffer.data,
+                    scoresBuffer.data, nullptr, keypointsBuffer.data, &detectionRing, frameId, &numPublishedFrames,
+                    workspaceBuffer.data, &executor);
+                frameId += batchSize;
+                numDroppedFrames += batchSize - numPublishedFrames;
+                return ringStatus;
+            };
+
+            // One untimed call to warm up the caches and the executor threads.
+            pluginStatus_t status = run();
+            numDroppedFrames = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int32_t iteration = 0; iteration < numIterations && status == STATUS_SUCCESS; iteration++)
+            {
+                status = run();
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (ring)
+            {
+                consumerDone.store(true, std::memory_order_relaxed);
+                consumer.join();
+            }
+            if (status != STATUS_SUCCESS)
+            {
+                std::fprintf(stderr, "EfficientPoseNMSHostInference failed with status %d\n", status);
+                return 1;
+            }
+
+            double seconds = std::chrono::duration<double>(end - start).count();
+            std::printf("%-12s %8d %14.1f %14.1f", placement.name.c_str(), numThreads, seconds * 1e6 / numIterations,
+                static_cast<double>(numIterations) * batchSize / seconds);
+            if (ring)
+            {
+                std::printf(" %10lld", static_cast<long long>(numDroppedFrames));
+            }
+            std::printf("\n");
+        }
+    }
+
+    if (param.compactOutput)
+    {
+        // One call at a time on the calling thread, with the padded and then the compact output. The bytes written are
+        // the detection counts, the rows up to numOutputBoxes per image when padded and up to the total count when
+        // compact, and the offsets when compact.
+        size_t const elementBytes = fp16 ? sizeof(uint16_t) : sizeof(float);
+        size_t const rowBytes = param.packedOutput ? sizeof(EfficientPoseNMSPackedDetection)
+                                                   : (4 + numOutputKeypointValues + 1) * elementBytes + sizeof(int32_t);
+        std::vector<char> rows(numOutputs * rowBytes);
+        std::vector<int32_t> numDetections(batchSize);
+        std::vector<int32_t> offsets(batchSize + 1);
+        std::vector<char> workspace(workspaceSize);
+        char* nmsBoxes = rows.data();
+        char* nmsKpts = param.packedOutput ? nullptr : nmsBoxes + numOutputs * 4 * elementBytes;
+        char* nmsScores
+            = param.packedOutput ? nullptr : nmsKpts + numOutputs * numOutputKeypointValues * elementBytes;
+        char* nmsClasses = param.packedOutput ? nullptr : nmsScores + numOutputs * elementBytes;
+        std::printf("%-12s %14s %14s %14s\n", "output", "bytes/call", "avg us/call", "images/s");
+        for (bool compactRun : {false, true})
+        {
+            EfficientPoseNMSParameters runParam = param;
+            runParam.compactOutput = compactRun;
+            pluginStatus_t status = STATUS_SUCCESS;
+            auto start = std::chrono::steady_clock::now();
+            for (int32_t iteration = 0; iteration < numIterations && status == STATUS_SUCCESS; iteration++)
+            {
+                status = EfficientPoseNMSHostInference(runParam, boxesInput.data(), scoresInput.data(), nullptr,
+                    keypointsInput.data(), numDetections.data(), nmsBoxes, nmsKpts, nmsScores, nmsClasses, nullptr,
+                    compactRun ? offsets.data() : nullptr, workspace.data());
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (status != STATUS_SUCCESS)
+            {
+                std::fprintf(stderr, "EfficientPoseNMSHostInference failed with status %d\n", status);
+                return 1;
+            }
+            size_t const numRows = compactRun ? static_cast<size_t>(offsets[batchSize]) : numOutputs;
+            size_t const bytes = numRows * rowBytes + batchSize * sizeof(int32_t)
+                + (compactRun ? offsets.size() * sizeof(int32_t) : 0);
+            double seconds = std::chrono::duration<double>(end - start).count();
+            std::printf("%-12s %14zu %14.1f %14.1f\n", compactRun ? "compact" : "padded", bytes,
+                seconds * 1e6 / numIterations, static_cast<double>(numIterations) * batchSize / seconds);
+        }
+    }
+
+    if (sortScoreBits > 0)
+    {
+        // The score bits counting sort only applies to fp16 inputs. Every candidate above the threshold is kept, so
+        // that the sorts see them all, and the filter time of the host profile is that of the filter and the sort.
+        EfficientPoseNMSParameters sortParam = param;
+        sortParam.datatype = DataType::kHALF;
+        sortParam.numSelectedBoxes = sortParam.numScoreElements;
+        std::vector<char> const halfBoxes = encodeInput(boxes, true);
+        std::vector<char> const halfScores = encodeInput(scores, true);
+        std::vector<char> const halfKeypoints = encodeInput(keypoints, true);
+        std::vector<char> halfOutputs(numOutputs * (4 + numOutputKeypointValues + 1) * sizeof(uint16_t));
+        std::vector<int32_t> numDetections(batchSize);
+        std::vector<int32_t> classes(numOutputs);
+        std::vector<int32_t> numCandidates(batchSize);
+        std::vector<char> workspace(EfficientPoseNMSHostWorkspaceSize(
+            batchSize, sortParam.numScoreElements, numClasses, DataType::kHALF, numKeypoints));
+        char* nmsBoxes = halfOutputs.data();
+        char* nmsKpts = nmsBoxes + numOutputs * 4 * sizeof(uint16_t);
+        char* nmsScores = nmsKpts + numOutputs * numOutputKeypointValues * sizeof(uint16_t);
+        std::printf("%-12s %14s %14s %14s\n", "threshold", "candidates", "sort us/call", "count us/call");
+        for (float threshold : {0.9F, 0.7F, 0.5F, 0.3F, 0.2F, 0.1F, 0.05F, 0.01F})
+        {
+            sortParam.scoreThreshold = threshold;
+            double filterTimes[2];
+            int64_t totalCandidates = 0;
+            for (int32_t counting = 0; counting < 2; counting++)
+            {
+                sortParam.scoreBits = counting ? sortScoreBits : -1;
+                nvinfer1::plugin::EfficientPoseNMSHostProfile profile;
+                profile.numCandidates = numCandidates.data();
+                int64_t filterTime = 0;
+                for (int32_t iteration = 0; iteration < numIterations; iteration++)
+                {
+                    pluginStatus_t status = EfficientPoseNMSHostInference(sortParam, halfBoxes.data(),
+                        halfScores.data(), nullptr, halfKeypoints.data(), numDetections.data(), nmsBoxes, nmsKpts,
+                        nmsScores, classes.data(), nullptr, nullptr, workspace.data(), nullptr, &profile);
+                    if (status != STATUS_SUCCESS)
+                    {
+                        std::fprintf(stderr, "EfficientPoseNMSHostInference failed with status %d\n", status);
+                        return 1;
+                    }
+                    filterTime += profile.filterTime;
+                }
+                filterTimes[counting] = filterTime * 1e-3 / numIterations;
+            }
+            for (int32_t candidates : numCandidates)
+            {
+                totalCandidates += candidates;
+            }
+            std::printf("%-12.2f %14lld %14.1f %14.1f\n", threshold, static_cast<long long>(totalCandidates),
+                filterTimes[0], filterTimes[1]);
+        }
+    }
+
+    if (param.packedOutput)
+    {
+        // Unpacking, as done by the consumers of the packed output, of the full padded output of one call.
+        std::vector<int32_t> numDetections(batchSize);
+        std::vector<EfficientPoseNMSPackedDetection> packed(numOutputs);
+        std::vector<char> workspace(workspaceSize);
+        EfficientPoseNMSHostInference(param, boxesInput.data(), scoresInput.data(), nullptr, keypointsInput.data(),
+            numDetections.data(), packed.data(), nullptr, nullptr, nullptr, nullptr, nullptr, workspace.data());
+        std::vector<float> unpackedBoxes(numOutputs * 4);
+        std::vector<float> unpackedKeypoints(numOutputs * 3);
+        std::vector<float> unpackedScores(numOutputs);
+        std::vector<int32_t> unpackedClasses(numOutputs);
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t iteration = 0; iteration < numIterations; iteration++)
+        {
+            nvinfer1::plugin::EfficientPoseNMSUnpackDetections(packed.data(), static_cast<int32_t>(numOutputs),
+                packedHeight, packedWidth, unpackedBoxes.data(), unpackedKeypoints.data(), unpackedScores.data(),
+                unpackedClasses.data());
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::printf("unpack %.2f ns/detection\n", seconds * 1e9 / (static_cast<double>(numIterations) * numOutputs));
+    }
+    return 0;
+}
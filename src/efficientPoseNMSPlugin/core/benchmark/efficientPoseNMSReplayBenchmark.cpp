@@ -0,0 +1,441 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays recorded model outputs through the host implementation of EfficientPoseNMSInference, and reports for each
+// recording the frames per second, the latency percentiles of every stage, and a histogram of the number of
+// candidates per frame.
+//
+// A recording is a pair of files, the boxes [frames, anchors, 4] (or [frames, anchors, 1 or classes, 4]) and the
+// scores [frames, anchors, classes] (or [frames, anchors, classes, 1]), both fp32. Each file is either a .npy file, or
+// a raw file made of the "EPNMSRAW" magic, the number of dimensions as a little endian uint32, 4 bytes of padding,
+// the dimensions as little endian int64, and the data. The files are memory mapped, and every call reads its frames
+// directly from the mapping, so there is no file I/O or copy per frame.
+//
+// When built with EFFICIENT_POSE_NMS_TRACE, --trace writes the ranges of every call, and of every task within it, to
+// a Chrome trace event JSON file, to look into individual slow frames.
+//
+// Usage: efficientposenms_replay_benchmark [--batch=B] [--threads=T] [--passes=P] [--score-threshold=S]
+//            [--iou-threshold=I] [--trace=trace.json] boxes_file,scores_file [boxes_file,scores_file ...]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSTrace.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSHostProfile;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+#ifdef EFFICIENT_POSE_NMS_TRACE
+using nvinfer1::plugin::EfficientPoseNMSChromeTraceSink;
+using nvinfer1::plugin::setEfficientPoseNMSTraceSink;
+#endif
+
+namespace
+{
+
+// Read only mapping of a recorded tensor, with its shape and the start of its fp32 data.
+class MappedTensor
+{
+public:
+    ~MappedTensor()
+    {
+        if (mMapping != nullptr)
+        {
+            munmap(mMapping, mMappingSize);
+        }
+    }
+
+    // Returns an error message, or an empty string on success.
+    std::string open(std::string const& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return "can not open " + path;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0 || status.st_size == 0)
+        {
+            ::close(fd);
+            return "can not read " + path;
+        }
+        mMappingSize = static_cast<size_t>(status.st_size);
+        void* mapping = mmap(nullptr, mMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            return "can not map " + path;
+        }
+        mMapping = mapping;
+        // Frames are replayed in order, so let the kernel read ahead.
+        madvise(mMapping, mMappingSize, MADV_SEQUENTIAL);
+
+        char const* bytes = static_cast<char const*>(mMapping);
+        size_t dataOffset = 0;
+        std::string error = mMappingSize >= 6 && !std::memcmp(bytes, "\x93NUMPY", 6) ? parseNpy(bytes, dataOffset)
+                                                                                    : parseRaw(bytes, dataOffset);
+        if (!error.empty())
+        {
+            return path + ": " + error;
+        }
+        size_t numElements = 1;
+        for (int64_t dim : mShape)
+        {
+            if (dim < 1)
+            {
+                return path + ": invalid shape";
+            }
+            numElements *= static_cast<size_t>(dim);
+        }
+        if (dataOffset % alignof(float) != 0 || dataOffset + numElements * sizeof(float) > mMappingSize)
+        {
+            return path + ": the data does not match the shape";
+        }
+        mData = reinterpret_cast<float const*>(bytes + dataOffset);
+        return "";
+    }
+
+    std::vector<int64_t> const& shape() const
+    {
+        return mShape;
+    }
+
+    float const* data() const
+    {
+        return mData;
+    }
+
+private:
+    std::string parseNpy(char const* bytes, size_t& dataOffset)
+    {
+        // Version 1 has a 2 byte header length, versions 2 and 3 a 4 byte one.
+        if (mMappingSize < 10)
+        {
+            return "truncated .npy header";
+        }
+        uint8_t const* header = reinterpret_cast<uint8_t const*>(bytes);
+        size_t headerLength = 0;
+        size_t headerStart = 0;
+        if (header[6] == 1)
+        {
+            headerLength = header[8] | (header[9] << 8);
+            headerStart = 10;
+        }
+        else
+        {
+            if (mMappingSize < 12)
+            {
+                return "truncated .npy header";
+            }
+            headerLength = header[8] | (header[9] << 8) | (header[10] << 16) | (static_cast<size_t>(header[11]) << 24);
+            headerStart = 12;
+        }
+        if (headerStart + headerLength > mMappingSize)
+        {
+            return "truncated .npy header";
+        }
+        std::string dict(bytes + headerStart, headerLength);
+        if (dict.find("'descr': '<f4'") == std::string::npos)
+        {
+            return "only little endian float32 .npy files are supported";
+        }
+        if (dict.find("'fortran_order': False") == std::string::npos)
+        {
+            return "only C order .npy files are supported";
+        }
+        size_t shapeStart = dict.find("'shape': (");
+        if (shapeStart == std::string::npos)
+        {
+            return "missing .npy shape";
+        }
+        char const* cursor = dict.c_str() + shapeStart + 10;
+        while (*cursor != ')' && *cursor != '\0')
+        {
+            char* end = nullptr;
+            long long dim = std::strtoll(cursor, &end, 10);
+            if (end == cursor)
+            {
+                break;
+            }
+            mShape.push_back(dim);
+            cursor = end;
+            while (*cursor == ',' || *cursor == ' ')
+            {
+                cursor++;
+            }
+        }
+        dataOffset = headerStart + headerLength;
+        return "";
+    }
+
+    std::string parseRaw(char const* bytes, size_t& dataOffset)
+    {
+        if (mMappingSize < 16 || std::memcmp(bytes, "EPNMSRAW", 8))
+        {
+            return "neither a .npy nor a raw recording";
+        }
+        uint32_t nbDims;
+        std::memcpy(&nbDims, bytes + 8, sizeof(nbDims));
+        if (nbDims > 8 || 16 + nbDims * sizeof(int64_t) > mMappingSize)
+        {
+            return "invalid raw recording header";
+        }
+        mShape.resize(nbDims);
+        std::memcpy(mShape.data(), bytes + 16, nbDims * sizeof(int64_t));
+        dataOffset = 16 + nbDims * sizeof(int64_t);
+        return "";
+    }
+
+    void* mMapping{nullptr};
+    size_t mMappingSize{0};
+    std::vector<int64_t> mShape;
+    float const* mData{nullptr};
+};
+
+struct StageLatencies
+{
+    char const* name;
+    std::vector<int64_t> times;
+};
+
+double percentile(std::vector<int64_t>& times, double fraction)
+{
+    size_t rank = std::min(times.size() - 1, static_cast<size_t>(fraction * times.size()));
+    std::nth_element(times.begin(), times.begin() + rank, times.end());
+    return times[rank] / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int32_t batchSize = 1;
+    int32_t numThreads = 1;
+    int32_t numPasses = 1;
+    float scoreThreshold = 0.25F;
+    float iouThreshold = 0.5F;
+    char const* tracePath = nullptr;
+    std::vector<std::string> recordings;
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--batch=", 8))
+        {
+            batchSize = std::atoi(argv[i] + 8);
+        }
+        else if (!std::strncmp(argv[i], "--threads=", 10))
+        {
+            numThreads = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--passes=", 9))
+        {
+            numPasses = std::atoi(argv[i] + 9);
+        }
+        else if (!std::strncmp(argv[i], "--score-threshold=", 18))
+        {
+            scoreThreshold = std::atof(argv[i] + 18);
+        }
+        else if (!std::strncmp(argv[i], "--iou-threshold=", 16))
+        {
+            iouThreshold = std::atof(argv[i] + 16);
+        }
+        else if (!std::strncmp(argv[i], "--trace=", 8))
+        {
+            tracePath = argv[i] + 8;
+        }
+        else if (argv[i][0] != '-' && std::strchr(argv[i], ',') != nullptr)
+        {
+            recordings.emplace_back(argv[i]);
+        }
+        else
+        {
+            recordings.clear();
+            break;
+        }
+    }
+    if (recordings.empty() || batchSize < 1 || numThreads < 1 || numPasses < 1)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [--batch=B] [--threads=T] [--passes=P] [--score-threshold=S] [--iou-threshold=I]\n"
+            "           [--trace=trace.json] boxes_file,scores_file [boxes_file,scores_file ...]\n",
+            argv[0]);
+        return 1;
+    }
+
+#ifdef EFFICIENT_POSE_NMS_TRACE
+    // The sink is removed before it is destroyed, which completes the JSON file.
+    std::unique_ptr<EfficientPoseNMSChromeTraceSink> traceSink;
+    if (tracePath != nullptr)
+    {
+        traceSink.reset(new EfficientPoseNMSChromeTraceSink(tracePath));
+        if (!traceSink->isOpen())
+        {
+            std::fprintf(stderr, "%s: cannot open the trace file\n", tracePath);
+            return 1;
+        }
+        setEfficientPoseNMSTraceSink(traceSink.get());
+    }
+    struct TraceSinkReset
+    {
+        ~TraceSinkReset()
+        {
+            setEfficientPoseNMSTraceSink(nullptr);
+        }
+    } traceSinkReset;
+#else
+    if (tracePath != nullptr)
+    {
+        std::fprintf(stderr, "--trace needs a build with EFFICIENT_POSE_NMS_TRACE\n");
+        return 1;
+    }
+#endif
+
+    EfficientPoseNMSHostExecutor executor(numThreads - 1);
+    for (std::string const& recording : recordings)
+    {
+        size_t separator = recording.find(',');
+        MappedTensor boxes;
+        MappedTensor scores;
+        std::string error = boxes.open(recording.substr(0, separator));
+        if (error.empty())
+        {
+            error = scores.open(recording.substr(separator + 1));
+        }
+        std::vector<int64_t> const& boxesShape = boxes.shape();
+        std::vector<int64_t> const& scoresShape = scores.shape();
+        if (error.empty()
+            && !((scoresShape.size() == 3 || (scoresShape.size() == 4 && scoresShape[3] == 1))
+                && (boxesShape.size() == 3 || boxesShape.size() == 4) && boxesShape[0] == scoresShape[0]
+                && boxesShape[1] == scoresShape[1] && boxesShape.back() == 4
+                && (boxesShape.size() == 3 || boxesShape[2] == 1 || boxesShape[2] == scoresShape[2])))
+        {
+            error = "the boxes and scores shapes do not match";
+        }
+        if (error.empty() && scoresShape[0] < batchSize)
+        {
+            error = "the recording holds fewer frames than the batch size";
+        }
+        if (!error.empty())
+        {
+            std::fprintf(stderr, "%s: %s\n", recording.c_str(), error.c_str());
+            return 1;
+        }
+
+        int32_t const numFrames = static_cast<int32_t>(scoresShape[0]);
+        EfficientPoseNMSParameters param;
+        param.scoreThreshold = scoreThreshold;
+        param.iouThreshold = iouThreshold;
+        param.numOutputBoxes = 100;
+        param.numSelectedBoxes = 5000;
+        param.batchSize = batchSize;
+        param.numAnchors = static_cast<int32_t>(scoresShape[1]);
+        param.numClasses = static_cast<int32_t>(scoresShape[2]);
+        param.numScoreElements = param.numAnchors * param.numClasses;
+        param.shareLocation = boxesShape.size() == 3 || boxesShape[2] == 1;
+        param.numBoxElements = param.numAnchors * (param.shareLocation ? 1 : param.numClasses) * 4;
+
+        size_t const numOutputs = static_cast<size_t>(batchSize) * param.numOutputBoxes;
+        std::vector<int32_t> numDetections(batchSize);
+        std::vector<float> nmsBoxes(numOutputs * 4);
+        std::vector<float> nmsKpts(numOutputs * 3);
+        std::vector<float> nmsScores(numOutputs);
+        std::vector<int32_t> nmsClasses(numOutputs);
+        std::vector<int32_t> numCandidates(batchSize);
+        std::vector<char> workspace(EfficientPoseNMSHostWorkspaceSize(
+            batchSize, param.numScoreElements, param.numClasses, DataType::kFLOAT));
+
+        // Candidate counts are bucketed by powers of two: 0, 1, 2-3, 4-7, ...
+        std::vector<int64_t> histogram(32);
+        StageLatencies stages[] = {{"filter", {}}, {"gather", {}}, {"nms", {}}, {"write", {}}, {"total", {}}};
+        EfficientPoseNMSHostProfile profile;
+        profile.numCandidates = numCandidates.data();
+
+        // The last frames that do not fill a batch are not replayed.
+        int64_t framesReplayed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t pass = 0; pass < numPasses; pass++)
+        {
+            for (int32_t frame = 0; frame + batchSize <= numFrames; frame += batchSize)
+            {
+                float const* boxesInput = boxes.data() + static_cast<size_t>(frame) * param.numBoxElements;
+                float const* scoresInput = scores.data() + static_cast<size_t>(frame) * param.numScoreElements;
+                pluginStatus_t status = EfficientPoseNMSHostInference(param, boxesInput, scoresInput, nullptr,
+                    nullptr, numDetections.data(), nmsBoxes.data(), nmsKpts.data(), nmsScores.data(), nmsClasses.data(),
+                    nullptr, nullptr, workspace.data(), &executor, &profile);
+                if (status != STATUS_SUCCESS)
+                {
+                    std::fprintf(stderr, "%s: EfficientPoseNMSHostInference failed with status %d\n",
+                        recording.c_str(), status);
+                    return 1;
+                }
+                stages[0].times.push_back(profile.filterTime);
+                stages[1].times.push_back(profile.gatherTime);
+                stages[2].times.push_back(profile.nmsTime);
+                stages[3].times.push_back(profile.writeTime);
+                stages[4].times.push_back(
+                    profile.filterTime + profile.gatherTime + profile.nmsTime + profile.writeTime);
+                for (int32_t count : numCandidates)
+                {
+                    int32_t bucket = 0;
+                    while (bucket < 31 && (1 << bucket) <= count)
+                    {
+                        bucket++;
+                    }
+                    histogram[bucket]++;
+                }
+                framesReplayed += batchSize;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::printf("%s: %d frames, %d anchors, %d classes, batch %d, %d threads\n", recording.c_str(), numFrames,
+            param.numAnchors, param.numClasses, batchSize, numThreads);
+        std::printf("  %.1f frames/s\n", framesReplayed / seconds);
+        std::printf("  %-8s %12s %12s %12s %12s   (us per call)\n", "stage", "p50", "p90", "p99", "max");
+        for (StageLatencies& stage : stages)
+        {
+            std::printf("  %-8s %12.1f %12.1f %12.1f %12.1f\n", stage.name, percentile(stage.times, 0.5),
+                percentile(stage.times, 0.9), percentile(stage.times, 0.99), percentile(stage.times, 1.0));
+        }
+        std::printf("  %-17s %12s\n", "candidates", "frames");
+        for (int32_t bucket = 0; bucket < 32; bucket++)
+        {
+            if (histogram[bucket] == 0)
+            {
+                continue;
+            }
+            long long low = bucket == 0 ? 0 : 1LL << (bucket - 1);
+            long long high = bucket == 0 ? 0 : (1LL << bucket) - 1;
+            std::printf("  %8lld - %-6lld %12lld\n", low, high, static_cast<long long>(histogram[bucket]));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures streamed host inference, where the outputs of each FPN level are filtered as soon as they are produced,
+// against concatenating the levels into the usual inputs and running one call once the last level is produced. The
+// levels are produced levelDelay apart, as a detector head would, and the latency is measured from the production of
+// the last level to the results. The streamed results are checked against the concatenated ones.
+//
+// Usage: efficientposenms_stream_benchmark [--levels=A0,A1,...] [--batch=B] [--classes=C] [--level-delay-us=D]
+//                                          [--iterations=N] [--threads=T]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+// Small deterministic generator, so that every run processes the same inputs.
+uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+// The inputs of one level, laid out as [B, A, 4] boxes and [B, A, C] scores.
+struct Level
+{
+    int32_t numAnchors;
+    std::vector<float> boxes;
+    std::vector<float> scores;
+};
+
+struct Outputs
+{
+    std::vector<int32_t> numDetections;
+    std::vector<float> boxes;
+    std::vector<float> keypoints;
+    std::vector<float> scores;
+    std::vector<int32_t> classes;
+
+    Outputs(int32_t batchSize, int32_t numOutputBoxes)
+        : numDetections(batchSize)
+        , boxes(static_cast<size_t>(batchSize) * numOutputBoxes * 4)
+        , keypoints(static_cast<size_t>(batchSize) * numOutputBoxes * 3)
+        , scores(static_cast<size_t>(batchSize) * numOutputBoxes)
+        , classes(static_cast<size_t>(batchSize) * numOutputBoxes)
+    {
+    }
+
+    bool operator==(Outputs const& other) const
+    {
+        return numDetections == other.numDetections && boxes == other.boxes && scores == other.scores
+            && classes == other.classes;
+    }
+};
+
+// Waits until the given level is produced, levelDelay after the previous one.
+void waitForLevel(std::chrono::steady_clock::time_point start, std::chrono::microseconds levelDelay, int32_t level)
+{
+    std::this_thread::sleep_until(start + levelDelay * (level + 1));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<int32_t> levelAnchors{6400, 1600, 400};
+    int32_t batchSize = 1;
+    int32_t numClasses = 1;
+    int32_t levelDelay = 0;
+    int32_t numIterations = 200;
+    int32_t numThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--levels=", 9))
+        {
+            levelAnchors.clear();
+            char const* level = argv[i] + 9;
+            while (*level != '\0')
+            {
+                char* end = nullptr;
+                int32_t anchors = static_cast<int32_t>(std::strtol(level, &end, 10));
+                // Anything but a comma separated list is rejected as an empty level.
+                bool const valid = end != level && (*end == ',' || *end == '\0');
+                levelAnchors.push_back(valid ? anchors : 0);
+                if (!valid)
+                {
+                    break;
+                }
+                level = *end == ',' ? end + 1 : end;
+            }
+        }
+        else if (!std::strncmp(argv[i], "--batch=", 8))
+        {
+            batchSize = std::atoi(argv[i] + 8);
+        }
+        else if (!std::strncmp(argv[i], "--classes=", 10))
+        {
+            numClasses = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--level-delay-us=", 17))
+        {
+            levelDelay = std::atoi(argv[i] + 17);
+        }
+        else if (!std::strncmp(argv[i], "--iterations=", 13))
+        {
+            numIterations = std::atoi(argv[i] + 13);
+        }
+        else if (!std::strncmp(argv[i], "--threads=", 10))
+        {
+            numThreads = std::atoi(argv[i] + 10);
+        }
+        else
+        {
+            std::fprintf(stderr,
+                "Usage: %s [--levels=A0,A1,...] [--batch=B] [--classes=C] [--level-delay-us=D] [--iterations=N] "
+                "[--threads=T]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+    int32_t const numLevels = static_cast<int32_t>(levelAnchors.size());
+    if (numLevels < 1 || numLevels > EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS
+        || *std::min_element(levelAnchors.begin(), levelAnchors.end()) < 1 || batchSize < 1 || numClasses < 1
+        || levelDelay < 0 || numIterations < 1 || numThreads < 1)
+    {
+        std::fprintf(stderr, "all options must be positive, with at most %d levels\n",
+            EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS);
+        return 1;
+    }
+    int32_t numAnchors = 0;
+    for (int32_t anchors : levelAnchors)
+    {
+        numAnchors += anchors;
+    }
+
+    EfficientPoseNMSParameters param;
+    param.scoreThreshold = 0.25F;
+    param.iouThreshold = 0.5F;
+    param.numOutputBoxes = 100;
+    param.numSelectedBoxes = 5000;
+    param.batchSize = batchSize;
+    param.numClasses = numClasses;
+    param.numAnchors = numAnchors;
+    param.numScoreElements = numAnchors * numClasses;
+    param.numBoxElements = numAnchors * 4;
+
+    // Inputs: boxes as corners, and scores with most of them below the score threshold, like the output of a real
+    // detector.
+    uint32_t state = 1;
+    std::vector<Level> levels(numLevels);
+    for (int32_t l = 0; l < numLevels; l++)
+    {
+        Level& level = levels[l];
+        level.numAnchors = levelAnchors[l];
+        level.boxes.resize(static_cast<size_t>(batchSize) * level.numAnchors * 4);
+        level.scores.resize(static_cast<size_t>(batchSize) * level.numAnchors * numClasses);
+        for (size_t i = 0; i < level.boxes.size(); i += 4)
+        {
+            float y = (nextRandom(state) % 1000) / 1000.F;
+            float x = (nextRandom(state) % 1000) / 1000.F;
+            level.boxes[i + 0] = y;
+            level.boxes[i + 1] = x;
+            level.boxes[i + 2] = y + 0.02F + (nextRandom(state) % 200) / 1000.F;
+            level.boxes[i + 3] = x + 0.02F + (nextRandom(state) % 200) / 1000.F;
+        }
+        for (auto& score : level.scores)
+        {
+            score = (nextRandom(state) % 10000) / 10000.F;
+            score = score * score * score;
+        }
+    }
+
+    EfficientPoseNMSHostExecutor executor(numThreads - 1);
+    std::vector<char> workspace(
+        EfficientPoseNMSHostWorkspaceSize(batchSize, param.numScoreElements, numClasses, DataType::kFLOAT));
+    std::vector<char> streamWorkspace(
+        EfficientPoseNMSHostStreamWorkspaceSize(batchSize, param.numScoreElements, numClasses, DataType::kFLOAT));
+    std::vector<float> boxes(static_cast<size_t>(batchSize) * numAnchors * 4);
+    std::vector<float> scores(static_cast<size_t>(batchSize) * param.numScoreElements);
+    Outputs concatOutputs(batchSize, param.numOutputBoxes);
+    Outputs streamOutputs(batchSize, param.numOutputBoxes);
+    auto const delay = std::chrono::microseconds(levelDelay);
+
+    std::printf("levels");
+    for (int32_t anchors : levelAnchors)
+    {
+        std::printf(" %d", anchors);
+    }
+    std::printf(", batch %d, classes %d, level delay %d us, %d threads\n", batchSize, numClasses, levelDelay,
+        numThreads);
+
+    double concatLatency = 0.;
+    double streamLatency = 0.;
+    int32_t mismatches = 0;
+    for (int32_t iteration = 0; iteration < numIterations; iteration++)
+    {
+        // Concatenated: copy each level into the [B, A, ...] inputs as it is produced, then run once.
+        auto start = std::chrono::steady_clock::now();
+        int32_t firstAnchor = 0;
+        for (int32_t l = 0; l < numLevels; l++)
+        {
+            waitForLevel(start, delay, l);
+            Level const& level = levels[l];
+            for (int32_t imageIdx = 0; imageIdx < batchSize; imageIdx++)
+            {
+                std::copy_n(level.boxes.data() + static_cast<size_t>(imageIdx) * level.numAnchors * 4,
+                    level.numAnchors * 4,
+                    boxes.data() + (static_cast<size_t>(imageIdx) * numAnchors + firstAnchor) * 4);
+                std::copy_n(level.scores.data() + static_cast<size_t>(imageIdx) * level.numAnchors * numClasses,
+                    level.numAnchors * numClasses,
+                    scores.data() + (static_cast<size_t>(imageIdx) * numAnchors + firstAnchor) * numClasses);
+            }
+            firstAnchor += level.numAnchors;
+        }
+        EfficientPoseNMSHostInference(param, boxes.data(), scores.data(), nullptr, nullptr,
+            concatOutputs.numDetections.data(), concatOutputs.boxes.data(), concatOutputs.keypoints.data(),
+            concatOutputs.scores.data(), concatOutputs.classes.data(), nullptr, nullptr, workspace.data(), &executor);
+        auto end = std::chrono::steady_clock::now();
+        concatLatency += std::chrono::duration<double>(end - (start + delay * numLevels)).count();
+
+        // Streamed: filter each level as it is produced, and only run the NMS once the last one is in.
+        start = std::chrono::steady_clock::now();
+        EfficientPoseNMSHostStreamBegin(param, streamWorkspace.data());
+        firstAnchor = 0;
+        for (int32_t l = 0; l < numLevels; l++)
+        {
+            waitForLevel(start, delay, l);
+            Level const& level = levels[l];
+            EfficientPoseNMSHostStreamChunk(param, firstAnchor, level.numAnchors, level.boxes.data(),
+                level.scores.data(), nullptr, streamWorkspace.data(), &executor);
+            firstAnchor += level.numAnchors;
+        }
+        pluginStatus_t status = EfficientPoseNMSHostStreamFinish(param, nullptr, streamOutputs.numDetections.data(),
+            streamOutputs.boxes.data(), streamOutputs.keypoints.data(), streamOutputs.scores.data(),
+            streamOutputs.classes.data(), nullptr, nullptr, streamWorkspace.data(), &executor);
+        end = std::chrono::steady_clock::now();
+        streamLatency += std::chrono::duration<double>(end - (start + delay * numLevels)).count();
+
+        if (status != STATUS_SUCCESS || !(streamOutputs == concatOutputs))
+        {
+            mismatches++;
+        }
+    }
+
+    // The latency is taken from the production of the last level, so without a level delay, it is the whole time of a
+    // call, inputs included.
+    std::printf("%-10s %14s\n", "mode", "latency (us)");
+    std::printf("%-10s %14.1f\n", "concat", concatLatency * 1e6 / numIterations);
+    std::printf("%-10s %14.1f\n", "stream", streamLatency * 1e6 / numIterations);
+    std::printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
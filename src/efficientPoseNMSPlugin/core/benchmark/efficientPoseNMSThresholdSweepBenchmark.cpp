@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures a calibration sweep over a grid of (score, IOU) threshold pairs, run either as one host inference call per
+// pair, or as a single threshold sweep. The results of the sweep are checked against those of the single calls.
+//
+// Usage: efficientposenms_threshold_sweep_benchmark [--anchors=A] [--batch=B] [--classes=C] [--score-steps=S]
+//                                                   [--iou-steps=I] [--iterations=N] [--threads=T]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSHostThresholds;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+// Small deterministic generator, so that every run processes the same inputs.
+uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+// The results of every threshold pair, one standard result set after the other.
+struct Outputs
+{
+    std::vector<int32_t> numDetections;
+    std::vector<float> boxes;
+    std::vector<float> scores;
+    std::vector<int32_t> classes;
+
+    Outputs(int32_t numThresholds, int32_t batchSize, int32_t numOutputBoxes)
+        : numDetections(static_cast<size_t>(numThresholds) * batchSize)
+        , boxes(static_cast<size_t>(numThresholds) * batchSize * numOutputBoxes * 4)
+        , scores(static_cast<size_t>(numThresholds) * batchSize * numOutputBoxes)
+        , classes(static_cast<size_t>(numThresholds) * batchSize * numOutputBoxes)
+    {
+    }
+
+    bool operator==(Outputs const& other) const
+    {
+        return numDetections == other.numDetections && boxes == other.boxes && scores == other.scores
+            && classes == other.classes;
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int32_t numAnchors = 8400;
+    int32_t batchSize = 1;
+    int32_t numClasses = 1;
+    int32_t numScoreSteps = 4;
+    int32_t numIouSteps = 8;
+    int32_t numIterations = 20;
+    int32_t numThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--anchors=", 10))
+        {
+            numAnchors = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--batch=", 8))
+        {
+            batchSize = std::atoi(argv[i] + 8);
+        }
+        else if (!std::strncmp(argv[i], "--classes=", 10))
+        {
+            numClasses = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--score-steps=", 14))
+        {
+            numScoreSteps = std::atoi(argv[i] + 14);
+        }
+        else if (!std::strncmp(argv[i], "--iou-steps=", 12))
+        {
+            numIouSteps = std::atoi(argv[i] + 12);
+        }
+        else if (!std::strncmp(argv[i], "--iterations=", 13))
+        {
+            numIterations = std::atoi(argv[i] + 13);
+        }
+        else if (!std::strncmp(argv[i], "--threads=", 10))
+        {
+            numThreads = std::atoi(argv[i] + 10);
+        }
+        else
+        {
+            std::fprintf(stderr,
+                "Usage: %s [--anchors=A] [--batch=B] [--classes=C] [--score-steps=S] [--iou-steps=I] "
+                "[--iterations=N] [--threads=T]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+    if (numAnchors < 1 || batchSize < 1 || numClasses < 1 || numScoreSteps < 1 || numIouSteps < 1
+        || numScoreSteps * numIouSteps > EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS || numIterations < 1
+        || numThreads < 1)
+    {
+        std::fprintf(stderr, "all options must be positive, with at most %d threshold pairs\n",
+            EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS);
+        return 1;
+    }
+
+    EfficientPoseNMSParameters param;
+    param.numOutputBoxes = 100;
+    param.numSelectedBoxes = 5000;
+    param.batchSize = batchSize;
+    param.numClasses = numClasses;
+    param.numAnchors = numAnchors;
+    param.numScoreElements = numAnchors * numClasses;
+    param.numBoxElements = numAnchors * 4;
+
+    // The grid of thresholds: score thresholds from 0.05 to 0.5, and IOU thresholds from 0.3 to 0.8.
+    int32_t const numThresholds = numScoreSteps * numIouSteps;
+    std::vector<EfficientPoseNMSHostThresholds> thresholds(numThresholds);
+    for (int32_t s = 0; s < numScoreSteps; s++)
+    {
+        for (int32_t t = 0; t < numIouSteps; t++)
+        {
+            EfficientPoseNMSHostThresholds& pair = thresholds[s * numIouSteps + t];
+            pair.scoreThreshold = 0.05F + (numScoreSteps > 1 ? 0.45F * s / (numScoreSteps - 1) : 0.F);
+            pair.iouThreshold = 0.3F + (numIouSteps > 1 ? 0.5F * t / (numIouSteps - 1) : 0.F);
+        }
+    }
+
+    // Inputs: boxes as corners, and scores with most of them below the score thresholds, like the output of a real
+    // detector.
+    uint32_t state = 1;
+    std::vector<float> boxes(static_cast<size_t>(batchSize) * numAnchors * 4);
+    std::vector<float> scores(static_cast<size_t>(batchSize) * param.numScoreElements);
+    for (size_t i = 0; i < boxes.size(); i += 4)
+    {
+        float y = (nextRandom(state) % 1000) / 1000.F;
+        float x = (nextRandom(state) % 1000) / 1000.F;
+        boxes[i + 0] = y;
+        boxes[i + 1] = x;
+        boxes[i + 2] = y + 0.02F + (nextRandom(state) % 200) / 1000.F;
+        boxes[i + 3] = x + 0.02F + (nextRandom(state) % 200) / 1000.F;
+    }
+    for (auto& score : scores)
+    {
+        score = (nextRandom(state) % 10000) / 10000.F;
+        score = score * score * score;
+    }
+
+    EfficientPoseNMSHostExecutor executor(numThreads - 1);
+    std::vector<char> workspace(
+        EfficientPoseNMSHostWorkspaceSize(batchSize, param.numScoreElements, numClasses, DataType::kFLOAT));
+    std::vector<char> sweepWorkspace(EfficientPoseNMSHostThresholdSweepWorkspaceSize(
+        batchSize, param.numScoreElements, numClasses, DataType::kFLOAT, numThresholds));
+    std::vector<float> keypoints(static_cast<size_t>(batchSize) * param.numOutputBoxes * 3);
+    Outputs pairOutputs(numThresholds, batchSize, param.numOutputBoxes);
+    Outputs sweepOutputs(numThresholds, batchSize, param.numOutputBoxes);
+
+    std::printf("anchors %d, batch %d, classes %d, %d x %d threshold pairs, %d threads\n", numAnchors, batchSize,
+        numClasses, numScoreSteps, numIouSteps, numThreads);
+
+    double pairTime = 0.;
+    double sweepTime = 0.;
+    int32_t mismatches = 0;
+    for (int32_t iteration = 0; iteration < numIterations; iteration++)
+    {
+        // One call per pair, each of which filters, sorts and decodes the candidates again.
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t p = 0; p < numThresholds; p++)
+        {
+            EfficientPoseNMSParameters pairParam = param;
+            pairParam.scoreThreshold = thresholds[p].scoreThreshold;
+            pairParam.iouThreshold = thresholds[p].iouThreshold;
+            size_t const detectionsOffset = static_cast<size_t>(p) * batchSize;
+            size_t const boxesOffset = detectionsOffset * param.numOutputBoxes;
+            EfficientPoseNMSHostInference(pairParam, boxes.data(), scores.data(), nullptr, nullptr,
+                pairOutputs.numDetections.data() + detectionsOffset, pairOutputs.boxes.data() + boxesOffset * 4,
+                keypoints.data(), pairOutputs.scores.data() + boxesOffset, pairOutputs.classes.data() + boxesOffset,
+                nullptr, nullptr, workspace.data(), &executor);
+        }
+        auto end = std::chrono::steady_clock::now();
+        pairTime += std::chrono::duration<double>(end - start).count();
+
+        // A single sweep for all the pairs.
+        start = std::chrono::steady_clock::now();
+        pluginStatus_t status = EfficientPoseNMSHostThresholdSweep(param, boxes.data(), scores.data(), nullptr,
+            nullptr, thresholds.data(), numThresholds, sweepOutputs.numDetections.data(), sweepOutputs.boxes.data(),
+            sweepOutputs.scores.data(), sweepOutputs.classes.data(), sweepWorkspace.data(), &executor);
+        end = std::chrono::steady_clock::now();
+        sweepTime += std::chrono::duration<double>(end - start).count();
+
+        if (status != STATUS_SUCCESS || !(sweepOutputs == pairOutputs))
+        {
+            mismatches++;
+        }
+    }
+
+    std::printf("%-10s %14s\n", "mode", "time (us)");
+    std::printf("%-10s %14.1f\n", "per pair", pairTime * 1e6 / numIterations);
+    std::printf("%-10s %14.1f\n", "sweep", sweepTime * 1e6 / numIterations);
+    std::printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,345 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HARNESS_PLUGIN_H
+#define TRT_EFFICIENT_POSE_NMS_HARNESS_PLUGIN_H
+
+// Host only stand-in for the TensorRT common/plugin.h, used by the plugin lifecycle harness to build
+// efficientPoseNMSPlugin.cpp without TensorRT or CUDA. Only the parts of the TensorRT plugin interfaces used by the
+// plugin are declared, with the same names, signatures and semantics. The harness is built with
+// EFFICIENT_POSE_NMS_STANDALONE, so DataType and pluginStatus_t come from efficientPoseNMSParameters.h.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "efficientPoseNMSParameters.h"
+
+// CUDA Runtime
+typedef struct CUstream_st* cudaStream_t;
+
+enum cudaError_t
+{
+    cudaSuccess = 0,
+    cudaErrorInvalidValue = 1
+};
+
+struct cudaDeviceProp
+{
+    int regsPerBlock;
+};
+
+// There is no device, so report the properties of a regular (non Jetson) one.
+inline cudaError_t cudaGetDevice(int* device)
+{
+    *device = 0;
+    return cudaSuccess;
+}
+
+inline cudaError_t cudaGetDeviceProperties(cudaDeviceProp* properties, int /* device */)
+{
+    properties->regsPerBlock = 65536;
+    return cudaSuccess;
+}
+
+#define CSC(call, err)                                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        cudaError_t cudaStatus = call;                                                                                 \
+        if (cudaStatus != cudaSuccess)                                                                                 \
+        {                                                                                                              \
+            return err;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+namespace nvinfer1
+{
+
+// Dimensions and Tensor Descriptors
+class Dims
+{
+public:
+    static constexpr int32_t MAX_DIMS{8};
+    int32_t nbDims;
+    int32_t d[MAX_DIMS];
+};
+
+enum class TensorFormat : int32_t
+{
+    kLINEAR = 0
+};
+using PluginFormat = TensorFormat;
+
+struct PluginTensorDesc
+{
+    Dims dims;
+    DataType type;
+    TensorFormat format;
+    float scale;
+};
+
+struct DynamicPluginTensorDesc
+{
+    PluginTensorDesc desc;
+    Dims min;
+    Dims max;
+    Dims opt;
+};
+
+// Shape Expressions
+enum class DimensionOperation : int32_t
+{
+    kSUM = 0,
+    kPROD = 1,
+    kMAX = 2,
+    kMIN = 3,
+    kSUB = 4,
+    kEQUAL = 5,
+    kLESS = 6,
+    kFLOOR_DIV = 7,
+    kCEIL_DIV = 8
+};
+
+class IDimensionExpr
+{
+public:
+    virtual bool isConstant() const noexcept = 0;
+    virtual int32_t getConstantValue() const noexcept = 0;
+
+protected:
+    virtual ~IDimensionExpr() noexcept = default;
+};
+
+class DimsExprs
+{
+public:
+    int32_t nbDims;
+    IDimensionExpr const* d[Dims::MAX_DIMS];
+};
+
+class IExprBuilder
+{
+public:
+    virtual IDimensionExpr const* constant(int32_t value) noexcept = 0;
+    virtual IDimensionExpr const* operation(
+        DimensionOperation op, IDimensionExpr const& first, IDimensionExpr const& second) noexcept = 0;
+
+protected:
+    virtual ~IExprBuilder() noexcept = default;
+};
+
+// Plugin Fields
+enum class PluginFieldType : int32_t
+{
+    kFLOAT16 = 0,
+    kFLOAT32 = 1,
+    kFLOAT64 = 2,
+    kINT8 = 3,
+    kINT16 = 4,
+    kINT32 = 5,
+    kCHAR = 6,
+    kDIMS = 7,
+    kUNKNOWN = 8
+};
+
+class PluginField
+{
+public:
+    char const* name;
+    void const* data;
+    PluginFieldType type;
+    int32_t length;
+
+    PluginField(char const* const name_ = nullptr, void const* const data_ = nullptr,
+        PluginFieldType const type_ = PluginFieldType::kUNKNOWN, int32_t const length_ = 0) noexcept
+        : name(name_)
+        , data(data_)
+        , type(type_)
+        , length(length_)
+    {
+    }
+};
+
+struct PluginFieldCollection
+{
+    int32_t nbFields;
+    PluginField const* fields;
+};
+
+// Plugin Interfaces
+class IPluginV2
+{
+public:
+    virtual char const* getPluginType() const noexcept = 0;
+    virtual char const* getPluginVersion() const noexcept = 0;
+    virtual int32_t getNbOutputs() const noexcept = 0;
+    virtual int32_t initialize() noexcept = 0;
+    virtual void terminate() noexcept = 0;
+    virtual size_t getSerializationSize() const noexcept = 0;
+    virtual void serialize(void* buffer) const noexcept = 0;
+    virtual void destroy() noexcept = 0;
+    virtual void setPluginNamespace(char const* pluginNamespace) noexcept = 0;
+    virtual char const* getPluginNamespace() const noexcept = 0;
+
+protected:
+    virtual ~IPluginV2() noexcept = default;
+};
+
+class IPluginV2Ext : public IPluginV2
+{
+public:
+    virtual DataType getOutputDataType(
+        int32_t index, DataType const* inputTypes, int32_t nbInputs) const noexcept = 0;
+};
+
+class IPluginV2DynamicExt : public IPluginV2Ext
+{
+public:
+    virtual IPluginV2DynamicExt* clone() const noexcept = 0;
+    virtual DimsExprs getOutputDimensions(
+        int32_t outputIndex, DimsExprs const* inputs, int32_t nbInputs, IExprBuilder& exprBuilder) noexcept = 0;
+    virtual bool supportsFormatCombination(
+        int32_t pos, PluginTensorDesc const* inOut, int32_t nbInputs, int32_t nbOutputs) noexcept = 0;
+    virtual void configurePlugin(DynamicPluginTensorDesc const* in, int32_t nbInputs,
+        DynamicPluginTensorDesc const* out, int32_t nbOutputs) noexcept = 0;
+    virtual size_t getWorkspaceSize(PluginTensorDesc const* inputs, int32_t nbInputs, PluginTensorDesc const* outputs,
+        int32_t nbOutputs) const noexcept = 0;
+    virtual int32_t enqueue(PluginTensorDesc const* inputDesc, PluginTensorDesc const* outputDesc,
+        void const* const* inputs, void* const* outputs, void* workspace, cudaStream_t stream) noexcept = 0;
+};
+
+class IPluginCreator
+{
+public:
+    virtual char const* getPluginName() const noexcept = 0;
+    virtual char const* getPluginVersion() const noexcept = 0;
+    virtual PluginFieldCollection const* getFieldNames() noexcept = 0;
+    virtual IPluginV2* createPlugin(char const* name, PluginFieldCollection const* fc) noexcept = 0;
+    virtual IPluginV2* deserializePlugin(char const* name, void const* serialData, size_t serialLength) noexcept = 0;
+    virtual void setPluginNamespace(char const* pluginNamespace) noexcept = 0;
+    virtual char const* getPluginNamespace() const noexcept = 0;
+
+    virtual ~IPluginCreator() noexcept = default;
+};
+
+namespace pluginInternal
+{
+class BaseCreator : public IPluginCreator
+{
+public:
+    void setPluginNamespace(char const* libNamespace) noexcept override
+    {
+        mNamespace = libNamespace;
+    }
+
+    char const* getPluginNamespace() const noexcept override
+    {
+        return mNamespace.c_str();
+    }
+
+protected:
+    std::string mNamespace;
+};
+} // namespace pluginInternal
+
+namespace plugin
+{
+
+// Logging and Error Handling
+#define gLogWarning std::cerr << "[W] "
+
+class PluginError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline void caughtError(std::exception const& e)
+{
+    std::cerr << "[E] " << e.what() << std::endl;
+}
+
+[[noreturn]] inline void throwPluginError(char const* file, int32_t line, char const* msg)
+{
+    throw PluginError(std::string(file) + ":" + std::to_string(line) + ": " + msg);
+}
+
+[[noreturn]] inline void reportAssertion(char const* msg, char const* file, int32_t line)
+{
+    std::fprintf(stderr, "%s:%d: Assertion failed: %s\n", file, line, msg);
+    std::abort();
+}
+
+#define PLUGIN_VALIDATE(condition)                                                                                     \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            nvinfer1::plugin::throwPluginError(__FILE__, __LINE__, #condition);                                        \
+        }                                                                                                              \
+    } while (0)
+
+#define PLUGIN_ASSERT(assertion)                                                                                       \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(assertion))                                                                                              \
+        {                                                                                                              \
+            nvinfer1::plugin::reportAssertion(#assertion, __FILE__, __LINE__);                                         \
+        }                                                                                                              \
+    } while (0)
+
+inline void validateRequiredAttributesExist(
+    std::initializer_list<char const*> requiredFieldNames, PluginFieldCollection const* fc)
+{
+    for (char const* name : requiredFieldNames)
+    {
+        bool found = false;
+        for (int32_t i = 0; i < fc->nbFields && !found; i++)
+        {
+            found = !std::strcmp(fc->fields[i].name, name);
+        }
+        PLUGIN_VALIDATE(found);
+    }
+}
+
+// Serialization
+template <typename T>
+void write(char*& buffer, T const& val)
+{
+    std::memcpy(buffer, &val, sizeof(T));
+    buffer += sizeof(T);
+}
+
+template <typename OutType, typename BufferType>
+OutType read(BufferType const*& buffer)
+{
+    static_assert(sizeof(BufferType) == 1, "BufferType must be a 1 byte type.");
+    OutType val{};
+    std::memcpy(&val, static_cast<void const*>(buffer), sizeof(OutType));
+    buffer += sizeof(OutType);
+    return val;
+}
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
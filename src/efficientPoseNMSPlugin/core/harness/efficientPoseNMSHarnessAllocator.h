@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HARNESS_ALLOCATOR_H
+#define TRT_EFFICIENT_POSE_NMS_HARNESS_ALLOCATOR_H
+
+#include <cstddef>
+
+// The harness replaces the global operator new and operator delete, so that it can count every heap allocation made
+// by the plugin. They are defined in their own translation unit, where they cannot be inlined into their callers.
+
+// Number of heap allocations made by the process so far.
+size_t EfficientPoseNMSHarnessAllocations();
+
+#endif
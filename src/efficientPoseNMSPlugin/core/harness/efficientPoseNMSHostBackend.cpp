@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSInference.h"
+
+// Binds the device entry points used by EfficientPoseNMSPlugin to the host implementation, so that the harness can
+// run the unmodified plugin without CUDA. The stream is ignored, and every call completes before returning.
+
+size_t EfficientPoseNMSWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    nvinfer1::DataType datatype, int32_t numKeypoints)
+{
+    return EfficientPoseNMSHostWorkspaceSize(batchSize, numScoreElements, numClasses, datatype, numKeypoints);
+}
+
+pluginStatus_t EfficientPoseNMSInference(nvinfer1::plugin::EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, cudaStream_t /* stream */)
+{
+    return EfficientPoseNMSHostInference(param, boxesInput, scoresInput, anchorsInput, keypointsInput,
+        numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput,
+        nmsOffsetsOutput, workspace);
+}
+
+pluginStatus_t EfficientPoseNMSSparseInference(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* boxesInput, void const* candidateScoresInput, void const* candidateIndicesInput,
+    void const* candidateCountsInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, cudaStream_t /* stream */)
+{
+    return EfficientPoseNMSHostSparseInference(param, boxesInput, candidateScoresInput, candidateIndicesInput,
+        candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+        nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace);
+}
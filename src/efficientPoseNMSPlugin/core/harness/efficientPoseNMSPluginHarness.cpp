@@ -0,0 +1,807 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Drives the full EfficientPoseNMSPlugin lifecycle on the host, the same way TensorRT would for an engine with
+// dynamic shapes that change on every call, and reports the time and the heap allocations of every plugin method, for
+// each of a set of plugin configurations that covers the inputs and the output layouts: dense and sparse scores, OKS
+// suppression, tiled inference and candidate budgets, with the padded, compact, packed, class major and ONNX outputs.
+// The outputs of every call are laid out from the dimensions and types the plugin declares for them, each followed by
+// guard words that enqueue() must not touch, and the detections are checked against the declared layout.
+// With --threads, it then stresses a single configured plugin instance with concurrent enqueue() calls of different
+// batch sizes from up to that many threads, each with its own workspace and outputs. Every result is checked against
+// a single threaded reference, and the throughput is reported for each thread count.
+//
+// Usage: efficientposenms_plugin_harness [--iterations=N] [--classes=C] [--threads=T]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "efficientPoseNMSHarnessAllocator.h"
+#include "efficientPoseNMSPlugin.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSONNXPluginCreator;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+using nvinfer1::plugin::EfficientPoseNMSPlugin;
+using nvinfer1::plugin::EfficientPoseNMSPluginCreator;
+
+namespace
+{
+
+class HarnessDimensionExpr : public IDimensionExpr
+{
+public:
+    bool isConstant() const noexcept override
+    {
+        return true;
+    }
+
+    int32_t getConstantValue() const noexcept override
+    {
+        return mValue;
+    }
+
+    int32_t mValue{0};
+};
+
+// All shapes are known when the harness calls getOutputDimensions(), so every expression folds to a constant. The
+// expressions come from a fixed pool, so that the builder itself does not allocate.
+class HarnessExprBuilder : public IExprBuilder
+{
+public:
+    IDimensionExpr const* constant(int32_t value) noexcept override
+    {
+        HarnessDimensionExpr* expr = &mPool[mUsed++ % kPoolSize];
+        expr->mValue = value;
+        return expr;
+    }
+
+    IDimensionExpr const* operation(
+        DimensionOperation op, IDimensionExpr const& first, IDimensionExpr const& second) noexcept override
+    {
+        int32_t a = first.getConstantValue();
+        int32_t b = second.getConstantValue();
+        switch (op)
+        {
+        case DimensionOperation::kSUM: return constant(a + b);
+        case DimensionOperation::kPROD: return constant(a * b);
+        case DimensionOperation::kMAX: return constant(std::max(a, b));
+        case DimensionOperation::kMIN: return constant(std::min(a, b));
+        case DimensionOperation::kSUB: return constant(a - b);
+        case DimensionOperation::kEQUAL: return constant(a == b);
+        case DimensionOperation::kLESS: return constant(a < b);
+        case DimensionOperation::kFLOOR_DIV: return constant(a / b);
+        case DimensionOperation::kCEIL_DIV: return constant((a + b - 1) / b);
+        }
+        return constant(0);
+    }
+
+private:
+    static constexpr int32_t kPoolSize{256};
+    HarnessDimensionExpr mPool[kPoolSize];
+    int32_t mUsed{0};
+};
+
+struct MethodStats
+{
+    char const* name;
+    int64_t calls{0};
+    int64_t nanoseconds{0};
+    size_t allocations{0};
+};
+
+template <typename F>
+void measure(MethodStats& stats, F&& method)
+{
+    size_t allocations = EfficientPoseNMSHarnessAllocations();
+    auto start = std::chrono::steady_clock::now();
+    method();
+    auto end = std::chrono::steady_clock::now();
+    stats.calls++;
+    stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    stats.allocations += EfficientPoseNMSHarnessAllocations() - allocations;
+}
+
+Dims makeDims(std::initializer_list<int32_t> values)
+{
+    Dims dims{};
+    for (int32_t value : values)
+    {
+        dims.d[dims.nbDims++] = value;
+    }
+    return dims;
+}
+
+PluginTensorDesc makeDesc(Dims dims, DataType type)
+{
+    PluginTensorDesc desc{};
+    desc.dims = dims;
+    desc.type = type;
+    desc.format = TensorFormat::kLINEAR;
+    desc.scale = 1.F;
+    return desc;
+}
+
+// Small deterministic generator, so that every run processes the same inputs.
+uint32_t nextRandom(uint32_t& state)
+{
+    state = state * 1664525U + 1013904223U;
+    return state >> 8;
+}
+
+// Shapes cycled through on every call, so that no two consecutive calls see the same input dimensions.
+int32_t const kBatchSizes[] = {1, 4, 2, 8, 3};
+int32_t const kAnchorCounts[] = {8400, 2100, 4200, 1024};
+int32_t const kMaxBatchSize = 8;
+int32_t const kMaxAnchors = 8400;
+
+// Tiles per image with tiled inference, side by side along x.
+int32_t const kMaxTiles = 2;
+// Capacity of the candidate lists with sparse input, which does not depend on the number of anchors. Every listed
+// anchor is below the smallest anchor count.
+int32_t const kMaxCandidates = 1024;
+// Slots of each class in the class major layout.
+int32_t const kBoxesPerClass = 20;
+
+// The COCO keypoint sigmas, used with OKS suppression.
+float const kKeypointSigmas[] = {0.026F, 0.025F, 0.025F, 0.035F, 0.035F, 0.079F, 0.079F, 0.072F, 0.072F, 0.062F,
+    0.062F, 0.107F, 0.107F, 0.087F, 0.087F, 0.089F, 0.089F};
+int32_t const kNumKeypoints = sizeof(kKeypointSigmas) / sizeof(float);
+
+// One plugin configuration: the attributes set on top of the common ones, which select the inputs and the output
+// layout. The creator has no class major attribute, so that layout is built from the plugin parameters instead, and
+// the ONNX layout comes from its own creator.
+struct HarnessConfig
+{
+    char const* name;
+    int32_t compactOutput;
+    int32_t packedOutput;
+    int32_t sparseInput;
+    int32_t tilesPerImage;
+    int32_t numKeypoints;
+    int32_t maxSweptCandidates;
+    bool classMajorOutput;
+    bool onnx;
+};
+
+HarnessConfig const kConfigs[] = {
+    {"padded", 0, 0, 0, 1, 0, -1, false, false},
+    {"padded compact", 1, 0, 0, 1, 0, -1, false, false},
+    {"packed", 0, 1, 0, 1, 0, -1, false, false},
+    {"packed compact", 1, 1, 0, 1, 0, -1, false, false},
+    {"sparse", 0, 0, 1, 1, 0, -1, false, false},
+    {"sparse compact", 1, 0, 1, 1, 0, -1, false, false},
+    {"sparse oks", 0, 0, 1, 1, kNumKeypoints, -1, false, false},
+    {"oks", 0, 0, 0, 1, kNumKeypoints, -1, false, false},
+    {"oks packed compact", 1, 1, 0, 1, kNumKeypoints, -1, false, false},
+    {"tiled", 0, 0, 0, kMaxTiles, 0, -1, false, false},
+    {"tiled oks compact", 1, 0, 0, kMaxTiles, kNumKeypoints, -1, false, false},
+    {"budget", 0, 0, 0, 1, 0, 64, false, false},
+    {"class major", 0, 0, 0, 1, 0, -1, true, false},
+    {"onnx", 0, 0, 0, 1, 0, -1, false, true},
+};
+
+struct HarnessOptions
+{
+    int32_t numIterations;
+    int32_t numClasses;
+    int32_t maxThreads;
+};
+
+// The inputs, sized for the largest shape.
+struct HarnessInputs
+{
+    std::vector<float> boxes;
+    std::vector<float> scores;
+    std::vector<float> keypoints;
+    std::vector<float> candidateScores;
+    std::vector<int32_t> candidateIndices;
+    std::vector<int32_t> candidateCounts;
+};
+
+// Words written after each output, which enqueue() must leave as they are.
+int32_t const kGuardWords = 4;
+int32_t const kGuardValue = 0x7EADBEEF;
+
+// The inputs of one call of the configuration, and their descriptions, in the order the plugin takes them: the boxes,
+// the scores, the candidate indices and counts with sparse input, and the keypoints with OKS suppression. With tiled
+// inference, the batch holds the tiles of every image.
+int32_t makeInputs(HarnessConfig const& config, HarnessInputs const& data, int32_t numClasses, int32_t batchSize,
+    int32_t numAnchors, PluginTensorDesc* descs, void const** inputs)
+{
+    int32_t const numTiles = batchSize * config.tilesPerImage;
+    int32_t nbInputs = 0;
+    descs[nbInputs] = makeDesc(makeDims({numTiles, numAnchors, 4}), DataType::kFLOAT);
+    inputs[nbInputs++] = data.boxes.data();
+    if (config.sparseInput)
+    {
+        descs[nbInputs] = makeDesc(makeDims({batchSize, kMaxCandidates}), DataType::kFLOAT);
+        inputs[nbInputs++] = data.candidateScores.data();
+        descs[nbInputs] = makeDesc(makeDims({batchSize, kMaxCandidates, 2}), DataType::kINT32);
+        inputs[nbInputs++] = data.candidateIndices.data();
+        descs[nbInputs] = makeDesc(makeDims({batchSize}), DataType::kINT32);
+        inputs[nbInputs++] = data.candidateCounts.data();
+    }
+    else
+    {
+        descs[nbInputs] = makeDesc(makeDims({numTiles, numAnchors, numClasses}), DataType::kFLOAT);
+        inputs[nbInputs++] = data.scores.data();
+    }
+    if (config.numKeypoints > 0)
+    {
+        descs[nbInputs] = makeDesc(makeDims({numTiles, numAnchors, 3 * config.numKeypoints}), DataType::kFLOAT);
+        inputs[nbInputs++] = data.keypoints.data();
+    }
+    return nbInputs;
+}
+
+// The output descriptions, from the dimensions and types the plugin declares for the given inputs.
+void declareOutputs(IPluginV2DynamicExt* plugin, PluginTensorDesc const* inputDescs, int32_t nbInputs,
+    HarnessExprBuilder& exprBuilder, PluginTensorDesc* outputDescs)
+{
+    DimsExprs inputDimsExprs[8]{};
+    DataType inputTypes[8];
+    for (int32_t i = 0; i < nbInputs; i++)
+    {
+        inputDimsExprs[i].nbDims = inputDescs[i].dims.nbDims;
+        for (int32_t d = 0; d < inputDescs[i].dims.nbDims; d++)
+        {
+            inputDimsExprs[i].d[d] = exprBuilder.constant(inputDescs[i].dims.d[d]);
+        }
+        inputTypes[i] = inputDescs[i].type;
+    }
+    for (int32_t outputIndex = 0; outputIndex < plugin->getNbOutputs(); outputIndex++)
+    {
+        DimsExprs const dimsExprs = plugin->getOutputDimensions(outputIndex, inputDimsExprs, nbInputs, exprBuilder);
+        Dims dims{};
+        dims.nbDims = dimsExprs.nbDims;
+        for (int32_t d = 0; d < dimsExprs.nbDims; d++)
+        {
+            dims.d[d] = dimsExprs.d[d]->getConstantValue();
+        }
+        outputDescs[outputIndex] = makeDesc(dims, plugin->getOutputDataType(outputIndex, inputTypes, nbInputs));
+    }
+}
+
+// The outputs of one call, back to back in int32 words, each followed by its guard words.
+struct HarnessOutputs
+{
+    std::vector<int32_t> words;
+    std::vector<size_t> offsets;
+
+    void layout(PluginTensorDesc const* descs, int32_t nbOutputs)
+    {
+        offsets.clear();
+        size_t size = 0;
+        for (int32_t i = 0; i < nbOutputs; i++)
+        {
+            size_t numBytes = descs[i].type == DataType::kHALF ? 2 : 4;
+            for (int32_t d = 0; d < descs[i].dims.nbDims; d++)
+            {
+                numBytes *= descs[i].dims.d[d];
+            }
+            offsets.push_back(size);
+            size += (numBytes + 15) / 16 * 4 + kGuardWords;
+        }
+        offsets.push_back(size);
+        words.resize(size);
+    }
+
+    void poison(int32_t value)
+    {
+        std::fill(words.begin(), words.end(), value);
+        for (size_t i = 1; i < offsets.size(); i++)
+        {
+            std::fill(&words[offsets[i] - kGuardWords], &words[offsets[i]], kGuardValue);
+        }
+    }
+
+    bool guarded() const
+    {
+        for (size_t i = 1; i < offsets.size(); i++)
+        {
+            if (std::any_of(&words[offsets[i] - kGuardWords], &words[offsets[i]],
+                    [](int32_t word) { return word != kGuardValue; }))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void pointers(void** outputs)
+    {
+        for (size_t i = 0; i + 1 < offsets.size(); i++)
+        {
+            outputs[i] = words.data() + offsets[i];
+        }
+    }
+};
+
+// The detections of one call, counted from the outputs as the plugin declares them, or -1 if they do not match that
+// layout. The num_detections output holds one count per image, or one per class of each image in the class major
+// layout, each within the slots of the boxes output, and with compact output, the offsets, which are the last output,
+// must add those up. The ONNX indices hold the valid (image, class, anchor) rows first, then copies of the last one.
+int64_t countDetections(HarnessConfig const& config, PluginTensorDesc const* outputDescs, void* const* outputs,
+    int32_t nbOutputs, int32_t batchSize, int32_t numClasses, int32_t numAnchors)
+{
+    int64_t numDetections = 0;
+    if (config.onnx)
+    {
+        int32_t const* indices = static_cast<int32_t const*>(outputs[0]);
+        for (int32_t row = 0; row < outputDescs[0].dims.d[0]; row++)
+        {
+            int32_t const* index = indices + 3 * row;
+            if (index[0] == -1 || (row > 0 && std::equal(index, index + 3, index - 3)))
+            {
+                break;
+            }
+            if (index[0] < 0 || index[0] >= batchSize || index[1] < 0 || index[1] >= numClasses || index[2] < 0
+                || index[2] >= numAnchors)
+            {
+                std::fprintf(stderr, "%s: index %d is out of the inputs\n", config.name, row);
+                return -1;
+            }
+            numDetections++;
+        }
+        return numDetections;
+    }
+
+    int32_t const* counts = static_cast<int32_t const*>(outputs[0]);
+    int32_t const countsPerImage = outputDescs[0].dims.d[1];
+    int32_t const numSlots = outputDescs[1].dims.d[1] / countsPerImage;
+    int32_t const* offsets = config.compactOutput ? static_cast<int32_t const*>(outputs[nbOutputs - 1]) : nullptr;
+    for (int32_t imageIdx = 0; imageIdx < outputDescs[0].dims.d[0]; imageIdx++)
+    {
+        int32_t imageDetections = 0;
+        for (int32_t countIdx = 0; countIdx < countsPerImage; countIdx++)
+        {
+            int32_t const count = counts[imageIdx * countsPerImage + countIdx];
+            if (count < 0 || count > numSlots)
+            {
+                std::fprintf(stderr, "%s: %d detections of image %d do not fit its %d slots\n", config.name, count,
+                    imageIdx, numSlots);
+                return -1;
+            }
+            imageDetections += count;
+        }
+        if (offsets != nullptr && offsets[imageIdx + 1] - offsets[imageIdx] != imageDetections)
+        {
+            std::fprintf(stderr, "%s: the offsets of image %d do not match its detections\n", config.name, imageIdx);
+            return -1;
+        }
+        numDetections += imageDetections;
+    }
+    return numDetections;
+}
+
+int32_t runConfig(HarnessConfig const& config, HarnessOptions const& options, HarnessInputs const& data)
+{
+    // Plugin Creation
+    float const scoreThreshold = 0.25F;
+    float const iouThreshold = 0.5F;
+    int32_t const maxOutputBoxes = 100;
+    int32_t const backgroundClass = -1;
+    int32_t const scoreActivation = 0;
+    int32_t const boxCoding = 0;
+    int32_t const packedImageSize[] = {1024, 1024};
+    float const oksThreshold = 0.5F;
+    std::vector<float> tileTransforms;
+    for (int32_t tileIdx = 0; tileIdx < config.tilesPerImage; tileIdx++)
+    {
+        float const tileWidth = 1.F / config.tilesPerImage;
+        tileTransforms.insert(tileTransforms.end(), {0.F, tileIdx * tileWidth, 1.F, tileWidth});
+    }
+    std::vector<PluginField> fields;
+    if (config.onnx)
+    {
+        fields.emplace_back("score_threshold", &scoreThreshold, PluginFieldType::kFLOAT32, 1);
+        fields.emplace_back("iou_threshold", &iouThreshold, PluginFieldType::kFLOAT32, 1);
+        fields.emplace_back("max_output_boxes_per_class", &maxOutputBoxes, PluginFieldType::kINT32, 1);
+        fields.emplace_back("center_point_box", &boxCoding, PluginFieldType::kINT32, 1);
+    }
+    else
+    {
+        fields.emplace_back("score_threshold", &scoreThreshold, PluginFieldType::kFLOAT32, 1);
+        fields.emplace_back("iou_threshold", &iouThreshold, PluginFieldType::kFLOAT32, 1);
+        fields.emplace_back("max_output_boxes", &maxOutputBoxes, PluginFieldType::kINT32, 1);
+        fields.emplace_back("background_class", &backgroundClass, PluginFieldType::kINT32, 1);
+        fields.emplace_back("score_activation", &scoreActivation, PluginFieldType::kINT32, 1);
+        fields.emplace_back("box_coding", &boxCoding, PluginFieldType::kINT32, 1);
+        fields.emplace_back("compact_output", &config.compactOutput, PluginFieldType::kINT32, 1);
+        fields.emplace_back("packed_output", &config.packedOutput, PluginFieldType::kINT32, 1);
+        fields.emplace_back("packed_image_size", packedImageSize, PluginFieldType::kINT32, 2);
+        fields.emplace_back("sparse_input", &config.sparseInput, PluginFieldType::kINT32, 1);
+        fields.emplace_back("num_classes", &options.numClasses, PluginFieldType::kINT32, 1);
+        fields.emplace_back("tiles_per_image", &config.tilesPerImage, PluginFieldType::kINT32, 1);
+        fields.emplace_back("tile_transforms", tileTransforms.data(), PluginFieldType::kFLOAT32,
+            static_cast<int32_t>(tileTransforms.size()));
+        fields.emplace_back("max_swept_candidates", &config.maxSweptCandidates, PluginFieldType::kINT32, 1);
+        if (config.numKeypoints > 0)
+        {
+            fields.emplace_back("oks_threshold", &oksThreshold, PluginFieldType::kFLOAT32, 1);
+            fields.emplace_back("keypoint_sigmas", kKeypointSigmas, PluginFieldType::kFLOAT32, config.numKeypoints);
+        }
+    }
+    PluginFieldCollection fc{static_cast<int32_t>(fields.size()), fields.data()};
+
+    // The class major layout has no creator attribute, so its plugin is built from the parameters the creator would
+    // have set.
+    EfficientPoseNMSParameters classMajorParam;
+    classMajorParam.scoreThreshold = scoreThreshold;
+    classMajorParam.iouThreshold = iouThreshold;
+    classMajorParam.numOutputBoxes = maxOutputBoxes;
+    classMajorParam.backgroundClass = backgroundClass;
+    classMajorParam.scoreSigmoid = static_cast<bool>(scoreActivation);
+    classMajorParam.boxCoding = boxCoding;
+    classMajorParam.numOutputBoxesPerClass = kBoxesPerClass;
+    classMajorParam.classMajorOutput = true;
+
+    MethodStats createStats{"createPlugin"};
+    MethodStats serializeStats{"serialize"};
+    MethodStats deserializeStats{"deserializePlugin"};
+    MethodStats initializeStats{"initialize"};
+    MethodStats cloneStats{"clone"};
+    MethodStats outputDimensionsStats{"getOutputDimensions"};
+    MethodStats formatStats{"supportsFormatCombination"};
+    MethodStats configureStats{"configurePlugin"};
+    MethodStats workspaceSizeStats{"getWorkspaceSize"};
+    MethodStats enqueueStats{"enqueue"};
+    MethodStats destroyStats{"destroy"};
+
+    EfficientPoseNMSPluginCreator standardCreator;
+    EfficientPoseNMSONNXPluginCreator onnxCreator;
+    IPluginCreator& creator = config.onnx ? static_cast<IPluginCreator&>(onnxCreator) : standardCreator;
+    IPluginV2DynamicExt* network = nullptr;
+    measure(createStats, [&] {
+        network = config.classMajorOutput
+            ? new EfficientPoseNMSPlugin(classMajorParam)
+            : static_cast<IPluginV2DynamicExt*>(creator.createPlugin("harness", &fc));
+    });
+    if (network == nullptr)
+    {
+        std::fprintf(stderr, "%s: createPlugin failed\n", config.name);
+        return 1;
+    }
+
+    // Engine serialization round trip, the engine then only holds the deserialized plugin.
+    std::vector<char> serialized(network->getSerializationSize());
+    measure(serializeStats, [&] { network->serialize(serialized.data()); });
+    network->destroy();
+    IPluginV2DynamicExt* engine = nullptr;
+    measure(deserializeStats, [&] {
+        engine = static_cast<IPluginV2DynamicExt*>(
+            creator.deserializePlugin("harness", serialized.data(), serialized.size()));
+    });
+    if (engine == nullptr)
+    {
+        std::fprintf(stderr, "%s: deserializePlugin failed\n", config.name);
+        return 1;
+    }
+
+    // Serialized parameters of another version are rejected, rather than misread.
+    std::vector<char> otherVersion = serialized;
+    int32_t const version = EFFICIENT_POSE_NMS_SERIALIZATION_VERSION + 1;
+    std::memcpy(otherVersion.data(), &version, sizeof(version));
+    IPluginV2DynamicExt* rejected = static_cast<IPluginV2DynamicExt*>(
+        creator.deserializePlugin("harness", otherVersion.data(), otherVersion.size()));
+    if (rejected != nullptr)
+    {
+        std::fprintf(stderr, "%s: deserializePlugin accepted serialization version %d\n", config.name, version);
+        rejected->destroy();
+        return 1;
+    }
+    int32_t status = 0;
+    measure(initializeStats, [&] { status = engine->initialize(); });
+    if (status != 0)
+    {
+        std::fprintf(stderr, "%s: initialize failed\n", config.name);
+        return 1;
+    }
+
+    int32_t const nbOutputs = engine->getNbOutputs();
+    constexpr int32_t kMaxTensors{16};
+    PluginTensorDesc descs[kMaxTensors];
+    DynamicPluginTensorDesc dynamicDescs[kMaxTensors];
+    void const* inputs[kMaxTensors];
+    void* outputs[kMaxTensors];
+    HarnessOutputs callOutputs;
+    std::vector<char> workspace;
+
+    HarnessExprBuilder exprBuilder;
+    int64_t totalDetections = 0;
+    for (int32_t iteration = 0; iteration < options.numIterations; iteration++)
+    {
+        int32_t batchSize = kBatchSizes[iteration % 5];
+        int32_t numAnchors = kAnchorCounts[iteration % 4];
+
+        // Each execution context owns a clone of the engine plugin.
+        IPluginV2DynamicExt* context = nullptr;
+        measure(cloneStats, [&] { context = engine->clone(); });
+
+        int32_t const nbInputs = makeInputs(config, data, options.numClasses, batchSize, numAnchors, descs, inputs);
+        measure(outputDimensionsStats,
+            [&] { declareOutputs(context, descs, nbInputs, exprBuilder, descs + nbInputs); });
+
+        bool supported = true;
+        measure(formatStats, [&] {
+            for (int32_t pos = 0; pos < nbInputs + nbOutputs; pos++)
+            {
+                supported = context->supportsFormatCombination(pos, descs, nbInputs, nbOutputs) && supported;
+            }
+        });
+        if (!supported)
+        {
+            std::fprintf(stderr, "%s: supportsFormatCombination rejected the declared formats\n", config.name);
+            return 1;
+        }
+
+        for (int32_t i = 0; i < nbInputs + nbOutputs; i++)
+        {
+            dynamicDescs[i].desc = descs[i];
+            dynamicDescs[i].min = descs[i].dims;
+            dynamicDescs[i].max = descs[i].dims;
+            dynamicDescs[i].opt = descs[i].dims;
+        }
+        measure(configureStats,
+            [&] { context->configurePlugin(dynamicDescs, nbInputs, dynamicDescs + nbInputs, nbOutputs); });
+
+        size_t workspaceSize = 0;
+        measure(workspaceSizeStats,
+            [&] { workspaceSize = context->getWorkspaceSize(descs, nbInputs, descs + nbInputs, nbOutputs); });
+        if (workspace.size() < workspaceSize)
+        {
+            workspace.resize(workspaceSize);
+        }
+
+        callOutputs.layout(descs + nbInputs, nbOutputs);
+        callOutputs.poison(-1);
+        callOutputs.pointers(outputs);
+        measure(enqueueStats,
+            [&] { status = context->enqueue(descs, descs + nbInputs, inputs, outputs, workspace.data(), nullptr); });
+        if (status != 0)
+        {
+            std::fprintf(stderr, "%s: enqueue failed with status %d\n", config.name, status);
+            return 1;
+        }
+        if (!callOutputs.guarded())
+        {
+            std::fprintf(stderr, "%s: enqueue wrote past the declared outputs\n", config.name);
+            return 1;
+        }
+
+        int64_t const numDetections = countDetections(
+            config, descs + nbInputs, outputs, nbOutputs, batchSize, options.numClasses, numAnchors);
+        if (numDetections < 0)
+        {
+            return 1;
+        }
+        totalDetections += numDetections;
+
+        measure(destroyStats, [&] { context->destroy(); });
+    }
+
+    std::printf("%s: %d outputs, %d iterations, %d classes, %lld detections\n", config.name, nbOutputs,
+        options.numIterations, options.numClasses, static_cast<long long>(totalDetections));
+    std::printf("%-28s %10s %14s %14s\n", "method", "calls", "avg ns/call", "allocs/call");
+    for (MethodStats const* stats : {&createStats, &serializeStats, &deserializeStats, &initializeStats, &cloneStats,
+             &outputDimensionsStats, &formatStats, &configureStats, &workspaceSizeStats, &enqueueStats, &destroyStats})
+    {
+        std::printf("%-28s %10lld %14.1f %14.2f\n", stats->name, static_cast<long long>(stats->calls),
+            static_cast<double>(stats->nanoseconds) / stats->calls, static_cast<double>(stats->allocations) / stats->calls);
+    }
+
+    if (options.maxThreads > 0)
+    {
+        // Concurrent Stress: one context, configured once for the largest shape, and enqueued from many threads at
+        // once with the batch sizes cycled through per call.
+        IPluginV2DynamicExt* context = engine->clone();
+        int32_t const nbInputs
+            = makeInputs(config, data, options.numClasses, kMaxBatchSize, kMaxAnchors, descs, inputs);
+        declareOutputs(context, descs, nbInputs, exprBuilder, descs + nbInputs);
+        for (int32_t i = 0; i < nbInputs + nbOutputs; i++)
+        {
+            dynamicDescs[i].desc = descs[i];
+            dynamicDescs[i].min = descs[i].dims;
+            dynamicDescs[i].max = descs[i].dims;
+            dynamicDescs[i].opt = descs[i].dims;
+        }
+        context->configurePlugin(dynamicDescs, nbInputs, dynamicDescs + nbInputs, nbOutputs);
+        size_t const workspaceSize = context->getWorkspaceSize(descs, nbInputs, descs + nbInputs, nbOutputs);
+
+        // The descriptions of the calls of each batch size. The outputs of every call stay laid out for the largest
+        // batch, so that a call only ever writes a prefix of each.
+        HarnessOutputs maxOutputs;
+        maxOutputs.layout(descs + nbInputs, nbOutputs);
+        std::vector<std::vector<PluginTensorDesc>> batchDescs(5, std::vector<PluginTensorDesc>(nbInputs + nbOutputs));
+        for (int32_t i = 0; i < 5; i++)
+        {
+            makeInputs(config, data, options.numClasses, kBatchSizes[i], kMaxAnchors, batchDescs[i].data(), inputs);
+            declareOutputs(context, batchDescs[i].data(), nbInputs, exprBuilder, batchDescs[i].data() + nbInputs);
+        }
+        auto enqueueBatch = [&](int32_t batchIdx, HarnessOutputs& batchOutputs, std::vector<char>& batchWorkspace) {
+            void* batchOutputPointers[kMaxTensors];
+            batchOutputs.pointers(batchOutputPointers);
+            PluginTensorDesc const* batchDesc = batchDescs[batchIdx].data();
+            return context->enqueue(
+                batchDesc, batchDesc + nbInputs, inputs, batchOutputPointers, batchWorkspace.data(), nullptr);
+        };
+
+        // Single threaded reference results, one per batch size, on outputs poisoned the same way as below.
+        std::vector<HarnessOutputs> references(5, maxOutputs);
+        std::vector<char> referenceWorkspace(workspaceSize);
+        for (int32_t i = 0; i < 5; i++)
+        {
+            references[i].poison(-1);
+            if (enqueueBatch(i, references[i], referenceWorkspace) != 0 || !references[i].guarded())
+            {
+                std::fprintf(stderr, "%s: enqueue failed\n", config.name);
+                return 1;
+            }
+        }
+
+        std::printf("\nconcurrent enqueue on one instance, %d calls per thread count\n", options.numIterations);
+        std::printf("%-10s %14s %10s %12s\n", "threads", "calls/s", "speedup", "mismatches");
+        double baseRate = 0.;
+        for (int32_t numThreads = 1; numThreads <= options.maxThreads; numThreads *= 2)
+        {
+            std::atomic<int32_t> nextCall{0};
+            std::atomic<int32_t> numMismatches{0};
+            std::atomic<int32_t> numFailures{0};
+            auto worker = [&]() {
+                HarnessOutputs threadOutputs = maxOutputs;
+                std::vector<char> threadWorkspace(workspaceSize);
+                for (int32_t call = nextCall++; call < options.numIterations; call = nextCall++)
+                {
+                    // Outputs are poisoned first, so that a call that skips any write is caught.
+                    threadOutputs.poison(-1);
+                    if (enqueueBatch(call % 5, threadOutputs, threadWorkspace) != 0)
+                    {
+                        numFailures++;
+                    }
+                    else if (threadOutputs.words != references[call % 5].words)
+                    {
+                        numMismatches++;
+                    }
+                }
+            };
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (int32_t t = 1; t < numThreads; t++)
+            {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            auto end = std::chrono::steady_clock::now();
+            if (numFailures > 0)
+            {
+                std::fprintf(stderr, "%s: enqueue failed on %d calls\n", config.name, numFailures.load());
+                return 1;
+            }
+
+            double rate = options.numIterations / std::chrono::duration<double>(end - start).count();
+            baseRate = numThreads == 1 ? rate : baseRate;
+            std::printf("%-10d %14.1f %10.2f %12d\n", numThreads, rate, rate / baseRate, numMismatches.load());
+        }
+        context->destroy();
+    }
+    std::printf("\n");
+
+    engine->terminate();
+    engine->destroy();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    HarnessOptions options{1000, 1, 0};
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (!std::strncmp(argv[i], "--iterations=", 13))
+        {
+            options.numIterations = std::atoi(argv[i] + 13);
+        }
+        else if (!std::strncmp(argv[i], "--classes=", 10))
+        {
+            options.numClasses = std::atoi(argv[i] + 10);
+        }
+        else if (!std::strncmp(argv[i], "--threads=", 10))
+        {
+            options.maxThreads = std::atoi(argv[i] + 10);
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--iterations=N] [--classes=C] [--threads=T]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.numIterations < 1 || options.numClasses < 1 || options.maxThreads < 0)
+    {
+        std::fprintf(stderr, "--iterations and --classes must be positive, and --threads can not be negative\n");
+        return 1;
+    }
+
+    // Inputs, sized for the largest shape, with tiles: boxes [B, A, 4] as corners, keypoints [B, A, 3K] within their
+    // box, some of them hidden, and scores [B, A, C] with most of them below the score threshold, like the output of a
+    // real detector. The sparse scores [B, N] and candidate indices [B, N, 2] list each of the first N anchors once,
+    // with one of its classes, and the candidate counts [B] list a varying part of them.
+    HarnessInputs data;
+    uint32_t state = 1;
+    size_t const maxTiles = static_cast<size_t>(kMaxTiles) * kMaxBatchSize * kMaxAnchors;
+    data.boxes.resize(maxTiles * 4);
+    data.keypoints.resize(maxTiles * 3 * kNumKeypoints);
+    for (size_t i = 0; i < maxTiles; i++)
+    {
+        float y = (nextRandom(state) % 1000) / 1000.F;
+        float x = (nextRandom(state) % 1000) / 1000.F;
+        float h = 0.02F + (nextRandom(state) % 200) / 1000.F;
+        float w = 0.02F + (nextRandom(state) % 200) / 1000.F;
+        data.boxes[i * 4 + 0] = y;
+        data.boxes[i * 4 + 1] = x;
+        data.boxes[i * 4 + 2] = y + h;
+        data.boxes[i * 4 + 3] = x + w;
+        for (int32_t j = 0; j < kNumKeypoints; j++)
+        {
+            float* keypoint = &data.keypoints[(i * kNumKeypoints + j) * 3];
+            keypoint[0] = y + h * (nextRandom(state) % 1000) / 1000.F;
+            keypoint[1] = x + w * (nextRandom(state) % 1000) / 1000.F;
+            keypoint[2] = (nextRandom(state) % 1000) / 1000.F - 0.2F;
+        }
+    }
+    data.scores.resize(maxTiles * options.numClasses);
+    for (auto& score : data.scores)
+    {
+        score = (nextRandom(state) % 10000) / 10000.F;
+        score = score * score * score;
+    }
+    data.candidateScores.resize(static_cast<size_t>(kMaxBatchSize) * kMaxCandidates);
+    data.candidateIndices.resize(data.candidateScores.size() * 2);
+    for (size_t i = 0; i < data.candidateScores.size(); i++)
+    {
+        float score = (nextRandom(state) % 10000) / 10000.F;
+        data.candidateScores[i] = score * score;
+        data.candidateIndices[i * 2 + 0] = static_cast<int32_t>(i % kMaxCandidates);
+        data.candidateIndices[i * 2 + 1] = static_cast<int32_t>(nextRandom(state) % options.numClasses);
+    }
+    data.candidateCounts.resize(kMaxBatchSize);
+    for (auto& count : data.candidateCounts)
+    {
+        count = static_cast<int32_t>(nextRandom(state) % (kMaxCandidates + 1));
+    }
+
+    for (HarnessConfig const& config : kConfigs)
+    {
+        if (runConfig(config, options, data) != 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the host implementation of EfficientPoseNMSInference against a brute force reference, on random inputs and
+// parameters: per class and class agnostic NMS, class argmax, a background class, per class output limits, the
+// numSelectedBoxes limit, and the padded, compact and ONNX outputs, both serially and on an executor. The scores are
+// quantized, so that many of them tie, which checks that equal scores keep the element order. Some cases have OKS
+// suppression with a threshold that is never reached, which leaves the results unchanged, and checks that the
+// keypoints output holds the input keypoints of each detection.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSIndexing.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+using nvinfer1::plugin::EfficientPoseNMSOutputKeypoints;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+struct Box
+{
+    float y1;
+    float x1;
+    float y2;
+    float x2;
+};
+
+float area(Box const& box)
+{
+    float const height = box.y2 - box.y1;
+    float const width = box.x2 - box.x1;
+    return height <= 0.F || width <= 0.F ? 0.F : height * width;
+}
+
+float iou(Box const& a, Box const& b)
+{
+    Box const intersection{
+        std::max(a.y1, b.y1), std::max(a.x1, b.x1), std::min(a.y2, b.y2), std::min(a.x2, b.x2)};
+    float const intersectionArea = area(intersection);
+    if (intersectionArea <= 0.F)
+    {
+        return 0.F;
+    }
+    float const unionArea = area(a) + area(b) - intersectionArea;
+    return unionArea <= 0.F ? 0.F : intersectionArea / unionArea;
+}
+
+// Greedy NMS over every candidate of each image, tested against all the boxes kept before it. Returns the elements
+// (anchor * numClasses + class) written out for each image, in output order.
+std::vector<std::vector<int32_t>> referenceNMS(
+    EfficientPoseNMSParameters const& param, std::vector<float> const& boxes, std::vector<float> const& scores)
+{
+    int32_t const numClasses = param.numClasses;
+    int32_t const numElements = param.numAnchors * numClasses;
+    std::vector<std::vector<int32_t>> selected(param.batchSize);
+    for (int32_t imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+    {
+        float const* imageScores = scores.data() + static_cast<size_t>(imageIdx) * numElements;
+        Box const* imageBoxes = reinterpret_cast<Box const*>(boxes.data()) + static_cast<size_t>(imageIdx)
+            * param.numAnchors;
+
+        std::vector<std::pair<float, int32_t>> candidates;
+        if (param.classArgmax && numClasses > 1)
+        {
+            for (int32_t anchorIdx = 0; anchorIdx < param.numAnchors; anchorIdx++)
+            {
+                int32_t bestClass = -1;
+                float bestScore = 0.F;
+                for (int32_t classIdx = 0; classIdx < numClasses; classIdx++)
+                {
+                    float const score = imageScores[anchorIdx * numClasses + classIdx];
+                    if (classIdx != param.backgroundClass && (bestClass < 0 || score > bestScore))
+                    {
+                        bestClass = classIdx;
+                        bestScore = score;
+                    }
+                }
+                if (bestClass >= 0 && bestScore >= param.scoreThreshold)
+                {
+                    candidates.emplace_back(bestScore, anchorIdx * numClasses + bestClass);
+                }
+            }
+        }
+        else
+        {
+            for (int32_t elementIdx = 0; elementIdx < numElements; elementIdx++)
+            {
+                if (imageScores[elementIdx] >= param.scoreThreshold
+                    && elementIdx % numClasses != param.backgroundClass)
+                {
+                    candidates.emplace_back(imageScores[elementIdx], elementIdx);
+                }
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+            [](std::pair<float, int32_t> const& a, std::pair<float, int32_t> const& b) { return a.first > b.first; });
+        if (static_cast<int32_t>(candidates.size()) > param.numSelectedBoxes)
+        {
+            candidates.resize(param.numSelectedBoxes);
+        }
+
+        // Boxes over the per class output limit are kept, and so still suppress others, but are not written out.
+        std::vector<int32_t> kept;
+        std::vector<int32_t> classCounts(numClasses, 0);
+        for (auto const& candidate : candidates)
+        {
+            int32_t const elementIdx = candidate.second;
+            bool suppressed = false;
+            for (int32_t keptIdx : kept)
+            {
+                if ((param.classAgnostic || keptIdx % numClasses == elementIdx % numClasses)
+                    && iou(imageBoxes[elementIdx / numClasses], imageBoxes[keptIdx / numClasses])
+                        >= param.iouThreshold)
+                {
+                    suppressed = true;
+                    break;
+                }
+            }
+            if (suppressed)
+            {
+                continue;
+            }
+            if (static_cast<int32_t>(selected[imageIdx].size()) >= param.numOutputBoxes)
+            {
+                break;
+            }
+            kept.push_back(elementIdx);
+            int32_t const classCount = classCounts[elementIdx % numClasses]++;
+            if (param.numOutputBoxesPerClass < 0 || classCount < param.numOutputBoxesPerClass)
+            {
+                selected[imageIdx].push_back(elementIdx);
+            }
+        }
+    }
+    return selected;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(0.F, 1.F);
+    EfficientPoseNMSHostExecutor executor(3);
+    int32_t numFailures = 0;
+    for (int32_t caseIdx = 0; caseIdx < 300; caseIdx++)
+    {
+        EfficientPoseNMSParameters param;
+        param.batchSize = 1 + rng() % 4;
+        param.numAnchors = 1 + rng() % 300;
+        param.numClasses = 1 + rng() % 6;
+        param.numScoreElements = param.numAnchors * param.numClasses;
+        param.numBoxElements = param.numAnchors * 4;
+        param.scoreThreshold = (rng() % 50) / 100.F;
+        param.iouThreshold = 0.1F + (rng() % 80) / 100.F;
+        param.numOutputBoxes = 1 + rng() % 60;
+        param.numOutputBoxesPerClass = rng() % 3 == 0 ? static_cast<int32_t>(rng() % 10) : -1;
+        param.numSelectedBoxes = 50 + rng() % 1000;
+        param.classAgnostic = rng() % 2;
+        param.classArgmax = rng() % 3 == 0;
+        param.backgroundClass = rng() % 3 == 0 ? 0 : -1;
+        param.compactOutput = rng() % 2;
+        param.outputONNXIndices = rng() % 4 == 0;
+        if (rng() % 3 == 0)
+        {
+            // OKS never exceeds 1, so no box is suppressed by it.
+            param.oksThreshold = 1.5F;
+            param.numKeypoints = 1 + rng() % 5;
+            for (int32_t j = 0; j < param.numKeypoints; j++)
+            {
+                param.keypointSigmas[j] = 0.05F;
+            }
+        }
+
+        size_t const numImageAnchors = static_cast<size_t>(param.batchSize) * param.numAnchors;
+        std::vector<float> boxes(numImageAnchors * 4);
+        for (size_t anchorIdx = 0; anchorIdx < numImageAnchors; anchorIdx++)
+        {
+            float const y = uniform(rng);
+            float const x = uniform(rng);
+            boxes[anchorIdx * 4 + 0] = y;
+            boxes[anchorIdx * 4 + 1] = x;
+            boxes[anchorIdx * 4 + 2] = y + uniform(rng) * 0.3F;
+            boxes[anchorIdx * 4 + 3] = x + uniform(rng) * 0.3F;
+        }
+        std::vector<float> scores(numImageAnchors * param.numClasses);
+        for (float& score : scores)
+        {
+            score = std::round(uniform(rng) * 64.F) / 64.F;
+        }
+        std::vector<float> keypoints(numImageAnchors * 3 * param.numKeypoints);
+        for (float& value : keypoints)
+        {
+            value = uniform(rng);
+        }
+
+        int32_t const numOutputBoxes = param.numOutputBoxes;
+        size_t const numOutputs = static_cast<size_t>(param.batchSize) * numOutputBoxes;
+        std::vector<int32_t> numDetections(param.batchSize);
+        std::vector<float> nmsBoxes(numOutputs * 4);
+        int32_t const numKeypointValues = 3 * EfficientPoseNMSOutputKeypoints(param);
+        std::vector<float> nmsKpts(numOutputs * numKeypointValues);
+        std::vector<float> nmsScores(numOutputs);
+        std::vector<int32_t> nmsClasses(numOutputs);
+        std::vector<int32_t> nmsIndices(numOutputs * 3);
+        std::vector<int32_t> nmsOffsets(param.batchSize + 1);
+        std::vector<char> workspace(EfficientPoseNMSHostWorkspaceSize(
+            param.batchSize, param.numScoreElements, param.numClasses, DataType::kFLOAT, param.numKeypoints));
+        pluginStatus_t status = EfficientPoseNMSHostInference(param, boxes.data(), scores.data(), nullptr,
+            keypoints.data(),
+            numDetections.data(), nmsBoxes.data(), nmsKpts.data(), nmsScores.data(), nmsClasses.data(),
+            nmsIndices.data(), nmsOffsets.data(), workspace.data(), caseIdx % 2 ? &executor : nullptr);
+        if (status != STATUS_SUCCESS)
+        {
+            std::printf("case %d: EfficientPoseNMSHostInference failed with status %d\n", caseIdx, status);
+            numFailures++;
+            continue;
+        }
+
+        std::vector<std::vector<int32_t>> const expected = referenceNMS(param, boxes, scores);
+        int32_t firstRow = 0;
+        for (int32_t imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+        {
+            int32_t const numExpected = static_cast<int32_t>(expected[imageIdx].size());
+            if (!param.outputONNXIndices && numDetections[imageIdx] != numExpected)
+            {
+                std::printf("case %d, image %d: %d detections instead of %d\n", caseIdx, imageIdx,
+                    numDetections[imageIdx], numExpected);
+                numFailures++;
+                break;
+            }
+            if (param.compactOutput && !param.outputONNXIndices && nmsOffsets[imageIdx] != firstRow)
+            {
+                std::printf("case %d, image %d: offset %d instead of %d\n", caseIdx, imageIdx, nmsOffsets[imageIdx],
+                    firstRow);
+                numFailures++;
+                break;
+            }
+            bool imageMatches = true;
+            for (int32_t detectionIdx = 0; detectionIdx < numExpected && imageMatches; detectionIdx++)
+            {
+                // The ONNX indices and the compact rows of all images are back to back, the padded ones are not.
+                int32_t const row = param.outputONNXIndices || param.compactOutput
+                    ? firstRow + detectionIdx
+                    : imageIdx * numOutputBoxes + detectionIdx;
+                int32_t const elementIdx = expected[imageIdx][detectionIdx];
+                int32_t const anchorIdx = elementIdx / param.numClasses;
+                int32_t const classIdx = elementIdx % param.numClasses;
+                size_t const inputAnchor = static_cast<size_t>(imageIdx) * param.numAnchors + anchorIdx;
+                if (param.outputONNXIndices)
+                {
+                    imageMatches = nmsIndices[row * 3 + 0] == imageIdx && nmsIndices[row * 3 + 1] == classIdx
+                        && nmsIndices[row * 3 + 2] == anchorIdx;
+                }
+                else
+                {
+                    imageMatches = nmsClasses[row] == classIdx
+                        && nmsScores[row] == scores[inputAnchor * param.numClasses + classIdx]
+                        && std::equal(&nmsBoxes[row * 4], &nmsBoxes[row * 4] + 4, &boxes[inputAnchor * 4]);
+                    // Without OKS suppression, the single keypoint of each detection is zero.
+                    for (int32_t j = 0; j < numKeypointValues && imageMatches; j++)
+                    {
+                        float const keypoint = param.oksThreshold >= 0.F
+                            ? keypoints[inputAnchor * numKeypointValues + j]
+                            : 0.F;
+                        imageMatches = nmsKpts[row * numKeypointValues + j] == keypoint;
+                    }
+                }
+                if (!imageMatches)
+                {
+                    std::printf("case %d, image %d: detection %d differs from the reference\n", caseIdx, imageIdx,
+                        detectionIdx);
+                    numFailures++;
+                }
+            }
+            firstRow += numExpected;
+        }
+    }
+
+    std::printf("%d failures\n", numFailures);
+    return numFailures == 0 ? 0 : 1;
+}
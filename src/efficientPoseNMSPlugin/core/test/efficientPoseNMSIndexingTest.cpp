@@ -0,0 +1,257 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the index arithmetic of efficientPoseNMSIndexing.h: the selection of the int64_t indexing variant for sizes
+// on either side of INT_MAX, and the box indices against a count of the boxes in layout order, both on their own,
+// including past INT_MAX, and through a host run with per class boxes.
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSIndexing.h"
+
+using namespace nvinfer1;
+using nvinfer1::plugin::EfficientPoseNMSBoxIndex;
+using nvinfer1::plugin::EfficientPoseNMSLargeIndexing;
+using nvinfer1::plugin::EfficientPoseNMSParameters;
+
+namespace
+{
+
+struct IndexingCase
+{
+    char const* name;
+    int32_t batchSize;
+    int32_t numScoreElements;
+    int32_t numBoxElements;
+    int32_t numOutputBoxes;
+    bool sparseInput;
+    int32_t numAnchors;
+    int32_t numKeypoints;
+    bool oks;
+    bool largeIndexing;
+};
+
+int32_t checkLargeIndexing()
+{
+    // Each size is taken just below (or at) INT_MAX and just above it, with the others small.
+    int32_t const half = INT_MAX / 2 + 1;
+    IndexingCase const cases[] = {
+        {"small", 8, 8400 * 80, 8400 * 4, 100, false, 8400, 0, false, false},
+        {"scores at INT_MAX", 1, INT_MAX, 4, 100, false, 1, 0, false, false},
+        {"scores below INT_MAX", 2, half - 1, 4, 100, false, 1, 0, false, false},
+        {"scores above INT_MAX", 2, half, 4, 100, false, 1, 0, false, true},
+        {"scores above INT_MAX in int32", 3, 1000000000, 4, 100, false, 1, 0, false, true},
+        {"sparse scores below INT_MAX", 1, half - 1, 4, 100, true, 1, 0, false, false},
+        {"sparse scores above INT_MAX", 1, half, 4, 100, true, 1, 0, false, true},
+        {"boxes below INT_MAX", 2, 80, half - 4, 100, false, 1, 0, false, false},
+        {"boxes above INT_MAX", 2, 80, half, 100, false, 1, 0, false, true},
+        {"outputs below INT_MAX", 1, 80, 4, INT_MAX / 4, false, 1, 0, false, false},
+        {"outputs above INT_MAX", 1, 80, 4, INT_MAX / 4 + 1, false, 1, 0, false, true},
+        {"batch above INT_MAX", INT_MAX, 2, 4, 1, false, 1, 0, false, true},
+        // With OKS suppression, the keypoints input is [batchSize, numAnchors, 3 * numKeypoints], and the keypoints
+        // gathered for the scores are [batchSize, numScoreElements, 3 * numKeypoints].
+        {"small keypoints", 8, 8400, 8400 * 4, 100, false, 8400, 17, true, false},
+        {"keypoints input below INT_MAX", 1, 1, 4, 100, false, INT_MAX / 51, 17, true, false},
+        {"keypoints input above INT_MAX", 1, 1, 4, 100, false, INT_MAX / 51 + 1, 17, true, true},
+        {"keypoints input above INT_MAX without OKS", 1, 1, 4, 100, false, INT_MAX / 51 + 1, 17, false, false},
+        {"gathered keypoints below INT_MAX", 1, INT_MAX / 51, 4, 100, false, 1, 17, true, false},
+        {"gathered keypoints above INT_MAX", 1, INT_MAX / 51 + 1, 4, 100, false, 1, 17, true, true},
+        {"gathered keypoints above INT_MAX without OKS", 1, INT_MAX / 51 + 1, 4, 100, false, 1, 17, false, false},
+    };
+    int32_t numFailures = 0;
+    for (IndexingCase const& indexingCase : cases)
+    {
+        EfficientPoseNMSParameters param;
+        param.batchSize = indexingCase.batchSize;
+        param.numScoreElements = indexingCase.numScoreElements;
+        param.numBoxElements = indexingCase.numBoxElements;
+        param.numOutputBoxes = indexingCase.numOutputBoxes;
+        param.sparseInput = indexingCase.sparseInput;
+        param.numAnchors = indexingCase.numAnchors;
+        param.numKeypoints = indexingCase.numKeypoints;
+        param.oksThreshold = indexingCase.oks ? 0.5F : -1.F;
+        if (EfficientPoseNMSLargeIndexing(param) != indexingCase.largeIndexing)
+        {
+            std::printf("%s: large indexing is %d instead of %d\n", indexingCase.name, !indexingCase.largeIndexing,
+                indexingCase.largeIndexing);
+            numFailures++;
+        }
+    }
+    return numFailures;
+}
+
+int32_t checkBoxIndices()
+{
+    int32_t numFailures = 0;
+    for (bool shareLocation : {true, false})
+    {
+        EfficientPoseNMSParameters param;
+        param.shareLocation = shareLocation;
+        param.numClasses = 3;
+
+        // Every box of a small input, counted in layout order.
+        int32_t const batchSize = 4;
+        int32_t const numAnchors = 5;
+        size_t expected = 0;
+        for (int32_t imageIdx = 0; imageIdx < batchSize; imageIdx++)
+        {
+            for (int32_t anchorIdx = 0; anchorIdx < numAnchors; anchorIdx++)
+            {
+                for (int32_t classIdx = 0; classIdx < param.numClasses; classIdx++)
+                {
+                    size_t const boxIdx = EfficientPoseNMSBoxIndex(param, imageIdx, numAnchors, anchorIdx, classIdx);
+                    if (boxIdx != expected)
+                    {
+                        std::printf("box (%d, %d, %d), shared %d: index %zu instead of %zu\n", imageIdx, anchorIdx,
+                            classIdx, shareLocation, boxIdx, expected);
+                        numFailures++;
+                    }
+                    if (!shareLocation || classIdx == param.numClasses - 1)
+                    {
+                        expected++;
+                    }
+                }
+            }
+        }
+
+        // The last box of inputs whose boxes, and whose box elements, are past what int can address, which must be
+        // one less than the number of boxes.
+        for (int32_t largeBatchSize : {1024, 65536})
+        {
+            int32_t const largeNumAnchors = 1 << 20;
+            size_t const numBoxes = static_cast<size_t>(largeBatchSize) * largeNumAnchors
+                * (shareLocation ? 1 : param.numClasses);
+            size_t const boxIdx = EfficientPoseNMSBoxIndex(
+                param, largeBatchSize - 1, largeNumAnchors, largeNumAnchors - 1, param.numClasses - 1);
+            if (boxIdx != numBoxes - 1)
+            {
+                std::printf("last box of %d images, shared %d: index %zu instead of %zu\n", largeBatchSize,
+                    shareLocation, boxIdx, numBoxes - 1);
+                numFailures++;
+            }
+        }
+    }
+    return numFailures;
+}
+
+int32_t checkHostRun()
+{
+    // Per class boxes, which are all distinct, with distinct scores, and no suppression, so that every detection can be
+    // traced back to its (anchor, class) through its score, and its box checked against the box at the counted index.
+    EfficientPoseNMSParameters param;
+    param.batchSize = 3;
+    param.numAnchors = 50;
+    param.numClasses = 4;
+    param.numScoreElements = param.numAnchors * param.numClasses;
+    param.numBoxElements = param.numScoreElements * 4;
+    param.shareLocation = false;
+    param.scoreThreshold = 0.F;
+    param.iouThreshold = 2.F;
+    param.numOutputBoxes = 40;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(0.F, 1.F);
+    std::vector<float> boxes(static_cast<size_t>(param.batchSize) * param.numBoxElements);
+    for (size_t boxIdx = 0; boxIdx < boxes.size() / 4; boxIdx++)
+    {
+        float const y = uniform(rng);
+        float const x = uniform(rng);
+        boxes[boxIdx * 4 + 0] = y;
+        boxes[boxIdx * 4 + 1] = x;
+        boxes[boxIdx * 4 + 2] = y + 0.1F;
+        boxes[boxIdx * 4 + 3] = x + 0.1F;
+    }
+    std::vector<float> scores(static_cast<size_t>(param.batchSize) * param.numScoreElements);
+    for (size_t scoreIdx = 0; scoreIdx < scores.size(); scoreIdx++)
+    {
+        scores[scoreIdx] = static_cast<float>(scoreIdx + 1) / scores.size();
+    }
+    std::shuffle(scores.begin(), scores.end(), rng);
+
+    size_t const numOutputs = static_cast<size_t>(param.batchSize) * param.numOutputBoxes;
+    std::vector<int32_t> numDetections(param.batchSize);
+    std::vector<float> nmsBoxes(numOutputs * 4);
+    std::vector<float> nmsKpts(numOutputs * 3);
+    std::vector<float> nmsScores(numOutputs);
+    std::vector<int32_t> nmsClasses(numOutputs);
+    std::vector<char> workspace(EfficientPoseNMSHostWorkspaceSize(
+        param.batchSize, param.numScoreElements, param.numClasses, DataType::kFLOAT));
+    pluginStatus_t status = EfficientPoseNMSHostInference(param, boxes.data(), scores.data(), nullptr, nullptr,
+        numDetections.data(), nmsBoxes.data(), nmsKpts.data(), nmsScores.data(), nmsClasses.data(), nullptr, nullptr,
+        workspace.data());
+    if (status != STATUS_SUCCESS)
+    {
+        std::printf("EfficientPoseNMSHostInference failed with status %d\n", status);
+        return 1;
+    }
+
+    int32_t numFailures = 0;
+    for (int32_t imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+    {
+        // The (anchor, class) of each score of the image, and the box index of each, counted in layout order.
+        std::map<float, std::pair<int32_t, int32_t>> elements;
+        for (int32_t elementIdx = 0; elementIdx < param.numScoreElements; elementIdx++)
+        {
+            elements[scores[static_cast<size_t>(imageIdx) * param.numScoreElements + elementIdx]]
+                = {elementIdx / param.numClasses, elementIdx % param.numClasses};
+        }
+        if (numDetections[imageIdx] != param.numOutputBoxes)
+        {
+            std::printf("image %d: %d detections instead of %d\n", imageIdx, numDetections[imageIdx],
+                param.numOutputBoxes);
+            numFailures++;
+            continue;
+        }
+        for (int32_t detectionIdx = 0; detectionIdx < param.numOutputBoxes; detectionIdx++)
+        {
+            size_t const row = static_cast<size_t>(imageIdx) * param.numOutputBoxes + detectionIdx;
+            auto const element = elements.find(nmsScores[row]);
+            if (element == elements.end() || element->second.second != nmsClasses[row])
+            {
+                std::printf("image %d, detection %d: unknown score or class\n", imageIdx, detectionIdx);
+                numFailures++;
+                break;
+            }
+            size_t const expected = (static_cast<size_t>(imageIdx) * param.numAnchors + element->second.first)
+                    * param.numClasses
+                + element->second.second;
+            if (!std::equal(&nmsBoxes[row * 4], &nmsBoxes[row * 4] + 4, &boxes[expected * 4]))
+            {
+                std::printf("image %d, detection %d: box differs from box %zu\n", imageIdx, detectionIdx, expected);
+                numFailures++;
+                break;
+            }
+        }
+    }
+    return numFailures;
+}
+
+} // namespace
+
+int main()
+{
+    int32_t numFailures = checkLargeIndexing() + checkBoxIndices() + checkHostRun();
+    std::printf("%d failures\n", numFailures);
+    return numFailures == 0 ? 0 : 1;
+}
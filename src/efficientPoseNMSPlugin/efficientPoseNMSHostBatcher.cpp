@@ -0,0 +1,254 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "efficientPoseNMSHostBatcher.h"
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSIndexing.h"
+#include "efficientPoseNMSPacked.h"
+#include "efficientPoseNMSTrace.h"
+
+using namespace nvinfer1;
+using namespace nvinfer1::plugin;
+
+namespace
+{
+
+// Sizes, in bytes, of the outputs of one image, in the order they are laid out in the batch outputs: detection counts,
+// boxes, keypoints, scores and classes, or the counts and the packed detections alone. The boxes, keypoints and scores
+// have the type of the inputs. Class major outputs have one count and numOutputBoxesPerClass slots per class.
+struct FrameOutputSizes
+{
+    size_t numDetections;
+    size_t boxes;
+    size_t keypoints;
+    size_t scores;
+    size_t classes;
+};
+
+size_t getElementSize(EfficientPoseNMSParameters const& param)
+{
+    return param.datatype == DataType::kHALF ? 2 : sizeof(float);
+}
+
+FrameOutputSizes getFrameOutputSizes(EfficientPoseNMSParameters const& param)
+{
+    if (param.packedOutput)
+    {
+        size_t const numOutputBoxes = param.numOutputBoxes;
+        return {sizeof(int32_t), numOutputBoxes * sizeof(EfficientPoseNMSPackedDetection), 0, 0, 0};
+    }
+    size_t const numCounts = param.classMajorOutput ? std::max(param.numClasses, 1) : 1;
+    size_t const numOutputBoxes = param.classMajorOutput
+        ? numCounts * std::max(param.numOutputBoxesPerClass, 0)
+        : static_cast<size_t>(param.numOutputBoxes);
+    size_t const elementSize = getElementSize(param);
+    size_t const numKeypointElements = 3 * static_cast<size_t>(EfficientPoseNMSOutputKeypoints(param));
+    return {numCounts * sizeof(int32_t), numOutputBoxes * 4 * elementSize,
+        numOutputBoxes * numKeypointElements * elementSize, numOutputBoxes * elementSize,
+        numOutputBoxes * sizeof(int32_t)};
+}
+
+} // namespace
+
+EfficientPoseNMSHostBatcher::EfficientPoseNMSHostBatcher(EfficientPoseNMSParameters const& param, int32_t maxBatchSize,
+    void const* anchorsInput, EfficientPoseNMSHostExecutor* executor)
+    : mParam(param)
+    , mMaxBatchSize(std::max(maxBatchSize, 1))
+    , mAnchorsInput(anchorsInput)
+    , mExecutor(executor)
+    , mElementSize(getElementSize(param))
+    , mNumBoxElements(std::max(param.numBoxElements, 0))
+    , mNumScoreElements(std::max(param.numScoreElements, 0))
+    , mNumKeypointElements(param.oksThreshold >= 0.F ? std::max(param.numAnchors, 0) * 3 * param.numKeypoints : 0)
+{
+    // Every frame gets its own padded outputs, and all frames share the anchors.
+    mParam.compactOutput = false;
+    mParam.outputONNXIndices = false;
+    mParam.shareAnchors = true;
+
+    FrameOutputSizes const sizes = getFrameOutputSizes(mParam);
+    size_t const frameOutputSize = sizes.numDetections + sizes.boxes + sizes.keypoints + sizes.scores + sizes.classes;
+    for (Batch& batch : mBatches)
+    {
+        batch.boxes.resize(mMaxBatchSize * mNumBoxElements * mElementSize);
+        batch.scores.resize(mMaxBatchSize * mNumScoreElements * mElementSize);
+        batch.keypoints.resize(mMaxBatchSize * mNumKeypointElements * mElementSize);
+        batch.outputs.resize(mMaxBatchSize * frameOutputSize);
+        batch.workspace.resize(EfficientPoseNMSHostWorkspaceSize(mMaxBatchSize, static_cast<int32_t>(mNumScoreElements),
+            mParam.numClasses, mParam.datatype, mNumKeypointElements > 0 ? mParam.numKeypoints : 0));
+        batch.requests.resize(mMaxBatchSize);
+    }
+    mOpenBatch = &mBatches[0];
+    mFreeBatch = &mBatches[1];
+    mDispatcher = std::thread(&EfficientPoseNMSHostBatcher::dispatchLoop, this);
+}
+
+EfficientPoseNMSHostBatcher::~EfficientPoseNMSHostBatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mChanged.notify_all();
+    mDispatcher.join();
+}
+
+std::future<pluginStatus_t> EfficientPoseNMSHostBatcher::submit(EfficientPoseNMSHostFrame const& frame)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    // Both batches may be busy, one running and the other full and waiting for it.
+    mChanged.wait(lock, [this] { return mOpenBatch != nullptr && mOpenBatch->numReserved < mMaxBatchSize; });
+    Batch& batch = *mOpenBatch;
+    int32_t const slot = batch.numReserved++;
+    auto const now = std::chrono::steady_clock::now();
+    auto const deadline = now + frame.maxDelay;
+    if (slot == 0 || deadline < batch.deadline)
+    {
+        batch.deadline = deadline;
+    }
+    Request& request = batch.requests[slot];
+    request.frame = frame;
+    request.submitTime = now;
+    request.promise = std::promise<pluginStatus_t>();
+    std::future<pluginStatus_t> result = request.promise.get_future();
+    lock.unlock();
+    mChanged.notify_all();
+
+    // The batch can not run before its reserved slots are filled, so the inputs are copied without the lock, and
+    // producers copy in parallel.
+    size_t const boxesSize = mNumBoxElements * mElementSize;
+    size_t const scoresSize = mNumScoreElements * mElementSize;
+    size_t const keypointsSize = mNumKeypointElements * mElementSize;
+    std::memcpy(batch.boxes.data() + slot * boxesSize, frame.boxesInput, boxesSize);
+    std::memcpy(batch.scores.data() + slot * scoresSize, frame.scoresInput, scoresSize);
+    if (keypointsSize > 0)
+    {
+        std::memcpy(batch.keypoints.data() + slot * keypointsSize, frame.keypointsInput, keypointsSize);
+    }
+
+    lock.lock();
+    batch.numFilled++;
+    lock.unlock();
+    mChanged.notify_all();
+    return result;
+}
+
+EfficientPoseNMSHostBatcherStats EfficientPoseNMSHostBatcher::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void EfficientPoseNMSHostBatcher::dispatchLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        Batch* batch = mOpenBatch;
+        if (batch == nullptr || batch->numReserved == 0)
+        {
+            if (mStop)
+            {
+                break;
+            }
+            mChanged.wait(lock);
+            continue;
+        }
+        // Pending frames are run right away when stopping.
+        if (batch->numReserved < mMaxBatchSize && !mStop && std::chrono::steady_clock::now() < batch->deadline)
+        {
+            mChanged.wait_until(lock, batch->deadline);
+            continue;
+        }
+
+        // Close the batch, so that new frames go to the other one, and wait for the inputs of its last frames.
+        mOpenBatch = mFreeBatch;
+        mFreeBatch = nullptr;
+        mChanged.notify_all();
+        mChanged.wait(lock, [batch] { return batch->numFilled == batch->numReserved; });
+
+        auto const start = std::chrono::steady_clock::now();
+        mStats.numBatches++;
+        mStats.numFrames += batch->numReserved;
+        mStats.numFullBatches += batch->numReserved == mMaxBatchSize ? 1 : 0;
+        for (int32_t slot = 0; slot < batch->numReserved; slot++)
+        {
+            auto const queued = start - batch->requests[slot].submitTime;
+            int64_t const delay = std::chrono::duration_cast<std::chrono::nanoseconds>(queued).count();
+            mStats.totalQueueDelay += delay;
+            mStats.maxQueueDelay = std::max(mStats.maxQueueDelay, delay);
+        }
+        lock.unlock();
+
+        run(*batch);
+
+        lock.lock();
+        batch->numReserved = 0;
+        batch->numFilled = 0;
+        if (mOpenBatch == nullptr)
+        {
+            mOpenBatch = batch;
+            mChanged.notify_all();
+        }
+        else
+        {
+            mFreeBatch = batch;
+        }
+    }
+}
+
+void EfficientPoseNMSHostBatcher::run(Batch& batch)
+{
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHostBatcher::run");
+    int32_t const batchSize = batch.numReserved;
+    EfficientPoseNMSParameters param = mParam;
+    param.batchSize = batchSize;
+
+    // The batch outputs are laid out for the largest batch, so that each output starts at a fixed offset.
+    FrameOutputSizes const sizes = getFrameOutputSizes(mParam);
+    char* numDetections = batch.outputs.data();
+    char* nmsBoxes = numDetections + mMaxBatchSize * sizes.numDetections;
+    char* nmsKpts = nmsBoxes + mMaxBatchSize * sizes.boxes;
+    char* nmsScores = nmsKpts + mMaxBatchSize * sizes.keypoints;
+    char* nmsClasses = nmsScores + mMaxBatchSize * sizes.scores;
+    pluginStatus_t status = EfficientPoseNMSHostInference(param, batch.boxes.data(), batch.scores.data(),
+        mAnchorsInput, mNumKeypointElements > 0 ? batch.keypoints.data() : nullptr, numDetections, nmsBoxes,
+        param.packedOutput ? nullptr : nmsKpts, param.packedOutput ? nullptr : nmsScores,
+        param.packedOutput ? nullptr : nmsClasses, nullptr, nullptr, batch.workspace.data(), mExecutor);
+
+    // Scatter the results back to each frame.
+    for (int32_t slot = 0; slot < batchSize; slot++)
+    {
+        Request& request = batch.requests[slot];
+        EfficientPoseNMSHostFrame const& frame = request.frame;
+        if (status == STATUS_SUCCESS)
+        {
+            std::memcpy(frame.numDetectionsOutput, numDetections + slot * sizes.numDetections, sizes.numDetections);
+            std::memcpy(frame.nmsBoxesOutput, nmsBoxes + slot * sizes.boxes, sizes.boxes);
+            if (!param.packedOutput)
+            {
+                std::memcpy(frame.nmsKptsOutput, nmsKpts + slot * sizes.keypoints, sizes.keypoints);
+                std::memcpy(frame.nmsScoresOutput, nmsScores + slot * sizes.scores, sizes.scores);
+                std::memcpy(frame.nmsClassesOutput, nmsClasses + slot * sizes.classes, sizes.classes);
+            }
+        }
+        request.promise.set_value(status);
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HOST_BATCHER_H
+#define TRT_EFFICIENT_POSE_NMS_HOST_BATCHER_H
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSParameters.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// One single image request to EfficientPoseNMSHostBatcher. The inputs are those of one image, [numAnchors, 4] boxes,
+// [numAnchors, numClasses] scores and, with OKS suppression only, [numAnchors, numKeypoints * 3] keypoints, all of
+// the datatype of the parameters, and the outputs are those of one image of EfficientPoseNMSHostInference. With
+// packedOutput, the packed detections go to nmsBoxesOutput, and the keypoints, scores and classes outputs are unused.
+// With classMajorOutput, numDetectionsOutput holds the numClasses per class counts.
+struct EfficientPoseNMSHostFrame
+{
+    void const* boxesInput{nullptr};
+    void const* scoresInput{nullptr};
+    void const* keypointsInput{nullptr};
+    void* numDetectionsOutput{nullptr};
+    void* nmsBoxesOutput{nullptr};
+    void* nmsKptsOutput{nullptr};
+    void* nmsScoresOutput{nullptr};
+    void* nmsClassesOutput{nullptr};
+    // The batch the frame joins is run at the latest this long after the frame is submitted.
+    std::chrono::microseconds maxDelay{1000};
+};
+
+struct EfficientPoseNMSHostBatcherStats
+{
+    int64_t numBatches{0};
+    int64_t numFrames{0};
+    // Number of batches that were run because they were full, the others were run on a deadline.
+    int64_t numFullBatches{0};
+    // Queueing delay of the frames, from their submission to the start of their batch, in nanoseconds.
+    int64_t totalQueueDelay{0};
+    int64_t maxQueueDelay{0};
+
+    // Average fraction of the maximum batch size that the batches were filled to.
+    double batchFillRate(int32_t maxBatchSize) const
+    {
+        return numBatches > 0 ? static_cast<double>(numFrames) / (static_cast<double>(numBatches) * maxBatchSize) : 0.;
+    }
+};
+
+// Collects single image requests from any number of producer threads into batches for EfficientPoseNMSHostInference.
+// A batch is run as soon as it holds maxBatchSize frames, or once the deadline of any of its frames is reached, on a
+// dispatcher thread owned by the batcher, and its results are then copied out to the outputs of each frame.
+//
+// Producers copy their inputs into the batch being collected themselves, while the previous batch runs. The standard,
+// packed and class major outputs are supported; compactOutput and outputONNXIndices are ignored, as each frame gets its
+// own outputs.
+class EfficientPoseNMSHostBatcher
+{
+public:
+    // The parameters are those of one image, with the shapes already configured. The anchors, if any, are shared by
+    // all images. The executor, if any, runs the batched calls.
+    EfficientPoseNMSHostBatcher(EfficientPoseNMSParameters const& param, int32_t maxBatchSize,
+        void const* anchorsInput = nullptr, EfficientPoseNMSHostExecutor* executor = nullptr);
+    // Runs the frames that are still pending before returning.
+    ~EfficientPoseNMSHostBatcher();
+
+    EfficientPoseNMSHostBatcher(EfficientPoseNMSHostBatcher const&) = delete;
+    EfficientPoseNMSHostBatcher& operator=(EfficientPoseNMSHostBatcher const&) = delete;
+
+    // Queues a frame, and returns once its inputs have been copied. The future is set to the status of the batched
+    // call once the outputs of the frame are written. Thread safe.
+    std::future<pluginStatus_t> submit(EfficientPoseNMSHostFrame const& frame);
+
+    EfficientPoseNMSHostBatcherStats getStats() const;
+
+private:
+    struct Request
+    {
+        EfficientPoseNMSHostFrame frame;
+        std::chrono::steady_clock::time_point submitTime;
+        std::promise<pluginStatus_t> promise;
+    };
+
+    struct Batch
+    {
+        std::vector<char> boxes;
+        std::vector<char> scores;
+        std::vector<char> keypoints;
+        std::vector<char> outputs;
+        std::vector<char> workspace;
+        std::vector<Request> requests;
+        // Frames that hold a slot of the batch, and frames whose inputs have been copied into their slot.
+        int32_t numReserved{0};
+        int32_t numFilled{0};
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void dispatchLoop();
+    void run(Batch& batch);
+
+    EfficientPoseNMSParameters mParam;
+    int32_t mMaxBatchSize;
+    void const* mAnchorsInput;
+    EfficientPoseNMSHostExecutor* mExecutor;
+    size_t mElementSize;
+    size_t mNumBoxElements;
+    size_t mNumScoreElements;
+    size_t mNumKeypointElements;
+
+    // One batch is collected while the other runs. Everything below is guarded by mMutex.
+    Batch mBatches[2];
+    Batch* mOpenBatch;
+    Batch* mFreeBatch{nullptr};
+    EfficientPoseNMSHostBatcherStats mStats;
+    bool mStop{false};
+    mutable std::mutex mMutex;
+    // Signalled when the open batch changes state: a frame is reserved or filled, or a new batch is opened.
+    std::condition_variable mChanged;
+    std::thread mDispatcher;
+};
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
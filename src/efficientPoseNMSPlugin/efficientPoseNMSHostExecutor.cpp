@@ -0,0 +1,267 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "efficientPoseNMSHostExecutor.h"
+
+using nvinfer1::plugin::EfficientPoseNMSHostExecutor;
+
+namespace
+{
+size_t const kAllocationAlignment = 2 << 20;
+
+#ifdef __linux__
+bool pinThread(pthread_t thread, std::vector<int32_t> const& cpus)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int32_t cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    return CPU_COUNT(&cpuSet) > 0 && pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+}
+#endif
+} // namespace
+
+struct EfficientPoseNMSHostExecutor::Job
+{
+    std::function<void(int32_t)> const* task;
+    int32_t numTasks;
+    std::atomic<int32_t> next{0};
+    // Number of workers currently running tasks of this job, guarded by mMutex. The job lives on the stack of the
+    // parallelFor() caller, which must not return while any worker still holds a pointer to it.
+    int32_t activeWorkers{0};
+};
+
+EfficientPoseNMSHostExecutor::EfficientPoseNMSHostExecutor(int32_t numWorkers)
+{
+    for (int32_t i = 0; i < numWorkers; i++)
+    {
+        mWorkers.emplace_back(&EfficientPoseNMSHostExecutor::workerLoop, this);
+    }
+}
+
+EfficientPoseNMSHostExecutor::EfficientPoseNMSHostExecutor(int32_t numWorkers, std::vector<int32_t> const& cpus)
+    : EfficientPoseNMSHostExecutor(numWorkers)
+{
+#ifdef __linux__
+    for (size_t i = 0; i < mWorkers.size() && !cpus.empty(); i++)
+    {
+        pinThread(mWorkers[i].native_handle(), {cpus[i % cpus.size()]});
+    }
+#endif
+}
+
+EfficientPoseNMSHostExecutor::~EfficientPoseNMSHostExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+int32_t EfficientPoseNMSHostExecutor::getNbWorkers() const noexcept
+{
+    return static_cast<int32_t>(mWorkers.size());
+}
+
+void EfficientPoseNMSHostExecutor::runJob(Job& job)
+{
+    int32_t idx;
+    while ((idx = job.next.fetch_add(1)) < job.numTasks)
+    {
+        (*job.task)(idx);
+    }
+}
+
+void EfficientPoseNMSHostExecutor::parallelFor(int32_t numTasks, std::function<void(int32_t)> const& task)
+{
+    if (mWorkers.empty() || numTasks <= 1)
+    {
+        for (int32_t idx = 0; idx < numTasks; idx++)
+        {
+            task(idx);
+        }
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.numTasks = numTasks;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(&job);
+    }
+    mWake.notify_all();
+
+    runJob(job);
+
+    // All tasks have been claimed at this point, wait for the workers that are still running some of them.
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto it = std::find(mJobs.begin(), mJobs.end(), &job);
+    if (it != mJobs.end())
+    {
+        mJobs.erase(it);
+    }
+    mDone.wait(lock, [&job] { return job.activeWorkers == 0; });
+}
+
+void* EfficientPoseNMSHostExecutor::allocate(size_t size, bool hugePages)
+{
+    size = (size + kAllocationAlignment - 1) / kAllocationAlignment * kAllocationAlignment;
+    if (size == 0)
+    {
+        return nullptr;
+    }
+#ifdef __linux__
+    void* buffer = MAP_FAILED;
+    if (hugePages)
+    {
+        buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (buffer == MAP_FAILED)
+    {
+        buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        if (hugePages)
+        {
+            madvise(buffer, size, MADV_HUGEPAGE);
+        }
+    }
+#else
+    void* buffer = std::malloc(size);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+#endif
+
+    // First touch, in chunks of the allocation alignment, which is also the huge page size.
+    char* bytes = static_cast<char*>(buffer);
+    parallelFor(static_cast<int32_t>(size / kAllocationAlignment),
+        [bytes](int32_t idx) { std::memset(bytes + idx * kAllocationAlignment, 0, kAllocationAlignment); });
+    return buffer;
+}
+
+void EfficientPoseNMSHostExecutor::deallocate(void* buffer, size_t size) noexcept
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+#ifdef __linux__
+    munmap(buffer, (size + kAllocationAlignment - 1) / kAllocationAlignment * kAllocationAlignment);
+#else
+    std::free(buffer);
+#endif
+}
+
+std::vector<int32_t> EfficientPoseNMSHostExecutor::getNodeCpus(int32_t node)
+{
+    // The node CPUs are listed as comma separated ranges, such as "0-15,32-47".
+    std::vector<int32_t> cpus;
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr)
+    {
+        return cpus;
+    }
+    int32_t first;
+    while (std::fscanf(file, "%d", &first) == 1)
+    {
+        int32_t last = first;
+        int32_t separator = std::fgetc(file);
+        if (separator == '-')
+        {
+            if (std::fscanf(file, "%d", &last) != 1)
+            {
+                break;
+            }
+            separator = std::fgetc(file);
+        }
+        for (int32_t cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+        if (separator != ',')
+        {
+            break;
+        }
+    }
+    std::fclose(file);
+    return cpus;
+}
+
+bool EfficientPoseNMSHostExecutor::pinCurrentThread(std::vector<int32_t> const& cpus)
+{
+#ifdef __linux__
+    return pinThread(pthread_self(), cpus);
+#else
+    return false;
+#endif
+}
+
+void EfficientPoseNMSHostExecutor::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mWake.wait(lock, [this] { return mStop || !mJobs.empty(); });
+        if (mStop)
+        {
+            return;
+        }
+        Job* job = mJobs.front();
+        if (job->next.load() >= job->numTasks)
+        {
+            mJobs.pop_front();
+            continue;
+        }
+        job->activeWorkers++;
+        lock.unlock();
+        runJob(*job);
+        lock.lock();
+        if (--job->activeWorkers == 0)
+        {
+            mDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HOST_EXECUTOR_H
+#define TRT_EFFICIENT_POSE_NMS_HOST_EXECUTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// Runs the parallel stages of the host NMS implementation on a fixed set of worker threads. The calling thread
+// takes part in the work too, so an executor without workers runs everything inline. Several threads may call
+// parallelFor() on the same executor at the same time.
+//
+// The workers can be pinned to a set of CPUs, such as those of one NUMA node (see getNodeCpus()). Pinning is only
+// supported on Linux, and is best effort: a worker that can not be pinned runs wherever the scheduler puts it.
+class EfficientPoseNMSHostExecutor
+{
+public:
+    explicit EfficientPoseNMSHostExecutor(int32_t numWorkers);
+    // Worker i is pinned to cpus[i % cpus.size()], or left unpinned if cpus is empty.
+    EfficientPoseNMSHostExecutor(int32_t numWorkers, std::vector<int32_t> const& cpus);
+    ~EfficientPoseNMSHostExecutor();
+
+    EfficientPoseNMSHostExecutor(EfficientPoseNMSHostExecutor const&) = delete;
+    EfficientPoseNMSHostExecutor& operator=(EfficientPoseNMSHostExecutor const&) = delete;
+
+    int32_t getNbWorkers() const noexcept;
+
+    // Calls task(i) for every i in [0, numTasks), and returns once all of them have completed.
+    void parallelFor(int32_t numTasks, std::function<void(int32_t)> const& task);
+
+    // Allocates host memory for the inputs, outputs and workspace of calls run on this executor. The memory is
+    // zeroed by the executor threads, so with the default (first touch) NUMA policy, its pages are placed on the
+    // nodes of those threads. As the calling thread takes part in that too, it should also be pinned (see
+    // pinCurrentThread()) for all the pages to be node local. With hugePages, 2 MiB pages are requested, falling back
+    // to transparent huge pages when none are reserved. Sizes are rounded up to a multiple of 2 MiB.
+    void* allocate(size_t size, bool hugePages = false);
+    static void deallocate(void* buffer, size_t size) noexcept;
+
+    // Returns the CPUs of a NUMA node, or an empty list if the system does not report them.
+    static std::vector<int32_t> getNodeCpus(int32_t node);
+
+    // Pins the calling thread to the given CPUs. Returns false if that is not supported or fails.
+    static bool pinCurrentThread(std::vector<int32_t> const& cpus);
+
+private:
+    struct Job;
+
+    void workerLoop();
+    static void runJob(Job& job);
+
+    std::vector<std::thread> mWorkers;
+    std::deque<Job*> mJobs;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    bool mStop{false};
+};
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
@@ -0,0 +1,2080 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "efficientPoseNMSHostInference.h"
+#include "efficientPoseNMSIndexing.h"
+#include "efficientPoseNMSPacked.h"
+#include "efficientPoseNMSTrace.h"
+
+using namespace nvinfer1;
+using namespace nvinfer1::plugin;
+
+namespace
+{
+
+// Storage of an fp16 input or output element, the host counterpart of __half. Values are only ever widened to fp32,
+// and fp16 arithmetic is emulated by rounding the fp32 result back to fp16, which is exact for a single addition,
+// subtraction or multiplication.
+struct HostHalf
+{
+    uint16_t bits;
+};
+
+float HostHalfToFloat(uint16_t h)
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(h);
+#else
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000U) << 16;
+    uint32_t exponent = (h >> 10) & 0x1FU;
+    uint32_t mantissa = h & 0x3FFU;
+    float value;
+    if (exponent == 0)
+    {
+        // Zero or subnormal, mantissa * 2^-24.
+        value = static_cast<float>(mantissa) * (1.f / 16777216.f);
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits |= sign;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    uint32_t bits = sign | (exponent == 0x1FU ? 0x7F800000U : (exponent + 112) << 23) | (mantissa << 13);
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+#endif
+}
+
+uint16_t HostFloatToHalf(float f)
+{
+    // Rounds to nearest even, same as __float2half.
+#if defined(__F16C__)
+    return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000U;
+    uint32_t magnitude = bits & 0x7FFFFFFFU;
+    if (magnitude > 0x7F800000U)
+    {
+        return static_cast<uint16_t>(sign | 0x7E00U);
+    }
+    if (magnitude >= 0x477FF000U)
+    {
+        // At least halfway between the largest half and 2^16, or infinite.
+        return static_cast<uint16_t>(sign | 0x7C00U);
+    }
+    if (magnitude < 0x38800000U)
+    {
+        // Below the smallest normal half, counted in steps of 2^-24. The scaling is exact.
+        float scaled;
+        std::memcpy(&scaled, &magnitude, sizeof(scaled));
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(scaled * 16777216.f)));
+    }
+    uint32_t h = (magnitude >> 13) - (112U << 10);
+    uint32_t rest = magnitude & 0x1FFFU;
+    if (rest > 0x1000U || (rest == 0x1000U && (h & 1U)))
+    {
+        h++;
+    }
+    return static_cast<uint16_t>(sign | h);
+#endif
+}
+
+// Loads and stores of the input and output elements, and rounding of fp32 results to the precision of the inputs.
+float HostLoad(float const* data, size_t idx)
+{
+    return data[idx];
+}
+
+float HostLoad(HostHalf const* data, size_t idx)
+{
+    return HostHalfToFloat(data[idx].bits);
+}
+
+void HostStore(float* data, size_t idx, float value)
+{
+    data[idx] = value;
+}
+
+void HostStore(HostHalf* data, size_t idx, float value)
+{
+    data[idx].bits = HostFloatToHalf(value);
+}
+
+template <typename T>
+float HostRound(float value);
+
+template <>
+float HostRound<float>(float value)
+{
+    return value;
+}
+
+template <>
+float HostRound<HostHalf>(float value)
+{
+#if !defined(__F16C__)
+    // Values within the normal fp16 range only need their mantissa rounded to 10 bits, to nearest even, which the
+    // carry takes into the exponent when needed.
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t magnitude = bits & 0x7FFFFFFFU;
+    if (magnitude >= 0x38800000U && magnitude < 0x477FF000U)
+    {
+        bits = (bits + 0xFFFU + ((bits >> 13) & 1U)) & ~0x1FFFU;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+#endif
+    return HostHalfToFloat(HostFloatToHalf(value));
+}
+
+// Four consecutive elements, such as the coordinates of a box, converted at once where F16C is available.
+void HostLoad4(float const* data, float* values)
+{
+    std::memcpy(values, data, 4 * sizeof(float));
+}
+
+void HostLoad4(HostHalf const* data, float* values)
+{
+#if defined(__F16C__)
+    _mm_storeu_ps(values, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(data))));
+#else
+    for (int32_t i = 0; i < 4; i++)
+    {
+        values[i] = HostHalfToFloat(data[i].bits);
+    }
+#endif
+}
+
+void HostStore4(float* data, float const* values)
+{
+    std::memcpy(data, values, 4 * sizeof(float));
+}
+
+void HostStore4(HostHalf* data, float const* values)
+{
+#if defined(__F16C__)
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(data), _mm_cvtps_ph(_mm_loadu_ps(values), _MM_FROUND_TO_NEAREST_INT));
+#else
+    for (int32_t i = 0; i < 4; i++)
+    {
+        data[i].bits = HostFloatToHalf(values[i]);
+    }
+#endif
+}
+
+struct HostBoxCorner
+{
+    // For NMS/IOU purposes, YXYX coding is identical to XYXY
+    float y1, x1, y2, x2;
+
+    void reorder()
+    {
+        if (y1 > y2)
+        {
+            std::swap(y1, y2);
+        }
+        if (x1 > x2)
+        {
+            std::swap(x1, x2);
+        }
+    }
+
+    HostBoxCorner clip(float low, float high) const
+    {
+        return {std::min(std::max(y1, low), high), std::min(std::max(x1, low), high),
+            std::min(std::max(y2, low), high), std::min(std::max(x2, low), high)};
+    }
+
+    // The width and height are rounded to the precision of T, as the device computes them in T.
+    template <typename T = float>
+    float area() const
+    {
+        float w = HostRound<T>(x2 - x1);
+        float h = HostRound<T>(y2 - y1);
+        if (h <= 0.f || w <= 0.f)
+        {
+            return 0.f;
+        }
+        return h * w;
+    }
+
+    static HostBoxCorner intersect(HostBoxCorner a, HostBoxCorner b)
+    {
+        return {std::max(a.y1, b.y1), std::max(a.x1, b.x1), std::min(a.y2, b.y2), std::min(a.x2, b.x2)};
+    }
+};
+
+struct HostCandidate
+{
+    // The score as compared by the filter and the sort, and the element index in the [numAnchors, numClasses] scores.
+    float score;
+    int32_t elementIdx;
+};
+
+struct HostKeptBox
+{
+    // A box that survived NMS. Boxes over the per class limit still suppress others, but are not written out. Each
+    // holds everything the sweep compares against, so that the kept boxes are streamed through without indirection.
+    HostBoxCorner box;
+    float area;
+    float score;
+    int32_t classIdx;
+    // The index of the box in the gathered candidates, which locates its keypoints for OKS suppression.
+    int32_t candidateIdx;
+};
+
+// The budget of the NMS sweep of each image, see EfficientPoseNMSParameters::maxIouTests and nmsTimeBudget.
+struct HostSweepBudget
+{
+    int32_t maxTests;
+    bool timed;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+struct HostRingOutput
+{
+    EfficientPoseNMSDetectionRing* ring;
+    int64_t firstFrameId;
+};
+
+struct HostInputChunk
+{
+    // The boxes, scores and keypoints inputs of the anchors [firstAnchor, firstAnchor + numAnchors) of every image,
+    // laid out as the full inputs would be with numAnchors anchors. The full inputs are a single chunk.
+    void const* boxes;
+    void const* scores;
+    void const* keypoints;
+    int32_t firstAnchor;
+    int32_t numAnchors;
+};
+
+template <typename T>
+float HostIOU(HostBoxCorner box1, float area1, HostBoxCorner box2, float area2)
+{
+    // Regardless of the selected box coding, IOU is always performed in BoxCorner coding. The areas are those of the
+    // reordered boxes, precomputed by EfficientPoseNMSHostGather.
+    box1.reorder();
+    box2.reorder();
+    float intersectArea = HostBoxCorner::intersect(box1, box2).area<T>();
+    if (intersectArea <= 0.f)
+    {
+        return 0.f;
+    }
+    float unionArea = area1 + area2 - intersectArea;
+    if (unionArea <= 0.f)
+    {
+        return 0.f;
+    }
+    return intersectArea / unionArea;
+}
+
+// Floats per coordinate in the gathered candidate keypoints, rounded up to whole SSE vectors. Each candidate holds
+// the y coordinates of its keypoints, then the x coordinates, then the visibility flags, padded with invisible
+// keypoints, so that the OKS loop never needs a remainder.
+int32_t HostKeypointStride(int32_t numKeypoints)
+{
+    return (numKeypoints + 3) / 4 * 4;
+}
+
+// exp(-x) for x >= 0, with the range reduction and polynomial of the Cephes expf, to within a few ulp. Arguments
+// past 87 (or NaN) are clamped there, where the result is already negligible. The SSE and scalar versions perform the
+// exact same operations.
+#if defined(__SSE2__)
+__m128 HostExpNeg(__m128 x)
+{
+    // minps returns its second operand when either is NaN.
+    x = _mm_sub_ps(_mm_setzero_ps(), _mm_min_ps(x, _mm_set1_ps(87.f)));
+    __m128 t = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)), _mm_set1_ps(0.5f));
+    // Floor, as truncation rounds the negative values up.
+    __m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+    n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, t), _mm_set1_ps(1.f)));
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
+    __m128 p = _mm_set1_ps(1.9875691500e-4f);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+    p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), r), _mm_set1_ps(1.f));
+    __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(bits));
+}
+#else
+float HostExpNeg(float x)
+{
+    x = -(!(x < 87.f) ? 87.f : x);
+    float n = std::floor(x * 1.44269504f + 0.5f);
+    float r = x - n * 0.693359375f;
+    r = r - n * -2.12194440e-4f;
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * (r * r) + r + 1.f;
+    // Scale by 2^n through the exponent bits, n is within [-126, 0].
+    int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+#endif
+
+float HostOKS(float const* keypoints1, float area1, float const* keypoints2, float area2, float const* weights,
+    int32_t stride)
+{
+    // Object keypoint similarity of two gathered candidates: the mean over the keypoints visible in both of
+    // exp(-d^2 / (2 s^2 k^2)), with s^2 the mean of the box areas and k = 2 sigma. The weights hold 1 / (2 k^2).
+    float const scale = 0.5f * (area1 + area2);
+    if (scale <= 0.f)
+    {
+        return 0.f;
+    }
+    float const invScale = 1.f / scale;
+    float similarity = 0.f;
+    float visible = 0.f;
+#if defined(__SSE2__)
+    __m128 similarity4 = _mm_setzero_ps();
+    __m128 visible4 = _mm_setzero_ps();
+    __m128 const invScale4 = _mm_set1_ps(invScale);
+    for (int32_t j = 0; j < stride; j += 4)
+    {
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(keypoints1 + j), _mm_loadu_ps(keypoints2 + j));
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(keypoints1 + stride + j), _mm_loadu_ps(keypoints2 + stride + j));
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(keypoints1 + 2 * stride + j), _mm_loadu_ps(keypoints2 + 2 * stride + j));
+        __m128 e = _mm_mul_ps(
+            _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dx, dx)), _mm_loadu_ps(weights + j)), invScale4);
+        similarity4 = _mm_add_ps(similarity4, _mm_mul_ps(v, HostExpNeg(e)));
+        visible4 = _mm_add_ps(visible4, v);
+    }
+    float lanes[8];
+    _mm_storeu_ps(lanes, similarity4);
+    _mm_storeu_ps(lanes + 4, visible4);
+    similarity = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    visible = (lanes[4] + lanes[5]) + (lanes[6] + lanes[7]);
+#else
+    for (int32_t j = 0; j < stride; j++)
+    {
+        float dy = keypoints1[j] - keypoints2[j];
+        float dx = keypoints1[stride + j] - keypoints2[stride + j];
+        float v = keypoints1[2 * stride + j] * keypoints2[2 * stride + j];
+        similarity += v * HostExpNeg((dy * dy + dx * dx) * weights[j] * invScale);
+        visible += v;
+    }
+#endif
+    return visible > 0.f ? similarity / visible : 0.f;
+}
+
+// The OKS weights 1 / (2 k^2) = 1 / (8 sigma^2) of HostOKS, padded with zeros to the keypoint stride, and all zeros
+// without OKS suppression. weights holds EFFICIENT_POSE_NMS_MAX_KEYPOINTS floats.
+void HostKeypointWeights(EfficientPoseNMSParameters const& param, float* weights)
+{
+    std::fill(weights, weights + EFFICIENT_POSE_NMS_MAX_KEYPOINTS, 0.f);
+    if (param.oksThreshold < 0.f)
+    {
+        return;
+    }
+    for (int32_t j = 0; j < param.numKeypoints; j++)
+    {
+        weights[j] = 1.f / (8.f * param.keypointSigmas[j] * param.keypointSigmas[j]);
+    }
+}
+
+template <typename T>
+HostBoxCorner HostDecodeBoxCoding(EfficientPoseNMSParameters const& param, T const* boxInput, T const* anchorInput)
+{
+    // Decodes the box with the anchor, if any, in the selected coding format. Every operation is rounded to the
+    // precision of T, in the same order as on the device.
+    float b[4];
+    float a[4];
+    HostLoad4(boxInput, b);
+    if (anchorInput != nullptr)
+    {
+        HostLoad4(anchorInput, a);
+    }
+    if (param.boxCoding == 0)
+    {
+        HostBoxCorner box{b[0], b[1], b[2], b[3]};
+        if (anchorInput == nullptr)
+        {
+            return box;
+        }
+        HostBoxCorner anchor{a[0], a[1], a[2], a[3]};
+        box.reorder();
+        anchor.reorder();
+        return {HostRound<T>(box.y1 + anchor.y1), HostRound<T>(box.x1 + anchor.x1), HostRound<T>(box.y2 + anchor.y2),
+            HostRound<T>(box.x2 + anchor.x2)};
+    }
+
+    // BoxCenterSize coding, YXHW is identical to XYWH for NMS/IOU purposes.
+    float y = b[0];
+    float x = b[1];
+    float h = b[2];
+    float w = b[3];
+    if (anchorInput != nullptr)
+    {
+        y = HostRound<T>(HostRound<T>(y * a[2]) + a[0]);
+        x = HostRound<T>(HostRound<T>(x * a[3]) + a[1]);
+        h = HostRound<T>(a[2] * HostRound<T>(std::exp(h)));
+        w = HostRound<T>(a[3] * HostRound<T>(std::exp(w)));
+    }
+    float h2 = HostRound<T>(h * 0.5f);
+    float w2 = HostRound<T>(w * 0.5f);
+    return {HostRound<T>(y - h2), HostRound<T>(x - w2), HostRound<T>(y + h2), HostRound<T>(x + w2)};
+}
+
+template <typename T>
+HostBoxCorner HostDecodeBox(EfficientPoseNMSParameters const& param, int32_t imageIdx, int32_t anchorIdx,
+    int32_t classIdx, HostInputChunk const& chunk, T const* anchorsInput)
+{
+    // Same indexing as MapNMSData on the device, see there for the input shapes. The boxes are indexed within the
+    // chunk of the anchor, and the anchors within the full anchors input.
+    int32_t tileAnchors = param.numAnchors / param.tilesPerImage;
+    size_t boxIdx
+        = EfficientPoseNMSBoxIndex(param, imageIdx, chunk.numAnchors, anchorIdx - chunk.firstAnchor, classIdx);
+    T const* a = nullptr;
+    if (param.boxDecoder)
+    {
+        size_t anchorOffset = static_cast<size_t>(imageIdx) * param.numAnchors + anchorIdx;
+        size_t anchorIdxMap = param.shareAnchors ? static_cast<size_t>(anchorIdx % tileAnchors) : anchorOffset;
+        a = anchorsInput + 4 * anchorIdxMap;
+    }
+    HostBoxCorner box = HostDecodeBoxCoding(param, static_cast<T const*>(chunk.boxes) + 4 * boxIdx, a);
+
+    // With tiled inference, map the box from the frame of its tile to the frame of the image.
+    if (param.tilesPerImage > 1)
+    {
+        float const* t = param.tileTransforms + 4 * (anchorIdx / tileAnchors);
+        // Computed in fp32, as the offsets of large images are beyond the precision of fp16.
+        box = {HostRound<T>(box.y1 * t[2] + t[0]), HostRound<T>(box.x1 * t[3] + t[1]),
+            HostRound<T>(box.y2 * t[2] + t[0]), HostRound<T>(box.x2 * t[3] + t[1])};
+    }
+    return box;
+}
+
+template <typename T>
+T* EfficientPoseNMSHostWorkspace(void* workspace, size_t& offset, size_t elements)
+{
+    T* buffer = (T*) ((size_t) workspace + offset);
+    size_t align = 256;
+    size_t size = elements * sizeof(T);
+    size_t sizeAligned = size + (size % align ? align - (size % align) : 0);
+    offset += sizeAligned;
+    return buffer;
+}
+
+uint32_t HostScoreBitsKey(float score, int32_t scoreBits)
+{
+    // Same key as the fp16 device path, where the score is incremented by one so that it is held by the mantissa of a
+    // half in [1, 2), and then only the top scoreBits bits of that mantissa are sorted on.
+    float mantissa = std::min(std::nearbyint(std::max(score, 0.f) * 1024.f), 1023.f);
+    return static_cast<uint32_t>(mantissa) >> (10 - scoreBits);
+}
+
+template <bool SingleClass>
+bool HostIsForeground(EfficientPoseNMSParameters const& param, int32_t elementIdx)
+{
+    // With a single class, the element index is the anchor, and the only class is either always or never background,
+    // which saves a division per score.
+    if (SingleClass)
+    {
+        return param.backgroundClass != 0;
+    }
+    return elementIdx % param.numClasses != param.backgroundClass;
+}
+
+// The score of a candidate that passed the threshold, as compared by the sort and written out.
+float HostCandidateScore(EfficientPoseNMSParameters const& /* param */, float score)
+{
+    return score;
+}
+
+float HostCandidateScore(EfficientPoseNMSParameters const& param, HostHalf score)
+{
+    // With score bits, the fp16 device path keeps the incremented score (see HostScoreBitsKey), and writes it out
+    // decremented again, which quantizes the score to steps of 1/1024.
+    float value = HostHalfToFloat(score.bits);
+    if (param.scoreBits <= 0)
+    {
+        return value;
+    }
+    value = std::min(HostRound<HostHalf>(value + 1.f), 2.f - 1.f / 1024.f);
+    return HostRound<HostHalf>(value - 1.f);
+}
+
+// Ordered integer key of an fp16 value: non NaN values compare as their keys do, and -0 equals +0.
+int16_t HostHalfKey(uint16_t h)
+{
+    int32_t magnitude = h & 0x7FFF;
+    return static_cast<int16_t>((h & 0x8000) ? -magnitude : magnitude);
+}
+
+// Selects the scores of the elements [firstElement, firstElement + numElements), held by scoresInput.
+template <bool SingleClass>
+int32_t HostSelectDense(EfficientPoseNMSParameters const& param, float const* scoresInput, int32_t firstElement,
+    int32_t numElements, float threshold, HostCandidate* selected)
+{
+    int32_t numSelected = 0;
+    for (int32_t idx = 0; idx < numElements; idx++)
+    {
+        float score = scoresInput[idx];
+        if (score >= threshold && HostIsForeground<SingleClass>(param, firstElement + idx))
+        {
+            selected[numSelected++] = {score, firstElement + idx};
+        }
+    }
+    return numSelected;
+}
+
+template <bool SingleClass>
+int32_t HostSelectDense(EfficientPoseNMSParameters const& param, HostHalf const* scoresInput, int32_t firstElement,
+    int32_t numElements, float threshold, HostCandidate* selected)
+{
+    // The threshold test runs on the fp16 bits, eight scores at a time, and only the scores that pass are widened.
+    int16_t const thresholdKey = HostHalfKey(HostFloatToHalf(threshold));
+    int32_t numSelected = 0;
+    auto select = [&](int32_t idx) {
+        if (HostIsForeground<SingleClass>(param, firstElement + idx))
+        {
+            selected[numSelected++] = {HostCandidateScore(param, scoresInput[idx]), firstElement + idx};
+        }
+    };
+    int32_t idx = 0;
+#if defined(__SSE2__)
+    __m128i const threshold8 = _mm_set1_epi16(thresholdKey);
+    __m128i const magnitudeMask = _mm_set1_epi16(0x7FFF);
+    __m128i const nanBound = _mm_set1_epi16(0x7C01);
+    for (; idx + 8 <= numElements; idx += 8)
+    {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(scoresInput + idx));
+        __m128i magnitude = _mm_and_si128(h, magnitudeMask);
+        __m128i sign = _mm_srai_epi16(h, 15);
+        __m128i key = _mm_sub_epi16(_mm_xor_si128(magnitude, sign), sign);
+        // Not below the threshold, and not NaN. The mask holds two bits per score.
+        __m128i pass = _mm_andnot_si128(_mm_cmplt_epi16(key, threshold8), _mm_cmplt_epi16(magnitude, nanBound));
+        for (int32_t mask = _mm_movemask_epi8(pass), lane = 0; mask != 0; mask >>= 2, lane++)
+        {
+            if (mask & 1)
+            {
+                select(idx + lane);
+            }
+        }
+    }
+#endif
+    for (; idx < numElements; idx++)
+    {
+        uint16_t h = scoresInput[idx].bits;
+        if ((h & 0x7FFF) <= 0x7C00 && HostHalfKey(h) >= thresholdKey)
+        {
+            select(idx);
+        }
+    }
+    return numSelected;
+}
+
+template <typename T, bool SingleClass>
+int32_t HostSelectCandidates(EfficientPoseNMSParameters const& param, T const* scoresInput, int32_t firstAnchor,
+    int32_t numAnchors, HostCandidate* selected)
+{
+    // Selects the unsorted candidates of the anchors [firstAnchor, firstAnchor + numAnchors) of an image, whose scores
+    // are held by scoresInput, in element order. The threshold is rounded to the precision of the scores, as the
+    // device compares them in that precision.
+    float const threshold = HostRound<T>(param.scoreThreshold);
+    int32_t numSelected = 0;
+    if (!SingleClass && param.classArgmax)
+    {
+        // Each anchor is reduced to its highest scoring (non background) class first, same as
+        // EfficientPoseNMSArgmaxFilter. Ties keep the lowest class.
+        for (int32_t anchorIdx = firstAnchor; anchorIdx < firstAnchor + numAnchors; anchorIdx++)
+        {
+            T const* anchorScores = scoresInput + static_cast<size_t>(anchorIdx - firstAnchor) * param.numClasses;
+            int32_t classIdx = -1;
+            float score = 0.f;
+            for (int32_t c = 0; c < param.numClasses; c++)
+            {
+                float classScore = HostLoad(anchorScores, c);
+                if (c != param.backgroundClass && (classIdx < 0 || classScore > score))
+                {
+                    classIdx = c;
+                    score = classScore;
+                }
+            }
+            if (classIdx >= 0 && score >= threshold)
+            {
+                selected[numSelected++]
+                    = {HostCandidateScore(param, anchorScores[classIdx]), anchorIdx * param.numClasses + classIdx};
+            }
+        }
+        return numSelected;
+    }
+    return HostSelectDense<SingleClass>(
+        param, scoresInput, firstAnchor * param.numClasses, numAnchors * param.numClasses, threshold, selected);
+}
+
+template <typename T>
+int32_t HostSelectSparse(EfficientPoseNMSParameters const& param, T const* scoresInput,
+    int32_t const* candidateIndicesInput, int32_t numListed, HostCandidate* selected)
+{
+    // Selects the listed candidates of an image, in list order, with the same tests as the dense selection. Listed
+    // candidates outside of the anchors or classes are dropped, same as EfficientPoseNMSSparseFilter.
+    float const threshold = HostRound<T>(param.scoreThreshold);
+    int32_t numSelected = 0;
+    for (int32_t idx = 0; idx < numListed; idx++)
+    {
+        int32_t anchorIdx = candidateIndicesInput[2 * idx];
+        int32_t classIdx = candidateIndicesInput[2 * idx + 1];
+        if (anchorIdx < 0 || anchorIdx >= param.numAnchors || classIdx < 0 || classIdx >= param.numClasses
+            || classIdx == param.backgroundClass || !(HostLoad(scoresInput, idx) >= threshold))
+        {
+            continue;
+        }
+        int32_t elementIdx = anchorIdx * param.numClasses + classIdx;
+        selected[numSelected++] = {HostCandidateScore(param, scoresInput[idx]), elementIdx};
+    }
+    return numSelected;
+}
+
+// Selects the candidates of an image with select, which writes them unsorted to the given buffer and returns their
+// number, and sorts them into candidates.
+template <typename Select>
+int32_t EfficientPoseNMSHostFilter(EfficientPoseNMSParameters const& param, Select&& select,
+    HostCandidate* candidates, HostCandidate* scratch, int32_t* histogram)
+{
+    if (param.scoreBits > 0)
+    {
+        // Counting sort on the score bits keys.
+        int32_t numBuckets = 1 << param.scoreBits;
+        std::fill(histogram, histogram + numBuckets, 0);
+        int32_t numCandidates = select(scratch);
+        for (int32_t idx = 0; idx < numCandidates; idx++)
+        {
+            histogram[HostScoreBitsKey(scratch[idx].score, param.scoreBits)]++;
+        }
+        int32_t offset = 0;
+        for (int32_t bucket = numBuckets - 1; bucket >= 0; bucket--)
+        {
+            int32_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+        for (int32_t idx = 0; idx < numCandidates; idx++)
+        {
+            candidates[histogram[HostScoreBitsKey(scratch[idx].score, param.scoreBits)]++] = scratch[idx];
+        }
+        return numCandidates;
+    }
+
+    int32_t numCandidates = select(candidates);
+
+    // Equal scores keep the element order, as the device radix sort does for the dense (unfiltered) inputs.
+    std::sort(candidates, candidates + numCandidates, [](HostCandidate const& a, HostCandidate const& b) {
+        return a.score > b.score || (a.score == b.score && a.elementIdx < b.elementIdx);
+    });
+    return numCandidates;
+}
+
+void EfficientPoseNMSHostPartition(EfficientPoseNMSParameters const& param, HostCandidate const* candidates,
+    int32_t numSelectedBoxes, int32_t* classOffsets, int32_t* partition)
+{
+    // Stable partition of the sorted candidates by class, so that every class segment is still sorted by score.
+    std::fill(classOffsets, classOffsets + param.numClasses + 1, 0);
+    for (int32_t idx = 0; idx < numSelectedBoxes; idx++)
+    {
+        classOffsets[candidates[idx].elementIdx % param.numClasses + 1]++;
+    }
+    for (int32_t classIdx = 0; classIdx < param.numClasses; classIdx++)
+    {
+        classOffsets[classIdx + 1] += classOffsets[classIdx];
+    }
+    // The class offsets are used as scatter cursors, and end up shifted by one class, which is then undone.
+    for (int32_t idx = 0; idx < numSelectedBoxes; idx++)
+    {
+        partition[classOffsets[candidates[idx].elementIdx % param.numClasses]++] = idx;
+    }
+    for (int32_t classIdx = param.numClasses; classIdx > 0; classIdx--)
+    {
+        classOffsets[classIdx] = classOffsets[classIdx - 1];
+    }
+    classOffsets[0] = 0;
+}
+
+HostInputChunk const& HostFindChunk(HostInputChunk const* chunks, int32_t numChunks, int32_t anchorIdx)
+{
+    // The chunk holding the anchor, the chunks being in anchor order.
+    return *(std::upper_bound(chunks, chunks + numChunks, anchorIdx,
+                 [](int32_t a, HostInputChunk const& c) { return a < c.firstAnchor; })
+        - 1);
+}
+
+template <typename T>
+void EfficientPoseNMSHostGatherKeypoints(EfficientPoseNMSParameters const& param, int32_t imageIdx, int32_t anchorIdx,
+    HostInputChunk const& chunk, float* candidateKeypoints)
+{
+    // Transposes the (y, x, confidence) triplets of the anchor into the layout of HostKeypointStride, mapped to the
+    // image frame with tiled inference, same as the boxes.
+    int32_t const stride = HostKeypointStride(param.numKeypoints);
+    size_t const chunkOffset = static_cast<size_t>(imageIdx) * chunk.numAnchors + (anchorIdx - chunk.firstAnchor);
+    T const* keypoints = static_cast<T const*>(chunk.keypoints) + chunkOffset * 3 * param.numKeypoints;
+    float const* t = nullptr;
+    if (param.tilesPerImage > 1)
+    {
+        t = param.tileTransforms + 4 * (anchorIdx / (param.numAnchors / param.tilesPerImage));
+    }
+    for (int32_t j = 0; j < stride; j++)
+    {
+        float y = 0.f;
+        float x = 0.f;
+        float visible = 0.f;
+        if (j < param.numKeypoints)
+        {
+            y = HostLoad(keypoints, 3 * j);
+            x = HostLoad(keypoints, 3 * j + 1);
+            y = t != nullptr ? y * t[2] + t[0] : y;
+            x = t != nullptr ? x * t[3] + t[1] : x;
+            visible = HostLoad(keypoints, 3 * j + 2) > 0.f ? 1.f : 0.f;
+        }
+        candidateKeypoints[j] = y;
+        candidateKeypoints[stride + j] = x;
+        candidateKeypoints[2 * stride + j] = visible;
+    }
+}
+
+template <typename T>
+void EfficientPoseNMSHostDecodeKeypoints(EfficientPoseNMSParameters const& param, int32_t imageIdx, int32_t anchorIdx,
+    HostInputChunk const* chunks, int32_t numChunks, float* keypoints)
+{
+    // The EfficientPoseNMSOutputKeypoints (y, x, confidence) keypoints of a written detection. These are read from the
+    // keypoints input, rather than from the gathered candidate keypoints, which only hold visibility flags, and are
+    // mapped to the image frame with tiled inference, same as the boxes. Without OKS suppression, there is no
+    // keypoints input, and the single keypoint is zero.
+    if (param.oksThreshold < 0.f)
+    {
+        keypoints[0] = 0.f;
+        keypoints[1] = 0.f;
+        keypoints[2] = 0.f;
+        return;
+    }
+    HostInputChunk const& chunk = HostFindChunk(chunks, numChunks, anchorIdx);
+    size_t const chunkOffset = static_cast<size_t>(imageIdx) * chunk.numAnchors + (anchorIdx - chunk.firstAnchor);
+    T const* input = static_cast<T const*>(chunk.keypoints) + chunkOffset * 3 * param.numKeypoints;
+    float const* t = nullptr;
+    if (param.tilesPerImage > 1)
+    {
+        t = param.tileTransforms + 4 * (anchorIdx / (param.numAnchors / param.tilesPerImage));
+    }
+    for (int32_t j = 0; j < param.numKeypoints; j++)
+    {
+        float const y = HostLoad(input, 3 * j);
+        float const x = HostLoad(input, 3 * j + 1);
+        keypoints[3 * j] = t != nullptr ? y * t[2] + t[0] : y;
+        keypoints[3 * j + 1] = t != nullptr ? x * t[3] + t[1] : x;
+        keypoints[3 * j + 2] = HostLoad(input, 3 * j + 2);
+    }
+}
+
+template <typename T>
+void EfficientPoseNMSHostGather(EfficientPoseNMSParameters const& param, int32_t imageIdx, HostInputChunk const* chunks,
+    int32_t numChunks, T const* anchorsInput, HostCandidate const* candidates, int32_t numSelectedBoxes,
+    HostBoxCorner* candidateBoxes, float* candidateAreas, int32_t* candidateClasses, int32_t* candidateAnchors,
+    float* candidateKeypoints)
+{
+    // Decodes each sorted candidate once, into buffers laid out in score order, same as EfficientPoseNMSGather on the
+    // device. The sweep and the writer then only read these, instead of decoding boxes from the inputs. The inputs of
+    // each candidate are read from the chunk holding its anchor, the chunks being in anchor order.
+    bool const singleClass = param.numClasses == 1;
+    for (int32_t idx = 0; idx < numSelectedBoxes; idx++)
+    {
+        int32_t classIdx = singleClass ? 0 : candidates[idx].elementIdx % param.numClasses;
+        int32_t anchorIdx = singleClass ? candidates[idx].elementIdx : candidates[idx].elementIdx / param.numClasses;
+        HostInputChunk const& chunk = HostFindChunk(chunks, numChunks, anchorIdx);
+        HostBoxCorner box = HostDecodeBox(param, imageIdx, anchorIdx, classIdx, chunk, anchorsInput);
+        HostBoxCorner reordered = box;
+        reordered.reorder();
+        candidateBoxes[idx] = box;
+        candidateAreas[idx] = reordered.area<T>();
+        candidateClasses[idx] = classIdx;
+        candidateAnchors[idx] = anchorIdx;
+        if (candidateKeypoints != nullptr)
+        {
+            EfficientPoseNMSHostGatherKeypoints<T>(param, imageIdx, anchorIdx, chunk,
+                candidateKeypoints + static_cast<size_t>(idx) * 3 * HostKeypointStride(param.numKeypoints));
+        }
+    }
+}
+
+template <typename T>
+int32_t EfficientPoseNMSHostSweep(EfficientPoseNMSParameters const& param, HostCandidate const* candidates,
+    HostBoxCorner const* candidateBoxes, float const* candidateAreas, int32_t const* candidateClasses,
+    float const* candidateKeypoints, float const* keypointWeights, int32_t const* order, int32_t numOrder,
+    HostKeptBox* kept, int32_t* classCounters, int32_t* selected, HostSweepBudget const& budget, int32_t* exhausted)
+{
+    // Greedy NMS over the sorted candidates. A candidate is kept unless a previously kept box of the same class
+    // (or any class, if class agnostic) overlaps it. This matches the tiled device kernel, where the lead thread
+    // of each iteration suppresses all remaining lower scoring boxes.
+    // The candidates are visited in the given order, or in sorted order if there is none. The indices of the boxes
+    // to write out are stored in selected, and their number is returned. With candidate keypoints, boxes that pass the
+    // IOU test are then tested on OKS.
+    // When the budget runs out, the sweep stops before the next candidate, and sets exhausted. The boxes selected so
+    // far are still exactly those a full sweep selects first. A candidate is only visited if the tests against all the
+    // kept boxes fit in the budget, and the clock is read about every 1024 tests or candidates.
+    int32_t const keypointStride = 3 * HostKeypointStride(param.numKeypoints);
+    int32_t numKept = 0;
+    int32_t numWritten = 0;
+    int64_t numTests = 0;
+    int64_t nextClockCheck = 0;
+    for (int32_t i = 0; i < numOrder; i++)
+    {
+        if (budget.maxTests > 0 && numTests + numKept > budget.maxTests)
+        {
+            *exhausted = 1;
+            break;
+        }
+        if (budget.timed && numTests + i >= nextClockCheck)
+        {
+            if (std::chrono::steady_clock::now() >= budget.deadline)
+            {
+                *exhausted = 1;
+                break;
+            }
+            nextClockCheck = numTests + i + 1024;
+        }
+        int32_t idx = order != nullptr ? order[i] : i;
+        int32_t classIdx = candidateClasses[idx];
+        if (order != nullptr && param.numOutputBoxesPerClass >= 0 && numWritten >= param.numOutputBoxesPerClass)
+        {
+            // The order only holds boxes of a single class, none of which could be written anymore.
+            break;
+        }
+        HostBoxCorner box = candidateBoxes[idx];
+        float area = candidateAreas[idx];
+        float score = candidates[idx].score;
+        float const* keypoints
+            = candidateKeypoints != nullptr ? candidateKeypoints + static_cast<size_t>(idx) * keypointStride : nullptr;
+
+        bool suppressed = false;
+        for (int32_t k = 0; k < numKept && !suppressed; k++)
+        {
+            // With score bits, candidates are only sorted on a quantized score, so the order check is still needed.
+            if ((param.classAgnostic || kept[k].classIdx == classIdx) && score <= kept[k].score)
+            {
+                numTests++;
+                suppressed = HostIOU<T>(box, area, kept[k].box, kept[k].area) >= param.iouThreshold
+                    || (keypoints != nullptr
+                        && HostOKS(keypoints, area,
+                               candidateKeypoints + static_cast<size_t>(kept[k].candidateIdx) * keypointStride,
+                               kept[k].area, keypointWeights, keypointStride / 3)
+                            >= param.oksThreshold);
+            }
+        }
+        if (suppressed)
+        {
+            continue;
+        }
+        if (numWritten >= param.numOutputBoxes)
+        {
+            break;
+        }
+
+        bool write = true;
+        if (param.numOutputBoxesPerClass >= 0)
+        {
+            write = (classCounters[classIdx] < param.numOutputBoxesPerClass);
+            classCounters[classIdx]++;
+        }
+        kept[numKept++] = {box, area, score, classIdx, idx};
+        if (write)
+        {
+            selected[numWritten++] = idx;
+        }
+    }
+    return numWritten;
+}
+
+template <typename T>
+float HostOutputScore(EfficientPoseNMSParameters const& param, float score)
+{
+    // The sigmoid is rounded to the precision of the outputs, as the device computes it in that precision.
+    return param.scoreSigmoid ? HostRound<T>(1.f / (1.f + std::exp(-score))) : score;
+}
+
+template <typename T>
+int32_t EfficientPoseNMSHostPublish(EfficientPoseNMSParameters const& param, HostRingOutput const& ringOutput,
+    HostInputChunk const* chunks, int32_t numChunks, int32_t const* numSelectedData,
+    HostCandidate const* candidatesData, HostBoxCorner const* candidateBoxesData, int32_t const* candidateClassesData,
+    int32_t const* candidateAnchorsData, int32_t const* selectedData)
+{
+    // Each frame is published as soon as it is written, so that the consumer can start on it while the next one is
+    // written. The free slots are only refreshed when a frame does not fit, as that loads the consumer position.
+    EfficientPoseNMSDetectionRing& ring = *ringOutput.ring;
+    size_t freeSlots = ring.freeSlots();
+    int32_t imageIdx = 0;
+    for (; imageIdx < param.batchSize; imageIdx++)
+    {
+        int32_t numSelected = numSelectedData != nullptr ? numSelectedData[imageIdx] : 0;
+        size_t numRecords = std::max(numSelected, 1);
+        if (numRecords > freeSlots)
+        {
+            freeSlots = ring.freeSlots();
+            if (numRecords > freeSlots)
+            {
+                break;
+            }
+        }
+
+        int64_t frameId = ringOutput.firstFrameId + imageIdx;
+        if (numSelected == 0)
+        {
+            EfficientPoseNMSDetection& detection = ring.freeSlot(0);
+            detection = EfficientPoseNMSDetection{};
+            detection.frameId = frameId;
+        }
+        size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+        for (int32_t k = 0; k < numSelected; k++)
+        {
+            int32_t idx = selectedData[imageOffset + k];
+            float score = candidatesData[imageOffset + idx].score;
+            HostBoxCorner box = candidateBoxesData[imageOffset + idx];
+            if (param.clipBoxes)
+            {
+                box = box.clip(0.f, 1.f);
+            }
+            EfficientPoseNMSDetection& detection = ring.freeSlot(k);
+            detection.frameId = frameId;
+            detection.box[0] = box.y1;
+            detection.box[1] = box.x1;
+            detection.box[2] = box.y2;
+            detection.box[3] = box.x2;
+            EfficientPoseNMSHostDecodeKeypoints<T>(
+                param, imageIdx, candidateAnchorsData[imageOffset + idx], chunks, numChunks, detection.keypoints);
+            detection.score = HostOutputScore<T>(param, score);
+            detection.classIdx = candidateClassesData[imageOffset + idx];
+            detection.detectionIdx = k;
+            detection.numDetections = numSelected;
+        }
+        ring.publish(numRecords);
+        freeSlots -= numRecords;
+    }
+    return imageIdx;
+}
+
+// The state of a streamed call, which the workspace starts with. The chunks are recorded as they are filtered, and
+// only read again by the gather and the writer, once all of them have been filtered.
+struct HostStreamState
+{
+    int32_t numChunks;
+    int32_t numAnchors;
+    int64_t filterTime;
+    HostInputChunk chunks[EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS];
+};
+
+size_t HostStreamStateSize()
+{
+    size_t const align = 256;
+    size_t const size = sizeof(HostStreamState);
+    return size + (size % align ? align - (size % align) : 0);
+}
+
+void EfficientPoseNMSHostParallelFor(
+    EfficientPoseNMSHostExecutor* executor, int32_t numTasks, std::function<void(int32_t)> const& task)
+{
+    if (executor != nullptr)
+    {
+        executor->parallelFor(numTasks, task);
+        return;
+    }
+    for (int32_t idx = 0; idx < numTasks; idx++)
+    {
+        task(idx);
+    }
+}
+
+} // namespace
+
+size_t EfficientPoseNMSHostWorkspaceSize(
+    int32_t batchSize, int32_t numScoreElements, int32_t numClasses, DataType /* datatype */, int32_t numKeypoints)
+{
+    size_t total = 0;
+    const size_t align = 256;
+    // Counters
+    // 4 for Candidates, Selected Boxes, Output Offsets and Filtered Candidates
+    // C for Max per Class Limiting
+    // C + 1 for Class Partition Offsets
+    // C for Selected Boxes per Class
+    // C for Exhausted NMS Budgets per Class
+    size_t size = (4 + 4 * numClasses + 1) * batchSize * sizeof(int32_t);
+    total += size + (size % align ? align - (size % align) : 0);
+    // Candidates
+    size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(HostCandidate);
+    total += size + (size % align ? align - (size % align) : 0);
+    // Kept Boxes
+    size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(HostKeptBox);
+    total += size + (size % align ? align - (size % align) : 0);
+    // Gathered Candidates: boxes, areas, classes and anchors
+    size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(HostBoxCorner);
+    total += size + (size % align ? align - (size % align) : 0);
+    for (int32_t i = 0; i < 3; i++)
+    {
+        size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(int32_t);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+    // Counting Sort Scratch and Histograms
+    size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(HostCandidate);
+    total += size + (size % align ? align - (size % align) : 0);
+    size = static_cast<size_t>(batchSize) * 1024 * sizeof(int32_t);
+    total += size + (size % align ? align - (size % align) : 0);
+    // Class Partition and Selected Boxes
+    for (int32_t i = 0; i < 2; i++)
+    {
+        size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(int32_t);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+    // Gathered Candidate Keypoints, only for OKS suppression
+    if (numKeypoints > 0)
+    {
+        size = static_cast<size_t>(batchSize) * numScoreElements * 3 * HostKeypointStride(numKeypoints) * sizeof(float);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+
+    return total;
+}
+
+size_t EfficientPoseNMSHostStreamWorkspaceSize(
+    int32_t batchSize, int32_t numScoreElements, int32_t numClasses, DataType datatype, int32_t numKeypoints)
+{
+    return HostStreamStateSize() + EfficientPoseNMSHostWorkspaceSize(batchSize, numScoreElements, numClasses, datatype,
+        numKeypoints);
+}
+
+size_t EfficientPoseNMSHostThresholdSweepWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    DataType datatype, int32_t numThresholds, int32_t numKeypoints)
+{
+    // The buffers of a single call, followed by those of the threshold sweep.
+    size_t total = EfficientPoseNMSHostWorkspaceSize(batchSize, numScoreElements, numClasses, datatype, numKeypoints);
+    const size_t align = 256;
+    // Eligible Pairs of the Candidates, and Pairs of the Kept Boxes
+    for (int32_t i = 0; i < 2; i++)
+    {
+        size_t size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(uint64_t);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+    // Kept Box Class Links, and Last Kept Box per Class
+    size_t size = static_cast<size_t>(batchSize) * numScoreElements * sizeof(int32_t);
+    total += size + (size % align ? align - (size % align) : 0);
+    size = static_cast<size_t>(batchSize) * numClasses * sizeof(int32_t);
+    total += size + (size % align ? align - (size % align) : 0);
+    // Written Boxes, and per Class Counters, of each Pair
+    size = static_cast<size_t>(batchSize) * numThresholds * (numClasses + 1) * sizeof(int32_t);
+    total += size + (size % align ? align - (size % align) : 0);
+    return total;
+}
+
+namespace
+{
+
+// Normalizes the parameters of a call, the same way for each of its stages.
+void EfficientPoseNMSHostPrepare(EfficientPoseNMSParameters& param)
+{
+    // As on the device, the score bits optimization only applies to fp16 inputs.
+    if (param.scoreBits <= 0 || param.scoreBits > 10 || param.scoreSigmoid || param.datatype == DataType::kFLOAT)
+    {
+        param.scoreBits = -1;
+    }
+    if (param.scoreSigmoid)
+    {
+        // Inverse Sigmoid, so that the raw scores can be compared directly
+        if (param.scoreThreshold <= 0.f)
+        {
+            param.scoreThreshold = -(1 << 15);
+        }
+        else
+        {
+            param.scoreThreshold = std::log(param.scoreThreshold / (1.f - param.scoreThreshold));
+        }
+    }
+}
+
+bool EfficientPoseNMSHostKeypointsValid(EfficientPoseNMSParameters const& param)
+{
+    return param.numKeypoints >= 1 && param.numKeypoints <= EFFICIENT_POSE_NMS_MAX_KEYPOINTS;
+}
+
+// The workspace buffers of a call, see EfficientPoseNMSHostWorkspaceSize for their sizes.
+struct HostBuffers
+{
+    int32_t* numCandidates;
+    int32_t* numSelected;
+    int32_t* outputOffsets;
+    int32_t* numFiltered;
+    int32_t* classCounters;
+    int32_t* classOffsets;
+    int32_t* classSelected;
+    int32_t* classExhausted;
+    HostCandidate* candidates;
+    HostKeptBox* kept;
+    HostBoxCorner* candidateBoxes;
+    float* candidateAreas;
+    int32_t* candidateClasses;
+    int32_t* candidateAnchors;
+    HostCandidate* scratch;
+    int32_t* histogram;
+    int32_t* partition;
+    int32_t* selected;
+    float* candidateKeypoints;
+};
+
+HostBuffers EfficientPoseNMSHostCarve(EfficientPoseNMSParameters const& param, void* workspace)
+{
+    HostBuffers b;
+    size_t workspaceOffset = 0;
+    int32_t const countersTotalSize = (4 + 4 * param.numClasses + 1) * param.batchSize;
+    b.numCandidates = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, countersTotalSize);
+    b.numSelected = b.numCandidates + param.batchSize;
+    b.outputOffsets = b.numCandidates + 2 * param.batchSize;
+    b.numFiltered = b.numCandidates + 3 * param.batchSize;
+    b.classCounters = b.numCandidates + 4 * param.batchSize;
+    b.classOffsets = b.classCounters + param.batchSize * param.numClasses;
+    b.classSelected = b.classOffsets + param.batchSize * (param.numClasses + 1);
+    b.classExhausted = b.classSelected + param.batchSize * param.numClasses;
+    size_t const numBatchElements = static_cast<size_t>(param.batchSize) * param.numScoreElements;
+    b.candidates = EfficientPoseNMSHostWorkspace<HostCandidate>(workspace, workspaceOffset, numBatchElements);
+    b.kept = EfficientPoseNMSHostWorkspace<HostKeptBox>(workspace, workspaceOffset, numBatchElements);
+    b.candidateBoxes = EfficientPoseNMSHostWorkspace<HostBoxCorner>(workspace, workspaceOffset, numBatchElements);
+    b.candidateAreas = EfficientPoseNMSHostWorkspace<float>(workspace, workspaceOffset, numBatchElements);
+    b.candidateClasses = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, numBatchElements);
+    b.candidateAnchors = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, numBatchElements);
+    b.scratch = EfficientPoseNMSHostWorkspace<HostCandidate>(workspace, workspaceOffset, numBatchElements);
+    b.histogram = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, param.batchSize * 1024);
+    b.partition = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, numBatchElements);
+    b.selected = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, numBatchElements);
+    b.candidateKeypoints = nullptr;
+    if (param.oksThreshold >= 0.f)
+    {
+        b.candidateKeypoints = EfficientPoseNMSHostWorkspace<float>(
+            workspace, workspaceOffset, numBatchElements * 3 * HostKeypointStride(param.numKeypoints));
+    }
+    return b;
+}
+
+// Filters and sorts the candidates of a chunk of anchors of every image, and merges them into the sorted candidates of
+// the earlier chunks, which are then limited to numSelectedBoxes again. As the chunks come in anchor order, and the
+// merge is stable, the result is the same as if all the anchors had been filtered and sorted at once.
+template <typename T>
+void EfficientPoseNMSHostFilterChunk(EfficientPoseNMSParameters const& param, HostBuffers const& buffers,
+    HostInputChunk const& chunk, EfficientPoseNMSHostExecutor* executor)
+{
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::filter");
+        size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+        T const* scores = static_cast<T const*>(chunk.scores)
+            + static_cast<size_t>(imageIdx) * chunk.numAnchors * param.numClasses;
+        HostCandidate* candidates = buffers.candidates + imageOffset;
+        HostCandidate* scratch = buffers.scratch + imageOffset;
+        int32_t* histogram = buffers.histogram + imageIdx * 1024;
+        int32_t numSorted = buffers.numCandidates[imageIdx];
+        int32_t numChunkCandidates = EfficientPoseNMSHostFilter(
+            param,
+            [&](HostCandidate* selected) {
+                return param.numClasses == 1
+                    ? HostSelectCandidates<T, true>(param, scores, chunk.firstAnchor, chunk.numAnchors, selected)
+                    : HostSelectCandidates<T, false>(param, scores, chunk.firstAnchor, chunk.numAnchors, selected);
+            },
+            candidates + numSorted, scratch + numSorted, histogram);
+        buffers.numFiltered[imageIdx] += numChunkCandidates;
+        int32_t numCandidates = numSorted + numChunkCandidates;
+        if (numSorted > 0 && numChunkCandidates > 0)
+        {
+            // With score bits, the candidates are only ordered by their keys, and then by element.
+            if (param.scoreBits > 0)
+            {
+                std::merge(candidates, candidates + numSorted, candidates + numSorted, candidates + numCandidates,
+                    scratch, [&param](HostCandidate const& a, HostCandidate const& b) {
+                        return HostScoreBitsKey(a.score, param.scoreBits) > HostScoreBitsKey(b.score, param.scoreBits);
+                    });
+            }
+            else
+            {
+                std::merge(candidates, candidates + numSorted, candidates + numSorted, candidates + numCandidates,
+                    scratch, [](HostCandidate const& a, HostCandidate const& b) {
+                        return a.score > b.score || (a.score == b.score && a.elementIdx < b.elementIdx);
+                    });
+            }
+            numCandidates = std::min(numCandidates, param.numSelectedBoxes);
+            std::copy(scratch, scratch + numCandidates, candidates);
+        }
+        buffers.numCandidates[imageIdx] = std::min(numCandidates, param.numSelectedBoxes);
+    });
+}
+
+// Filters and sorts the listed candidates of every image, see EfficientPoseNMSParameters::sparseInput.
+template <typename T>
+void EfficientPoseNMSHostFilterSparse(EfficientPoseNMSParameters const& param, HostBuffers const& buffers,
+    void const* scoresInput, int32_t const* candidateIndicesInput, int32_t const* candidateCountsInput,
+    EfficientPoseNMSHostExecutor* executor)
+{
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::filter");
+        size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+        T const* scores = static_cast<T const*>(scoresInput) + imageOffset;
+        int32_t const* candidateIndices = candidateIndicesInput + 2 * imageOffset;
+        int32_t numListed = std::min(std::max(candidateCountsInput[imageIdx], 0), param.numScoreElements);
+        int32_t numCandidates = EfficientPoseNMSHostFilter(
+            param,
+            [&](HostCandidate* selected) {
+                return HostSelectSparse(param, scores, candidateIndices, numListed, selected);
+            },
+            buffers.candidates + imageOffset, buffers.scratch + imageOffset, buffers.histogram + imageIdx * 1024);
+        buffers.numFiltered[imageIdx] = numCandidates;
+        buffers.numCandidates[imageIdx] = std::min(numCandidates, param.numSelectedBoxes);
+    });
+}
+
+// Runs the stages after the filter, on the sorted candidates in the workspace: class partitioning, gathering, NMS and
+// writing the results. The inputs are read from the chunks, in anchor order, filterTime is the time already spent
+// filtering them, and callStart is when the NMS time budget started. With a ring output, the output tensors are all
+// null, and the detections are published into the ring instead of being written out. T is the type of the inputs, and
+// of the boxes and scores outputs.
+template <typename T>
+pluginStatus_t EfficientPoseNMSHostSuppress(EfficientPoseNMSParameters param, HostInputChunk const* chunks,
+    int32_t numChunks, void const* anchorsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput,
+    void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    HostRingOutput const* ringOutput, int32_t* numPublishedFrames, void* workspace,
+    EfficientPoseNMSHostExecutor* executor, EfficientPoseNMSHostProfile* profile, int64_t filterTime,
+    std::chrono::steady_clock::time_point callStart)
+{
+    bool const keypointSuppression = param.oksThreshold >= 0.f;
+    if (ringOutput != nullptr)
+    {
+        param.outputONNXIndices = false;
+        param.compactOutput = false;
+        param.packedOutput = false;
+        param.classMajorOutput = false;
+    }
+    if (param.classMajorOutput)
+    {
+        if (param.numOutputBoxesPerClass < 1 || param.outputONNXIndices || param.compactOutput || param.packedOutput)
+        {
+            return STATUS_BAD_PARAM;
+        }
+        // Every class has its own slots, which are never truncated by a total.
+        param.numOutputBoxes = param.numClasses * param.numOutputBoxesPerClass;
+    }
+
+    size_t const numOutputElements = static_cast<size_t>(param.batchSize) * param.numOutputBoxes;
+    size_t const numKeypointElements = 3 * static_cast<size_t>(EfficientPoseNMSOutputKeypoints(param));
+    size_t const numDetectionsElements
+        = static_cast<size_t>(param.batchSize) * (param.classMajorOutput ? param.numClasses : 1);
+    auto* numDetections = static_cast<int32_t*>(numDetectionsOutput);
+    auto* nmsBoxes = static_cast<T*>(nmsBoxesOutput);
+    auto* nmsScores = static_cast<T*>(nmsScoresOutput);
+    auto* nmsClasses = static_cast<int32_t*>(nmsClassesOutput);
+    auto* nmsIndices = static_cast<int32_t*>(nmsIndicesOutput);
+    auto* nmsOffsets = static_cast<int32_t*>(nmsOffsetsOutput);
+
+    // Clear Outputs, following the same rules as the device implementation.
+    if (ringOutput != nullptr)
+    {
+        // Nothing to clear, the ring only ever receives whole frames.
+    }
+    else if (param.outputONNXIndices)
+    {
+        if (param.numScoreElements < 1)
+        {
+            std::memset(nmsIndices, 0xFF, numOutputElements * 3 * sizeof(int32_t));
+        }
+    }
+    else
+    {
+        std::memset(numDetections, 0x00, numDetectionsElements * sizeof(int32_t));
+        if (!param.compactOutput && param.packedOutput)
+        {
+            std::memset(nmsBoxesOutput, 0x00, numOutputElements * sizeof(EfficientPoseNMSPackedDetection));
+        }
+        else if (!param.compactOutput)
+        {
+            std::memset(nmsScores, 0x00, numOutputElements * sizeof(T));
+            std::memset(nmsBoxes, 0x00, numOutputElements * 4 * sizeof(T));
+            std::memset(nmsKptsOutput, 0x00, numOutputElements * numKeypointElements * sizeof(T));
+            std::memset(nmsClasses, 0x00, numOutputElements * sizeof(int32_t));
+        }
+        else if (nmsOffsets != nullptr)
+        {
+            std::memset(nmsOffsets, 0x00, (param.batchSize + 1) * sizeof(int32_t));
+        }
+    }
+
+    if (profile != nullptr && profile->budgetExhausted != nullptr)
+    {
+        std::memset(profile->budgetExhausted, 0x00, param.batchSize * sizeof(int32_t));
+    }
+
+    // Empty Inputs
+    if (param.numScoreElements < 1)
+    {
+        if (ringOutput != nullptr)
+        {
+            *numPublishedFrames
+                = EfficientPoseNMSHostPublish<T>(param, *ringOutput, chunks, numChunks, nullptr, nullptr, nullptr,
+                    nullptr, nullptr, nullptr);
+        }
+        return STATUS_SUCCESS;
+    }
+
+    // Without class agnostic NMS, classes never suppress each other, so each one is swept independently. The IOU test
+    // and time budgets are per image though, and must stop its sweep after its highest scoring boxes of all classes, so
+    // with either one, the classes of an image are swept together in score order instead.
+    bool const sweepBudget = param.maxIouTests > 0 || param.nmsTimeBudget > 0;
+    bool const classPartitioned = !param.classAgnostic && param.numClasses > 1 && !sweepBudget;
+
+    HostBuffers const b = EfficientPoseNMSHostCarve(param, workspace);
+    size_t const keypointStride = 3 * HostKeypointStride(param.numKeypoints);
+    alignas(16) float keypointWeights[EFFICIENT_POSE_NMS_MAX_KEYPOINTS];
+    HostKeypointWeights(param, keypointWeights);
+
+    auto const* anchors = static_cast<T const*>(anchorsInput);
+    HostSweepBudget const budget{param.maxIouTests, param.nmsTimeBudget > 0,
+        callStart + std::chrono::microseconds(std::max(param.nmsTimeBudget, 0))};
+
+    // Stage times are only taken when profiling.
+    auto stageStart = profile != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    auto endStage = [&](int64_t EfficientPoseNMSHostProfile::*stageTime) {
+        if (profile != nullptr)
+        {
+            auto now = std::chrono::steady_clock::now();
+            profile->*stageTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageStart).count();
+            stageStart = now;
+        }
+    };
+
+    // Class Partition
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        if (profile != nullptr && profile->numCandidates != nullptr)
+        {
+            profile->numCandidates[imageIdx] = b.numFiltered[imageIdx];
+        }
+        // The candidates are sorted, so the budget keeps the highest scoring ones, for all classes together.
+        if (param.maxSweptCandidates > 0 && b.numCandidates[imageIdx] > param.maxSweptCandidates)
+        {
+            b.numCandidates[imageIdx] = param.maxSweptCandidates;
+            b.classExhausted[imageIdx * param.numClasses] = 1;
+        }
+        if (classPartitioned)
+        {
+            EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::partition");
+            size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+            EfficientPoseNMSHostPartition(param, b.candidates + imageOffset, b.numCandidates[imageIdx],
+                b.classOffsets + imageIdx * (param.numClasses + 1), b.partition + imageOffset);
+        }
+    });
+
+    endStage(&EfficientPoseNMSHostProfile::filterTime);
+    if (profile != nullptr)
+    {
+        profile->filterTime += filterTime;
+    }
+
+    // Gather
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::gather");
+        size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+        EfficientPoseNMSHostGather(param, imageIdx, chunks, numChunks, anchors, b.candidates + imageOffset,
+            b.numCandidates[imageIdx], b.candidateBoxes + imageOffset, b.candidateAreas + imageOffset,
+            b.candidateClasses + imageOffset, b.candidateAnchors + imageOffset,
+            keypointSuppression ? b.candidateKeypoints + imageOffset * keypointStride : nullptr);
+    });
+
+    endStage(&EfficientPoseNMSHostProfile::gatherTime);
+
+    // NMS
+    if (classPartitioned)
+    {
+        // One task per class and image. Each class writes its selected boxes and keeps its boxes within its own
+        // segment of the partition, which can never hold more than the class has candidates.
+        EfficientPoseNMSHostParallelFor(executor, param.batchSize * param.numClasses, [&](int32_t taskIdx) {
+            EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::nms");
+            int32_t imageIdx = taskIdx / param.numClasses;
+            int32_t classIdx = taskIdx % param.numClasses;
+            size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+            int32_t const* classOffsets = b.classOffsets + imageIdx * (param.numClasses + 1);
+            int32_t segmentOffset = classOffsets[classIdx];
+            int32_t segmentSize = classOffsets[classIdx + 1] - segmentOffset;
+            int32_t numSelected = EfficientPoseNMSHostSweep<T>(param, b.candidates + imageOffset,
+                b.candidateBoxes + imageOffset, b.candidateAreas + imageOffset, b.candidateClasses + imageOffset,
+                keypointSuppression ? b.candidateKeypoints + imageOffset * keypointStride : nullptr, keypointWeights,
+                b.partition + imageOffset + segmentOffset, segmentSize, b.kept + imageOffset + segmentOffset,
+                b.classCounters + imageIdx * param.numClasses, b.selected + imageOffset + segmentOffset, budget,
+                b.classExhausted + taskIdx);
+            b.classSelected[taskIdx] = numSelected;
+        });
+
+        // Merge the selected boxes of all classes back into score order.
+        EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+            EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::merge");
+            size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+            int32_t const* classOffsets = b.classOffsets + imageIdx * (param.numClasses + 1);
+            int32_t* selected = b.selected + imageOffset;
+            int32_t numSelected = 0;
+            for (int32_t classIdx = 0; classIdx < param.numClasses; classIdx++)
+            {
+                int32_t segmentOffset = classOffsets[classIdx];
+                int32_t count = b.classSelected[imageIdx * param.numClasses + classIdx];
+                std::copy(selected + segmentOffset, selected + segmentOffset + count, selected + numSelected);
+                numSelected += count;
+            }
+            std::sort(selected, selected + numSelected);
+            b.numSelected[imageIdx] = std::min(numSelected, param.numOutputBoxes);
+        });
+    }
+    else
+    {
+        EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+            EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::nms");
+            size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+            b.numSelected[imageIdx] = EfficientPoseNMSHostSweep<T>(param, b.candidates + imageOffset,
+                b.candidateBoxes + imageOffset, b.candidateAreas + imageOffset, b.candidateClasses + imageOffset,
+                keypointSuppression ? b.candidateKeypoints + imageOffset * keypointStride : nullptr, keypointWeights,
+                nullptr, b.numCandidates[imageIdx], b.kept + imageOffset,
+                b.classCounters + imageIdx * param.numClasses, b.selected + imageOffset, budget,
+                b.classExhausted + imageIdx * param.numClasses);
+        });
+    }
+
+    endStage(&EfficientPoseNMSHostProfile::nmsTime);
+    if (profile != nullptr && profile->budgetExhausted != nullptr)
+    {
+        for (int32_t imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+        {
+            int32_t const* classExhausted = b.classExhausted + imageIdx * param.numClasses;
+            profile->budgetExhausted[imageIdx]
+                = std::any_of(classExhausted, classExhausted + param.numClasses, [](int32_t e) { return e != 0; });
+        }
+    }
+
+    if (ringOutput != nullptr)
+    {
+        // The ring has a single producer, so the frames are published from the calling thread.
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::publish");
+        *numPublishedFrames = EfficientPoseNMSHostPublish<T>(param, *ringOutput, chunks, numChunks, b.numSelected,
+            b.candidates, b.candidateBoxes, b.candidateClasses, b.candidateAnchors, b.selected);
+        endStage(&EfficientPoseNMSHostProfile::writeTime);
+        return STATUS_SUCCESS;
+    }
+
+    // Write Results. Images are written in order, so the ONNX indices and the compacted outputs are packed back to
+    // back, while the standard outputs are padded to numOutputBoxes per image, or to numOutputBoxesPerClass per class
+    // and image when class major. The output offset of each image is found first, so that the images can then be
+    // written in parallel.
+    int32_t numOutputs = 0;
+    for (int32_t imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+    {
+        b.outputOffsets[imageIdx] = numOutputs;
+        numOutputs += b.numSelected[imageIdx];
+    }
+
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::write");
+        size_t imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+        HostCandidate const* candidates = b.candidates + imageOffset;
+        HostBoxCorner const* candidateBoxes = b.candidateBoxes + imageOffset;
+        int32_t const* candidateClasses = b.candidateClasses + imageOffset;
+        int32_t const* candidateAnchors = b.candidateAnchors + imageOffset;
+        int32_t const* selected = b.selected + imageOffset;
+        int32_t numSelected = b.numSelected[imageIdx];
+        size_t outputIdx = b.outputOffsets[imageIdx];
+        if (!param.outputONNXIndices && !param.compactOutput)
+        {
+            outputIdx = static_cast<size_t>(imageIdx) * param.numOutputBoxes;
+        }
+
+        for (int32_t k = 0; k < numSelected; k++, outputIdx++)
+        {
+            int32_t idx = selected[k];
+            if (param.outputONNXIndices)
+            {
+                nmsIndices[outputIdx * 3 + 0] = imageIdx;
+                nmsIndices[outputIdx * 3 + 1] = candidateClasses[idx];
+                nmsIndices[outputIdx * 3 + 2] = candidateAnchors[idx];
+                continue;
+            }
+            float score = HostOutputScore<T>(param, candidates[idx].score);
+            HostBoxCorner box = candidateBoxes[idx];
+            if (param.clipBoxes)
+            {
+                box = box.clip(0.f, 1.f);
+            }
+            float keypoints[3 * EFFICIENT_POSE_NMS_MAX_KEYPOINTS];
+            if (param.packedOutput || nmsKptsOutput != nullptr)
+            {
+                EfficientPoseNMSHostDecodeKeypoints<T>(
+                    param, imageIdx, candidateAnchors[idx], chunks, numChunks, keypoints);
+            }
+            if (param.packedOutput)
+            {
+                // The packed detection only holds the first keypoint.
+                static_cast<EfficientPoseNMSPackedDetection*>(nmsBoxesOutput)[outputIdx]
+                    = EfficientPoseNMSPackDetection(box.y1, box.x1, box.y2, box.x2, keypoints, score,
+                        candidateClasses[idx], param.packedImageHeight, param.packedImageWidth);
+                continue;
+            }
+            float const values[4] = {box.y1, box.x1, box.y2, box.x2};
+            size_t slotIdx = outputIdx;
+            if (param.classMajorOutput)
+            {
+                // The selected boxes are in score order, so each class fills its slots in score order too.
+                int32_t const classIdx = candidateClasses[idx];
+                int32_t& classCount = numDetections[imageIdx * param.numClasses + classIdx];
+                slotIdx = (static_cast<size_t>(imageIdx) * param.numClasses + classIdx) * param.numOutputBoxesPerClass
+                    + classCount++;
+            }
+            HostStore(nmsScores, slotIdx, score);
+            nmsClasses[slotIdx] = candidateClasses[idx];
+            HostStore4(nmsBoxes + slotIdx * 4, values);
+            if (nmsKptsOutput != nullptr)
+            {
+                T* nmsKpts = static_cast<T*>(nmsKptsOutput) + slotIdx * numKeypointElements;
+                for (size_t j = 0; j < numKeypointElements; j++)
+                {
+                    HostStore(nmsKpts, j, keypoints[j]);
+                }
+            }
+        }
+        if (!param.outputONNXIndices && !param.classMajorOutput)
+        {
+            numDetections[imageIdx] = numSelected;
+        }
+        if (nmsOffsets != nullptr && param.compactOutput && !param.outputONNXIndices)
+        {
+            nmsOffsets[imageIdx] = b.outputOffsets[imageIdx];
+        }
+    });
+
+    if (param.outputONNXIndices)
+    {
+        // Pad the remaining indices with a copy of the last valid one, or with -1 if there are no results at all, same
+        // as EfficientPoseNMSONNXResult. The padding is split in one range of numOutputBoxes indices per image.
+        EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+            EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::onnxPad");
+            size_t start
+                = std::max(static_cast<size_t>(imageIdx) * param.numOutputBoxes, static_cast<size_t>(numOutputs));
+            size_t end = static_cast<size_t>(imageIdx + 1) * param.numOutputBoxes;
+            int32_t const padding[3] = {-1, -1, -1};
+            int32_t const* source = numOutputs > 0 ? &nmsIndices[(numOutputs - 1) * 3] : padding;
+            for (size_t idx = start; idx < end; idx++)
+            {
+                std::memcpy(&nmsIndices[idx * 3], source, 3 * sizeof(int32_t));
+            }
+        });
+    }
+    else if (nmsOffsets != nullptr && param.compactOutput)
+    {
+        nmsOffsets[param.batchSize] = numOutputs;
+    }
+    endStage(&EfficientPoseNMSHostProfile::writeTime);
+
+    return STATUS_SUCCESS;
+}
+
+// Shared by the entry points, which filter all the anchors as a single chunk. The candidate indices and counts are
+// only given with sparse input.
+template <typename T>
+pluginStatus_t EfficientPoseNMSHostRun(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, int32_t const* candidateIndicesInput, int32_t const* candidateCountsInput,
+    void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, HostRingOutput const* ringOutput, int32_t* numPublishedFrames, void* workspace,
+    EfficientPoseNMSHostExecutor* executor, EfficientPoseNMSHostProfile* profile)
+{
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost");
+    auto const callStart = std::chrono::steady_clock::now();
+    if (param.oksThreshold >= 0.f && (keypointsInput == nullptr || !EfficientPoseNMSHostKeypointsValid(param)))
+    {
+        return STATUS_BAD_PARAM;
+    }
+    param.sparseInput = candidateCountsInput != nullptr;
+    EfficientPoseNMSHostPrepare(param);
+
+    HostInputChunk const chunk{boxesInput, scoresInput, keypointsInput, 0, param.numAnchors};
+    auto const filterStart = std::chrono::steady_clock::now();
+    if (param.numScoreElements >= 1)
+    {
+        HostBuffers const b = EfficientPoseNMSHostCarve(param, workspace);
+        std::memset(b.numCandidates, 0x00, (4 + 4 * param.numClasses + 1) * param.batchSize * sizeof(int32_t));
+        if (param.sparseInput)
+        {
+            EfficientPoseNMSHostFilterSparse<T>(
+                param, b, scoresInput, candidateIndicesInput, candidateCountsInput, executor);
+        }
+        else
+        {
+            EfficientPoseNMSHostFilterChunk<T>(param, b, chunk, executor);
+        }
+    }
+    int64_t const filterTime = profile != nullptr
+        ? std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - filterStart).count()
+        : 0;
+
+    return EfficientPoseNMSHostSuppress<T>(param, &chunk, 1, anchorsInput, numDetectionsOutput, nmsBoxesOutput,
+        nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, ringOutput,
+        numPublishedFrames, workspace, executor, profile, filterTime, callStart);
+}
+
+// The workspace buffers of a threshold sweep, which follow those of a single call, see
+// EfficientPoseNMSHostThresholdSweepWorkspaceSize.
+struct HostThresholdSweepBuffers
+{
+    uint64_t* eligible;
+    uint64_t* keptPairs;
+    int32_t* keptLinks;
+    int32_t* classLastKept;
+    int32_t* pairCounters;
+};
+
+HostThresholdSweepBuffers EfficientPoseNMSHostThresholdSweepCarve(
+    EfficientPoseNMSParameters const& param, int32_t numThresholds, void* workspace)
+{
+    HostThresholdSweepBuffers sb;
+    size_t workspaceOffset = EfficientPoseNMSHostWorkspaceSize(param.batchSize, param.numScoreElements,
+        param.numClasses, param.datatype, param.oksThreshold >= 0.f ? param.numKeypoints : 0);
+    size_t const numBatchElements = static_cast<size_t>(param.batchSize) * param.numScoreElements;
+    sb.eligible = EfficientPoseNMSHostWorkspace<uint64_t>(workspace, workspaceOffset, numBatchElements);
+    sb.keptPairs = EfficientPoseNMSHostWorkspace<uint64_t>(workspace, workspaceOffset, numBatchElements);
+    sb.keptLinks = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, numBatchElements);
+    sb.classLastKept
+        = EfficientPoseNMSHostWorkspace<int32_t>(workspace, workspaceOffset, param.batchSize * param.numClasses);
+    sb.pairCounters = EfficientPoseNMSHostWorkspace<int32_t>(
+        workspace, workspaceOffset, static_cast<size_t>(param.batchSize) * numThresholds * (param.numClasses + 1));
+    return sb;
+}
+
+// Runs the NMS of an image for all the threshold pairs at once, on its sorted candidates, which passed the lowest
+// score threshold. Bit j of the pair masks stands for the pair with the j-th lowest IOU threshold, pairOrder[j], so
+// that the pairs for which an overlap reaches the IOU threshold are always the lowest bits. First, each candidate gets
+// the mask of the pairs whose score threshold it passes, within the first numSelectedBoxes of each pair. The
+// candidates are then swept once in score order, as EfficientPoseNMSHostSweep does for each pair. A box kept by any
+// pair is kept once, with the mask of the pairs that kept it, so each overlap is computed once for all of them.
+template <typename T>
+void EfficientPoseNMSHostThresholdSweepImage(EfficientPoseNMSParameters const& param, int32_t imageIdx,
+    HostInputChunk const& chunk, T const* anchors, HostBuffers const& b, HostThresholdSweepBuffers const& sb,
+    float const* scoreThresholds, float const* iouThresholds, int32_t const* pairOrder, int32_t numThresholds,
+    float const* keypointWeights, int32_t* numDetections, T* nmsBoxes, T* nmsScores, int32_t* nmsClasses)
+{
+    size_t const imageOffset = static_cast<size_t>(imageIdx) * param.numScoreElements;
+    HostCandidate const* candidates = b.candidates + imageOffset;
+    int32_t const numCandidates = b.numCandidates[imageIdx];
+    uint64_t* eligible = sb.eligible + imageOffset;
+    uint64_t const allPairs = numThresholds == 64 ? ~0ULL : (1ULL << numThresholds) - 1;
+
+    // The thresholds are tested on the input scores, as the filter of a single call does.
+    T const* scores = static_cast<T const*>(chunk.scores) + imageOffset;
+    int32_t numEligible[64] = {};
+    uint64_t saturated = param.numSelectedBoxes > 0 ? 0 : allPairs;
+    int32_t numSwept = 0;
+    for (; numSwept < numCandidates && saturated != allPairs; numSwept++)
+    {
+        float score = HostLoad(scores, candidates[numSwept].elementIdx);
+        uint64_t pairs = 0;
+        for (int32_t j = 0; j < numThresholds; j++)
+        {
+            if (!(saturated >> j & 1) && score >= scoreThresholds[j])
+            {
+                pairs |= 1ULL << j;
+                if (++numEligible[j] == param.numSelectedBoxes)
+                {
+                    saturated |= 1ULL << j;
+                }
+            }
+        }
+        eligible[numSwept] = pairs;
+    }
+
+    size_t const keypointStride = 3 * HostKeypointStride(param.numKeypoints);
+    float* candidateKeypoints
+        = param.oksThreshold >= 0.f ? b.candidateKeypoints + imageOffset * keypointStride : nullptr;
+    EfficientPoseNMSHostGather(param, imageIdx, &chunk, 1, anchors, candidates, numSwept,
+        b.candidateBoxes + imageOffset, b.candidateAreas + imageOffset, b.candidateClasses + imageOffset,
+        b.candidateAnchors + imageOffset, candidateKeypoints);
+
+    // Per pair, the number of written boxes, followed by the per class counters.
+    int32_t* pairCounters = sb.pairCounters + static_cast<size_t>(imageIdx) * numThresholds * (param.numClasses + 1);
+    std::fill(pairCounters, pairCounters + numThresholds * (param.numClasses + 1), 0);
+    bool const classChains = !param.classAgnostic && param.numClasses > 1;
+    int32_t* classLastKept = sb.classLastKept + imageIdx * param.numClasses;
+    std::fill(classLastKept, classLastKept + param.numClasses, -1);
+    HostKeptBox* kept = b.kept + imageOffset;
+    uint64_t* keptPairs = sb.keptPairs + imageOffset;
+    int32_t* keptLinks = sb.keptLinks + imageOffset;
+    int32_t numKept = 0;
+    uint64_t done = param.numOutputBoxes > 0 ? 0 : allPairs;
+    for (int32_t idx = 0; idx < numSwept && done != allPairs; idx++)
+    {
+        uint64_t const live = eligible[idx] & ~done;
+        if (live == 0)
+        {
+            continue;
+        }
+        int32_t classIdx = b.candidateClasses[imageOffset + idx];
+        HostBoxCorner box = b.candidateBoxes[imageOffset + idx];
+        float area = b.candidateAreas[imageOffset + idx];
+        float score = candidates[idx].score;
+        float const* keypoints
+            = candidateKeypoints != nullptr ? candidateKeypoints + static_cast<size_t>(idx) * keypointStride : nullptr;
+
+        // Without class agnostic NMS, only the boxes kept of the same class are visited, through their links.
+        uint64_t suppressed = 0;
+        for (int32_t k = classChains ? classLastKept[classIdx] : 0; k >= 0 && k < numKept && suppressed != live;
+             k = classChains ? keptLinks[k] : k + 1)
+        {
+            uint64_t pairs = keptPairs[k] & live & ~suppressed;
+            if (pairs == 0 || score > kept[k].score)
+            {
+                continue;
+            }
+            float overlap = HostIOU<T>(box, area, kept[k].box, kept[k].area);
+            int32_t reached = static_cast<int32_t>(
+                std::upper_bound(iouThresholds, iouThresholds + numThresholds, overlap) - iouThresholds);
+            uint64_t reachedPairs = reached == 64 ? ~0ULL : (1ULL << reached) - 1;
+            suppressed |= pairs & reachedPairs;
+            pairs &= ~reachedPairs;
+            float const* keptKeypoints = keypoints != nullptr
+                ? candidateKeypoints + static_cast<size_t>(kept[k].candidateIdx) * keypointStride
+                : nullptr;
+            if (pairs != 0 && keypoints != nullptr
+                && HostOKS(keypoints, area, keptKeypoints, kept[k].area, keypointWeights,
+                       static_cast<int32_t>(keypointStride / 3))
+                    >= param.oksThreshold)
+            {
+                suppressed |= pairs;
+            }
+        }
+        uint64_t const keep = live & ~suppressed;
+        if (keep == 0)
+        {
+            continue;
+        }
+
+        for (int32_t j = 0; j < numThresholds; j++)
+        {
+            if (!(keep >> j & 1))
+            {
+                continue;
+            }
+            int32_t const pairIdx = pairOrder[j];
+            int32_t* counters = pairCounters + j * (param.numClasses + 1);
+            bool write = true;
+            if (param.numOutputBoxesPerClass >= 0)
+            {
+                write = (counters[1 + classIdx] < param.numOutputBoxesPerClass);
+                counters[1 + classIdx]++;
+            }
+            if (!write)
+            {
+                continue;
+            }
+            size_t outputIdx = (static_cast<size_t>(pairIdx) * param.batchSize + imageIdx) * param.numOutputBoxes
+                + counters[0];
+            HostBoxCorner outputBox = param.clipBoxes ? box.clip(0.f, 1.f) : box;
+            float const values[4] = {outputBox.y1, outputBox.x1, outputBox.y2, outputBox.x2};
+            HostStore(nmsScores, outputIdx, HostOutputScore<T>(param, score));
+            nmsClasses[outputIdx] = classIdx;
+            HostStore4(nmsBoxes + outputIdx * 4, values);
+            if (++counters[0] >= param.numOutputBoxes)
+            {
+                done |= 1ULL << j;
+            }
+        }
+        kept[numKept] = {box, area, score, classIdx, idx};
+        keptPairs[numKept] = keep;
+        keptLinks[numKept] = classLastKept[classIdx];
+        classLastKept[classIdx] = numKept;
+        numKept++;
+    }
+
+    for (int32_t j = 0; j < numThresholds; j++)
+    {
+        numDetections[static_cast<size_t>(pairOrder[j]) * param.batchSize + imageIdx]
+            = pairCounters[j * (param.numClasses + 1)];
+    }
+}
+
+template <typename T>
+pluginStatus_t EfficientPoseNMSHostThresholdSweepRun(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput,
+    EfficientPoseNMSHostThresholds const* thresholds, int32_t numThresholds, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* workspace,
+    EfficientPoseNMSHostExecutor* executor)
+{
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::thresholdSweep");
+    // The pairs are ordered by IOU threshold, and their score thresholds are taken to the space and the precision the
+    // scores are compared in, the same way as for a single call.
+    int32_t pairOrder[EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS];
+    float scoreThresholds[EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS];
+    float iouThresholds[EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS];
+    for (int32_t j = 0; j < numThresholds; j++)
+    {
+        pairOrder[j] = j;
+    }
+    std::stable_sort(pairOrder, pairOrder + numThresholds,
+        [&](int32_t a, int32_t b) { return thresholds[a].iouThreshold < thresholds[b].iouThreshold; });
+    float lowestScoreThreshold = thresholds[0].scoreThreshold;
+    for (int32_t j = 0; j < numThresholds; j++)
+    {
+        EfficientPoseNMSParameters pairParam = param;
+        pairParam.scoreThreshold = thresholds[pairOrder[j]].scoreThreshold;
+        EfficientPoseNMSHostPrepare(pairParam);
+        scoreThresholds[j] = HostRound<T>(pairParam.scoreThreshold);
+        iouThresholds[j] = thresholds[pairOrder[j]].iouThreshold;
+        lowestScoreThreshold = std::min(lowestScoreThreshold, thresholds[pairOrder[j]].scoreThreshold);
+    }
+
+    // The candidates are filtered once, at the lowest score threshold, and none of them are dropped, as each pair
+    // only takes the first numSelectedBoxes of those that pass its own threshold.
+    int32_t const numSelectedBoxes = param.numSelectedBoxes;
+    param.scoreThreshold = lowestScoreThreshold;
+    EfficientPoseNMSHostPrepare(param);
+    param.numSelectedBoxes = std::max(param.numScoreElements, 0);
+
+    size_t const numOutputElements = static_cast<size_t>(numThresholds) * param.batchSize * param.numOutputBoxes;
+    std::memset(numDetectionsOutput, 0x00, static_cast<size_t>(numThresholds) * param.batchSize * sizeof(int32_t));
+    std::memset(nmsBoxesOutput, 0x00, numOutputElements * 4 * sizeof(T));
+    std::memset(nmsScoresOutput, 0x00, numOutputElements * sizeof(T));
+    std::memset(nmsClassesOutput, 0x00, numOutputElements * sizeof(int32_t));
+    if (param.numScoreElements < 1)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    HostBuffers const b = EfficientPoseNMSHostCarve(param, workspace);
+    HostThresholdSweepBuffers const sb = EfficientPoseNMSHostThresholdSweepCarve(param, numThresholds, workspace);
+    std::memset(b.numCandidates, 0x00, (4 + 4 * param.numClasses + 1) * param.batchSize * sizeof(int32_t));
+    HostInputChunk const chunk{boxesInput, scoresInput, keypointsInput, 0, param.numAnchors};
+    EfficientPoseNMSHostFilterChunk<T>(param, b, chunk, executor);
+
+    alignas(16) float keypointWeights[EFFICIENT_POSE_NMS_MAX_KEYPOINTS];
+    HostKeypointWeights(param, keypointWeights);
+
+    param.numSelectedBoxes = numSelectedBoxes;
+    EfficientPoseNMSHostParallelFor(executor, param.batchSize, [&](int32_t imageIdx) {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::thresholdSweepImage");
+        EfficientPoseNMSHostThresholdSweepImage<T>(param, imageIdx, chunk, static_cast<T const*>(anchorsInput), b, sb,
+            scoreThresholds, iouThresholds, pairOrder, numThresholds, keypointWeights,
+            static_cast<int32_t*>(numDetectionsOutput), static_cast<T*>(nmsBoxesOutput),
+            static_cast<T*>(nmsScoresOutput), static_cast<int32_t*>(nmsClassesOutput));
+    });
+    return STATUS_SUCCESS;
+}
+
+} // namespace
+
+pluginStatus_t EfficientPoseNMSHostInference(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, EfficientPoseNMSHostExecutor* executor,
+    EfficientPoseNMSHostProfile* profile)
+{
+    if (param.datatype == DataType::kHALF)
+    {
+        return EfficientPoseNMSHostRun<HostHalf>(param, boxesInput, scoresInput, nullptr, nullptr, anchorsInput,
+            keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput,
+            nmsIndicesOutput, nmsOffsetsOutput, nullptr, nullptr, workspace, executor, profile);
+    }
+    if (param.datatype == DataType::kFLOAT)
+    {
+        return EfficientPoseNMSHostRun<float>(param, boxesInput, scoresInput, nullptr, nullptr, anchorsInput,
+            keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput,
+            nmsIndicesOutput, nmsOffsetsOutput, nullptr, nullptr, workspace, executor, profile);
+    }
+    return STATUS_NOT_SUPPORTED;
+}
+
+pluginStatus_t EfficientPoseNMSHostInferenceToRing(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput, EfficientPoseNMSDetectionRing* ring,
+    int64_t firstFrameId, int32_t* numPublishedFrames, void* workspace, EfficientPoseNMSHostExecutor* executor,
+    EfficientPoseNMSHostProfile* profile)
+{
+    *numPublishedFrames = 0;
+    HostRingOutput ringOutput{ring, firstFrameId};
+    if (param.datatype == DataType::kHALF)
+    {
+        return EfficientPoseNMSHostRun<HostHalf>(param, boxesInput, scoresInput, nullptr, nullptr, anchorsInput,
+            keypointsInput, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &ringOutput,
+            numPublishedFrames, workspace, executor, profile);
+    }
+    if (param.datatype == DataType::kFLOAT)
+    {
+        return EfficientPoseNMSHostRun<float>(param, boxesInput, scoresInput, nullptr, nullptr, anchorsInput,
+            keypointsInput, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &ringOutput,
+            numPublishedFrames, workspace, executor, profile);
+    }
+    return STATUS_NOT_SUPPORTED;
+}
+
+pluginStatus_t EfficientPoseNMSHostSparseInference(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* candidateScoresInput, void const* candidateIndicesInput, void const* candidateCountsInput,
+    void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput,
+    void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    void* workspace, EfficientPoseNMSHostExecutor* executor, EfficientPoseNMSHostProfile* profile)
+{
+    if (candidateIndicesInput == nullptr || candidateCountsInput == nullptr)
+    {
+        return STATUS_BAD_PARAM;
+    }
+    auto const* candidateIndices = static_cast<int32_t const*>(candidateIndicesInput);
+    auto const* candidateCounts = static_cast<int32_t const*>(candidateCountsInput);
+    if (param.datatype == DataType::kHALF)
+    {
+        return EfficientPoseNMSHostRun<HostHalf>(param, boxesInput, candidateScoresInput, candidateIndices,
+            candidateCounts, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+            nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, nullptr, nullptr, workspace,
+            executor, profile);
+    }
+    if (param.datatype == DataType::kFLOAT)
+    {
+        return EfficientPoseNMSHostRun<float>(param, boxesInput, candidateScoresInput, candidateIndices,
+            candidateCounts, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+            nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, nullptr, nullptr, workspace,
+            executor, profile);
+    }
+    return STATUS_NOT_SUPPORTED;
+}
+
+pluginStatus_t EfficientPoseNMSHostStreamBegin(EfficientPoseNMSParameters param, void* workspace)
+{
+    if (param.datatype != DataType::kHALF && param.datatype != DataType::kFLOAT)
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+    if (param.oksThreshold >= 0.f && !EfficientPoseNMSHostKeypointsValid(param))
+    {
+        return STATUS_BAD_PARAM;
+    }
+    auto* state = static_cast<HostStreamState*>(workspace);
+    state->numChunks = 0;
+    state->numAnchors = 0;
+    state->filterTime = 0;
+    void* stageWorkspace = static_cast<char*>(workspace) + HostStreamStateSize();
+    HostBuffers const b = EfficientPoseNMSHostCarve(param, stageWorkspace);
+    std::memset(b.numCandidates, 0x00, (4 + 4 * param.numClasses + 1) * param.batchSize * sizeof(int32_t));
+    return STATUS_SUCCESS;
+}
+
+pluginStatus_t EfficientPoseNMSHostStreamChunk(EfficientPoseNMSParameters param, int32_t firstAnchor,
+    int32_t numChunkAnchors, void const* boxesInput, void const* scoresInput, void const* keypointsInput,
+    void* workspace, EfficientPoseNMSHostExecutor* executor)
+{
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::chunk");
+    auto* state = static_cast<HostStreamState*>(workspace);
+    if (firstAnchor != state->numAnchors || numChunkAnchors < 1 || numChunkAnchors > param.numAnchors - firstAnchor
+        || state->numChunks >= EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS
+        || (param.oksThreshold >= 0.f && keypointsInput == nullptr))
+    {
+        return STATUS_BAD_PARAM;
+    }
+    EfficientPoseNMSHostPrepare(param);
+
+    HostInputChunk const chunk{boxesInput, scoresInput, keypointsInput, firstAnchor, numChunkAnchors};
+    auto const filterStart = std::chrono::steady_clock::now();
+    if (param.numScoreElements >= 1)
+    {
+        void* stageWorkspace = static_cast<char*>(workspace) + HostStreamStateSize();
+        HostBuffers const b = EfficientPoseNMSHostCarve(param, stageWorkspace);
+        if (param.datatype == DataType::kHALF)
+        {
+            EfficientPoseNMSHostFilterChunk<HostHalf>(param, b, chunk, executor);
+        }
+        else
+        {
+            EfficientPoseNMSHostFilterChunk<float>(param, b, chunk, executor);
+        }
+    }
+    state->filterTime
+        += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - filterStart).count();
+    state->chunks[state->numChunks++] = chunk;
+    state->numAnchors += numChunkAnchors;
+    return STATUS_SUCCESS;
+}
+
+pluginStatus_t EfficientPoseNMSHostStreamFinish(EfficientPoseNMSParameters param, void const* anchorsInput,
+    void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput,
+    void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput, void* workspace,
+    EfficientPoseNMSHostExecutor* executor, EfficientPoseNMSHostProfile* profile)
+{
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMSHost::finish");
+    auto const callStart = std::chrono::steady_clock::now();
+    auto const* state = static_cast<HostStreamState const*>(workspace);
+    if (state->numAnchors != param.numAnchors)
+    {
+        return STATUS_BAD_PARAM;
+    }
+    EfficientPoseNMSHostPrepare(param);
+
+    void* stageWorkspace = static_cast<char*>(workspace) + HostStreamStateSize();
+    if (param.datatype == DataType::kHALF)
+    {
+        return EfficientPoseNMSHostSuppress<HostHalf>(param, state->chunks, state->numChunks, anchorsInput,
+            numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput,
+            nmsOffsetsOutput, nullptr, nullptr, stageWorkspace, executor, profile, state->filterTime, callStart);
+    }
+    if (param.datatype == DataType::kFLOAT)
+    {
+        return EfficientPoseNMSHostSuppress<float>(param, state->chunks, state->numChunks, anchorsInput,
+            numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput,
+            nmsOffsetsOutput, nullptr, nullptr, stageWorkspace, executor, profile, state->filterTime, callStart);
+    }
+    return STATUS_NOT_SUPPORTED;
+}
+
+pluginStatus_t EfficientPoseNMSHostThresholdSweep(EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput,
+    EfficientPoseNMSHostThresholds const* thresholds, int32_t numThresholds, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* workspace,
+    EfficientPoseNMSHostExecutor* executor)
+{
+    if (thresholds == nullptr || numThresholds < 1 || numThresholds > EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS
+        || (param.oksThreshold >= 0.f && (keypointsInput == nullptr || !EfficientPoseNMSHostKeypointsValid(param))))
+    {
+        return STATUS_BAD_PARAM;
+    }
+    if (param.datatype == DataType::kHALF)
+    {
+        return EfficientPoseNMSHostThresholdSweepRun<HostHalf>(param, boxesInput, scoresInput, anchorsInput,
+            keypointsInput, thresholds, numThresholds, numDetectionsOutput, nmsBoxesOutput, nmsScoresOutput,
+            nmsClassesOutput, workspace, executor);
+    }
+    if (param.datatype == DataType::kFLOAT)
+    {
+        return EfficientPoseNMSHostThresholdSweepRun<float>(param, boxesInput, scoresInput, anchorsInput,
+            keypointsInput, thresholds, numThresholds, numDetectionsOutput, nmsBoxesOutput, nmsScoresOutput,
+            nmsClassesOutput, workspace, executor);
+    }
+    return STATUS_NOT_SUPPORTED;
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HOST_INFERENCE_H
+#define TRT_EFFICIENT_POSE_NMS_HOST_INFERENCE_H
+
+#include "efficientPoseNMSHostExecutor.h"
+#include "efficientPoseNMSHostRing.h"
+#include "efficientPoseNMSParameters.h"
+
+#include <cstdint>
+
+// Maximum number of chunks of a streamed host inference call, see EfficientPoseNMSHostStreamBegin.
+#define EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS 64
+// Maximum number of threshold pairs of a host threshold sweep, see EfficientPoseNMSHostThresholdSweep.
+#define EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS 64
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// Optional profile of a host inference call, filled in when passed to EfficientPoseNMSHostInference.
+struct EfficientPoseNMSHostProfile
+{
+    // Wall clock time of each stage, in nanoseconds: filter and sort, gathering the decoded candidates, NMS, and
+    // writing the results.
+    int64_t filterTime{0};
+    int64_t gatherTime{0};
+    int64_t nmsTime{0};
+    int64_t writeTime{0};
+    // If set, receives the number of candidates of each image above the score threshold, before these are limited
+    // to numSelectedBoxes.
+    int32_t* numCandidates{nullptr};
+    // If set, receives 1 for each image whose NMS stopped on a budget, and 0 otherwise, see
+    // EfficientPoseNMSParameters::maxSweptCandidates. The results of such an image are valid, but may miss boxes.
+    int32_t* budgetExhausted{nullptr};
+};
+
+// One (score, IOU) threshold pair of a host threshold sweep.
+struct EfficientPoseNMSHostThresholds
+{
+    float scoreThreshold;
+    float iouThreshold;
+};
+
+} // namespace plugin
+} // namespace nvinfer1
+
+// Host (CPU) implementation of EfficientPoseNMSInference. All buffers, including the workspace, are in host memory,
+// and the inputs and outputs follow the exact same shapes and semantics as the device implementation.
+// If an executor is given, images (and classes, when not class agnostic) are processed in parallel on it.
+// Calls are reentrant: all the state of a call lives in its workspace, so any number of threads can run calls with the
+// same parameters and executor at the same time, as long as each one has its own workspace and outputs.
+// The keypoints input is only read with OKS suppression (see EfficientPoseNMSParameters::oksThreshold), which then
+// needs a workspace sized for param.numKeypoints. The keypoints output is [batchSize, numOutputBoxes,
+// 3 * EfficientPoseNMSOutputKeypoints(param)], holding the input keypoints of each detection.
+// With param.datatype kHALF, the inputs and the boxes, keypoints and scores outputs are fp16, as on the device. The
+// scores are tested against the threshold as fp16, only the candidates that pass are widened, and the box arithmetic is
+// rounded to fp16 wherever the device computes in fp16, so that the results match the fp16 device path, score bits
+// included.
+
+size_t EfficientPoseNMSHostWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    nvinfer1::DataType datatype, int32_t numKeypoints = 0);
+
+pluginStatus_t EfficientPoseNMSHostInference(nvinfer1::plugin::EfficientPoseNMSParameters param, void const* boxesInput,
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput,
+    void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput, void* workspace,
+    nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr,
+    nvinfer1::plugin::EfficientPoseNMSHostProfile* profile = nullptr);
+
+// Same as EfficientPoseNMSHostInference, but instead of filling the output tensors, publishes the detections of each
+// image straight into the ring, as frames firstFrameId, firstFrameId + 1, and so on. The calling thread is the single
+// producer of the ring. The ONNX indices, compact, packed and class major output options do not apply, and the
+// workspace is the same.
+// Frames are published whole and in order. If a frame does not fit in the free slots of the ring, neither it nor any
+// later frame of the batch is published, and numPublishedFrames, which is always set, is less than the batch size.
+pluginStatus_t EfficientPoseNMSHostInferenceToRing(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* boxesInput, void const* scoresInput, void const* anchorsInput, void const* keypointsInput,
+    nvinfer1::plugin::EfficientPoseNMSDetectionRing* ring, int64_t firstFrameId, int32_t* numPublishedFrames,
+    void* workspace, nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr,
+    nvinfer1::plugin::EfficientPoseNMSHostProfile* profile = nullptr);
+
+// Same as EfficientPoseNMSHostInference, with a sparse candidate list per image instead of the dense scores input, see
+// EfficientPoseNMSParameters::sparseInput for its layout, which is used whatever param.sparseInput is. The listed
+// candidates go through the same score threshold and background class tests, and are then sorted, suppressed and
+// written out as dense candidates would be. Equal scores are ordered by anchor and class, as for the dense input,
+// except with score bits, where they keep their list order. param.numScoreElements is the capacity of the lists, which
+// the workspace is sized for.
+pluginStatus_t EfficientPoseNMSHostSparseInference(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* boxesInput, void const* candidateScoresInput, void const* candidateIndicesInput,
+    void const* candidateCountsInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr,
+    nvinfer1::plugin::EfficientPoseNMSHostProfile* profile = nullptr);
+
+// Streamed host inference, which takes the boxes, scores and keypoints inputs chunk by chunk, such as one FPN level at
+// a time, as they are produced, instead of concatenated. Each chunk is filtered and sorted as soon as it is added, and
+// merged into the sorted candidates of the earlier ones, so that filtering overlaps with the production of the later
+// chunks, and the inputs are never copied. The results are the same as those of EfficientPoseNMSHostInference on the
+// concatenated inputs.
+// A call starts with EfficientPoseNMSHostStreamBegin, adds the chunks with EfficientPoseNMSHostStreamChunk, and ends
+// with EfficientPoseNMSHostStreamFinish, which writes the outputs. All three take the same parameters, for all the
+// anchors, and the same workspace, sized with EfficientPoseNMSHostStreamWorkspaceSize.
+// A chunk holds the anchors [firstAnchor, firstAnchor + numChunkAnchors) of every image, with shapes
+// [batchSize, numChunkAnchors, ...], the inputs being otherwise the same as for EfficientPoseNMSHostInference. Chunks
+// are added in anchor order, each one starting where the previous one ended, up to EFFICIENT_POSE_NMS_MAX_STREAM_CHUNKS
+// of them, and must together cover all the anchors by the time the call is finished. The boxes and keypoints of a chunk
+// are only read again when finishing, so the chunk buffers must stay valid until then. The anchors input, if any, is
+// not chunked. A chunk out of order returns STATUS_BAD_PARAM and is not added.
+// The profile filter time includes the time spent filtering the chunks, and the NMS time budget (see
+// EfficientPoseNMSParameters::nmsTimeBudget) starts with EfficientPoseNMSHostStreamFinish.
+
+size_t EfficientPoseNMSHostStreamWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    nvinfer1::DataType datatype, int32_t numKeypoints = 0);
+
+pluginStatus_t EfficientPoseNMSHostStreamBegin(nvinfer1::plugin::EfficientPoseNMSParameters param, void* workspace);
+
+pluginStatus_t EfficientPoseNMSHostStreamChunk(nvinfer1::plugin::EfficientPoseNMSParameters param, int32_t firstAnchor,
+    int32_t numChunkAnchors, void const* boxesInput, void const* scoresInput, void const* keypointsInput,
+    void* workspace, nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr);
+
+pluginStatus_t EfficientPoseNMSHostStreamFinish(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* anchorsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput,
+    void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput, void* workspace,
+    nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr,
+    nvinfer1::plugin::EfficientPoseNMSHostProfile* profile = nullptr);
+
+// Threshold sweep, for calibrating the thresholds offline: runs EfficientPoseNMSHostInference for each of the
+// numThresholds (score, IOU) threshold pairs at once, which then replace param.scoreThreshold and param.iouThreshold.
+// The candidates are filtered, sorted and decoded once, at the lowest score threshold, and then swept once for all the
+// pairs, where each overlap is computed once and tested against every IOU threshold. The results of each pair are the
+// same as those of a single call with its thresholds.
+// The outputs hold one standard result set per pair, in the order of the pairs: numDetectionsOutput is
+// [numThresholds, batchSize], and nmsBoxesOutput, nmsScoresOutput and nmsClassesOutput are [numThresholds, batchSize,
+// numOutputBoxes, ...]. There are no keypoints, ONNX indices, compact, packed, class major or budgeted outputs, so
+// those options are ignored, and the inputs are dense. The workspace is sized with
+// EfficientPoseNMSHostThresholdSweepWorkspaceSize, and numThresholds is at most
+// EFFICIENT_POSE_NMS_MAX_SWEEP_THRESHOLDS.
+
+size_t EfficientPoseNMSHostThresholdSweepWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    nvinfer1::DataType datatype, int32_t numThresholds, int32_t numKeypoints = 0);
+
+pluginStatus_t EfficientPoseNMSHostThresholdSweep(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* boxesInput, void const* scoresInput, void const* anchorsInput, void const* keypointsInput,
+    nvinfer1::plugin::EfficientPoseNMSHostThresholds const* thresholds, int32_t numThresholds,
+    void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* workspace,
+    nvinfer1::plugin::EfficientPoseNMSHostExecutor* executor = nullptr);
+
+#endif
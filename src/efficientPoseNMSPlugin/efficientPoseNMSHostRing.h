@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_HOST_RING_H
+#define TRT_EFFICIENT_POSE_NMS_HOST_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "efficientPoseNMSParameters.h"
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// A kept detection, as published by EfficientPoseNMSHostInferenceToRing.
+struct EfficientPoseNMSDetection
+{
+    // The frame of the detection, counted from the first frame id given to the call.
+    int64_t frameId;
+    // Same values as the detection_boxes, detection_keypoints, detection_scores and detection_classes outputs. Only
+    // the first EfficientPoseNMSOutputKeypoints (y, x, confidence) keypoints are set.
+    float box[4];
+    float keypoints[3 * EFFICIENT_POSE_NMS_MAX_KEYPOINTS];
+    float score;
+    int32_t classIdx;
+    // The index of this detection within its frame, and the number of detections of the frame. A frame without
+    // detections is published as a single record with numDetections = 0, so that every frame reaches the consumer.
+    int32_t detectionIdx;
+    int32_t numDetections;
+};
+
+// Lock-free ring buffer of detections, with a single producer and a single consumer thread.
+//
+// The producer writes directly into the free slots and publishes them, and the consumer reads directly from the
+// published slots and releases them, so records are never staged anywhere else. Each side only ever writes its own
+// position, with release ordering, and reads the position of the other side with acquire ordering.
+class EfficientPoseNMSDetectionRing
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit EfficientPoseNMSDetectionRing(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded *= 2;
+        }
+        mSlots.resize(rounded);
+        mMask = rounded - 1;
+    }
+
+    EfficientPoseNMSDetectionRing(EfficientPoseNMSDetectionRing const&) = delete;
+    EfficientPoseNMSDetectionRing& operator=(EfficientPoseNMSDetectionRing const&) = delete;
+
+    size_t capacity() const
+    {
+        return mSlots.size();
+    }
+
+    // Producer: the number of slots that can be written, which only grows until the next publish.
+    size_t freeSlots() const
+    {
+        return mSlots.size() - (mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_acquire));
+    }
+
+    // Producer: the offset'th free slot, with offset < freeSlots().
+    EfficientPoseNMSDetection& freeSlot(size_t offset)
+    {
+        return mSlots[(mTail.load(std::memory_order_relaxed) + offset) & mMask];
+    }
+
+    // Producer: makes the first count free slots visible to the consumer.
+    void publish(size_t count)
+    {
+        mTail.store(mTail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer: the number of published slots that can be read, which only grows until the next release.
+    size_t available() const
+    {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_relaxed);
+    }
+
+    // Consumer: the offset'th published slot, with offset < available().
+    EfficientPoseNMSDetection const& availableSlot(size_t offset) const
+    {
+        return mSlots[(mHead.load(std::memory_order_relaxed) + offset) & mMask];
+    }
+
+    // Consumer: hands the first count published slots back to the producer.
+    void release(size_t count)
+    {
+        mHead.store(mHead.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+private:
+    std::vector<EfficientPoseNMSDetection> mSlots;
+    size_t mMask{0};
+    // Each position lives on its own cache line, so that the two sides do not invalidate each other's line on every
+    // update. The positions only ever increase, and wrap around through the mask.
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_INDEXING_H
+#define TRT_EFFICIENT_POSE_NMS_INDEXING_H
+
+#include <climits>
+#include <cstddef>
+
+#include "efficientPoseNMSParameters.h"
+
+// Index arithmetic over the flat [batchSize, ...] buffers, shared by the device and host implementations so that it
+// can be tested without a device.
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// Number of (y, x, confidence) keypoints of each detection in the keypoints output. With OKS suppression, these are
+// the keypoints of the detection, as given by the keypoints input, otherwise there is a single keypoint per detection,
+// which is always zero.
+inline int32_t EfficientPoseNMSOutputKeypoints(EfficientPoseNMSParameters const& param)
+{
+    return param.oksThreshold >= 0.F ? param.numKeypoints : 1;
+}
+
+// Whether one of the flat buffers of a call has more elements than int can address, in which case the device
+// implementation runs its int64_t indexing variant. The largest flat buffers are the scores (and the score sized
+// workspace buffers), the boxes, the boxes and keypoints outputs, with sparse input, the candidate indices, and with
+// OKS suppression, the keypoints input and the keypoints gathered for each score.
+inline bool EfficientPoseNMSLargeIndexing(EfficientPoseNMSParameters const& param)
+{
+    size_t const limit = INT_MAX;
+    size_t const numKeypointElements = param.oksThreshold >= 0.F ? 3 * static_cast<size_t>(param.numKeypoints) : 0;
+    size_t const numOutputKeypointElements = 3 * static_cast<size_t>(EfficientPoseNMSOutputKeypoints(param));
+    return static_cast<size_t>(param.batchSize) * param.numScoreElements * (param.sparseInput ? 2 : 1) > limit
+        || static_cast<size_t>(param.batchSize) * param.numBoxElements > limit
+        || static_cast<size_t>(param.batchSize) * param.numOutputBoxes * 4 > limit
+        || static_cast<size_t>(param.batchSize) * param.numOutputBoxes * numOutputKeypointElements > limit
+        || static_cast<size_t>(param.batchSize) * param.numAnchors * numKeypointElements > limit
+        || static_cast<size_t>(param.batchSize) * param.numScoreElements * numKeypointElements > limit;
+}
+
+// Index, in boxes, of the box of an anchor and class in a [batchSize, numAnchors, 4] boxes input, or with
+// param.shareLocation unset, in a [batchSize, numAnchors, numClasses, 4] one. numAnchors is that of the buffer, which
+// is less than param.numAnchors when it only holds a chunk of the anchors of each image.
+inline size_t EfficientPoseNMSBoxIndex(EfficientPoseNMSParameters const& param, int32_t imageIdx, int32_t numAnchors,
+    int32_t anchorIdx, int32_t classIdx)
+{
+    size_t const anchorOffset = static_cast<size_t>(imageIdx) * numAnchors + anchorIdx;
+    return param.shareLocation ? anchorOffset : anchorOffset * param.numClasses + classIdx;
+}
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
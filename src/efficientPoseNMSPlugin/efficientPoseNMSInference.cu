@@ -15,23 +15,36 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <climits>
+
 #include "common/bboxUtils.h"
 #include "cub/cub.cuh"
 #include "cuda_runtime_api.h"
 
 #include "efficientPoseNMSInference.cuh"
+#include "efficientPoseNMSIndexing.h"
 #include "efficientPoseNMSInference.h"
+#include "efficientPoseNMSPacked.h"
+#include "efficientPoseNMSTrace.h"
 
 #define NMS_TILES 5
+#define COUNTING_SORT_THREADS 1024
+#define NMS_MERGE_THREADS 256
 
 using namespace nvinfer1;
 using namespace nvinfer1::plugin;
 
+// Most kernels and launchers below are templated on Ti, the type used for indices into the flat [batchSize, ...]
+// buffers. This is int on the regular path, and int64_t only when one of those buffers is too large to be
+// addressed with int (see EfficientPoseNMSLargeIndexing). Indices within a single image always use int.
+
 template <typename T>
-__device__ float IOU(EfficientPoseNMSParameters param, BoxCorner<T> box1, BoxCorner<T> box2)
+__device__ float IOU(EfficientPoseNMSParameters param, BoxCorner<T> box1, float area1, BoxCorner<T> box2, float area2)
 {
     // Regardless of the selected box coding, IOU is always performed in BoxCorner coding.
-    // The boxes are copied so that they can be reordered without affecting the originals.
+    // The boxes are copied so that they can be reordered without affecting the originals. Their areas are those of
+    // the reordered boxes, precomputed by EfficientPoseNMSGather.
     BoxCorner<T> b1 = box1;
     BoxCorner<T> b2 = box2;
     b1.reorder();
@@ -41,7 +54,7 @@ __device__ float IOU(EfficientPoseNMSParameters param, BoxCorner<T> box1, BoxCor
     {
         return 0.f;
     }
-    float unionArea = b1.area() + b2.area() - intersectArea;
+    float unionArea = area1 + area2 - intersectArea;
     if (unionArea <= 0.f)
     {
         return 0.f;
@@ -49,8 +62,33 @@ __device__ float IOU(EfficientPoseNMSParameters param, BoxCorner<T> box1, BoxCor
     return intersectArea / unionArea;
 }
 
-template <typename T, typename Tb>
-__device__ BoxCorner<T> DecodeBoxes(EfficientPoseNMSParameters param, int boxIdx, int anchorIdx,
+__device__ float OKS(EfficientPoseNMSParameters param, const float* __restrict__ keypoints1, float area1,
+    const float* __restrict__ keypoints2, float area2)
+{
+    // Object keypoint similarity: the mean over the keypoints visible in both boxes of exp(-d^2 / (2 s^2 k^2)), with
+    // s^2 the mean of the box areas and k = 2 sigma. The keypoints are (y, x, visible) triplets, as gathered by
+    // EfficientPoseNMSGather.
+    float scale = 0.5f * (area1 + area2);
+    if (scale <= 0.f)
+    {
+        return 0.f;
+    }
+    float similarity = 0.f;
+    float visible = 0.f;
+    for (int k = 0; k < param.numKeypoints; k++)
+    {
+        float v = keypoints1[3 * k + 2] * keypoints2[3 * k + 2];
+        float dy = keypoints1[3 * k + 0] - keypoints2[3 * k + 0];
+        float dx = keypoints1[3 * k + 1] - keypoints2[3 * k + 1];
+        float sigma = param.keypointSigmas[k];
+        similarity += v * __expf(-(dy * dy + dx * dx) / (8.f * sigma * sigma * scale));
+        visible += v;
+    }
+    return visible > 0.f ? similarity / visible : 0.f;
+}
+
+template <typename T, typename Tb, typename Ti>
+__device__ BoxCorner<T> DecodeBoxes(EfficientPoseNMSParameters param, Ti boxIdx, Ti anchorIdx,
     const Tb* __restrict__ boxesInput, const Tb* __restrict__ anchorsInput)
 {
     // The inputs will be in the selected coding format, as well as the decoding function. But the decoded box
@@ -66,120 +104,343 @@ __device__ BoxCorner<T> DecodeBoxes(EfficientPoseNMSParameters param, int boxIdx
     return BoxCorner<T>(box.decode(anchor));
 }
 
-template <typename T, typename Tb>
+template <typename T>
+__device__ BoxCorner<T> MapTileBox(EfficientPoseNMSParameters param, int anchorIdx, BoxCorner<T> box)
+{
+    // The anchors of an image are those of its tiles back to back, so the anchor gives the tile of the box.
+    int tileIdx = anchorIdx / (param.numAnchors / param.tilesPerImage);
+    const float* tileTransform = param.tileTransforms + 4 * tileIdx;
+    return box.transform(tileTransform[0], tileTransform[1], tileTransform[2], tileTransform[3]);
+}
+
+template <typename T, typename Tb, typename Ti>
 __device__ void MapNMSData(EfficientPoseNMSParameters param, int idx, int imageIdx, const Tb* __restrict__ boxesInput,
     const Tb* __restrict__ anchorsInput, const int* __restrict__ topClassData, const int* __restrict__ topAnchorsData,
-    const int* __restrict__ topNumData, const T* __restrict__ sortedScoresData, const int* __restrict__ sortedIndexData,
-    T& scoreMap, int& classMap, BoxCorner<T>& boxMap, int& boxIdxMap)
+    const int* __restrict__ sortedIndexData, int& classMap, int& anchorMap, BoxCorner<T>& boxMap)
 {
     // idx: Holds the NMS box index, within the current batch.
     // idxSort: Holds the batched NMS box index, which indexes the (filtered, but sorted) score buffer.
-    // scoreMap: Holds the score that corresponds to the indexed box being processed by NMS.
-    if (idx >= topNumData[imageIdx])
-    {
-        return;
-    }
-    int idxSort = imageIdx * param.numScoreElements + idx;
-    scoreMap = sortedScoresData[idxSort];
+    Ti idxSort = (Ti) imageIdx * param.numScoreElements + idx;
 
     // idxMap: Holds the re-mapped index, which indexes the (filtered, but unsorted) buffers.
     // classMap: Holds the class that corresponds to the idx'th sorted score being processed by NMS.
     // anchorMap: Holds the anchor that corresponds to the idx'th sorted score being processed by NMS.
-    int idxMap = imageIdx * param.numScoreElements + sortedIndexData[idxSort];
-    classMap = topClassData[idxMap];
-    int anchorMap = topAnchorsData[idxMap];
+    if (param.numClasses == 1)
+    {
+        // With a single class, the filter sorts the anchors themselves, and there are no class or anchor buffers.
+        classMap = 0;
+        anchorMap = sortedIndexData[idxSort];
+    }
+    else
+    {
+        Ti idxMap = (Ti) imageIdx * param.numScoreElements + sortedIndexData[idxSort];
+        classMap = topClassData[idxMap];
+        anchorMap = topAnchorsData[idxMap];
+    }
 
     // boxIdxMap: Holds the re-re-mapped index, which indexes the (unfiltered, and unsorted) boxes input buffer.
-    boxIdxMap = -1;
+    Ti boxIdxMap = -1;
     if (param.shareLocation) // Shape of boxesInput: [batchSize, numAnchors, 1, 4]
     {
-        boxIdxMap = imageIdx * param.numAnchors + anchorMap;
+        boxIdxMap = (Ti) imageIdx * param.numAnchors + anchorMap;
     }
     else // Shape of boxesInput: [batchSize, numAnchors, numClasses, 4]
     {
-        int batchOffset = imageIdx * param.numAnchors * param.numClasses;
-        int anchorOffset = anchorMap * param.numClasses;
+        Ti batchOffset = (Ti) imageIdx * param.numAnchors * param.numClasses;
+        Ti anchorOffset = (Ti) anchorMap * param.numClasses;
         boxIdxMap = batchOffset + anchorOffset + classMap;
     }
     // anchorIdxMap: Holds the re-re-mapped index, which indexes the (unfiltered, and unsorted) anchors input buffer.
-    int anchorIdxMap = -1;
+    Ti anchorIdxMap = -1;
     if (param.shareAnchors) // Shape of anchorsInput: [1, numAnchors, 4]
     {
-        anchorIdxMap = anchorMap;
+        // With tiled inference, the shared anchors are those of a single tile.
+        anchorIdxMap = param.tilesPerImage > 1 ? anchorMap % (param.numAnchors / param.tilesPerImage) : anchorMap;
     }
     else // Shape of anchorsInput: [batchSize, numAnchors, 4]
     {
-        anchorIdxMap = imageIdx * param.numAnchors + anchorMap;
+        anchorIdxMap = (Ti) imageIdx * param.numAnchors + anchorMap;
     }
     // boxMap: Holds the box that corresponds to the idx'th sorted score being processed by NMS.
-    boxMap = DecodeBoxes<T, Tb>(param, boxIdxMap, anchorIdxMap, boxesInput, anchorsInput);
+    boxMap = DecodeBoxes<T, Tb, Ti>(param, boxIdxMap, anchorIdxMap, boxesInput, anchorsInput);
+    if (param.tilesPerImage > 1)
+    {
+        boxMap = MapTileBox<T>(param, anchorMap, boxMap);
+    }
 }
 
-template <typename T>
+template <typename T, typename Tb, typename Ti>
+__global__ void EfficientPoseNMSGather(EfficientPoseNMSParameters param, const int* __restrict__ topNumData,
+    const int* __restrict__ sortedIndexData, const int* __restrict__ topClassData,
+    const int* __restrict__ topAnchorsData, const Tb* __restrict__ boxesInput, const Tb* __restrict__ anchorsInput,
+    const T* __restrict__ keypointsInput, BoxCorner<T>* __restrict__ candidateBoxesData,
+    float* __restrict__ candidateAreasData, int* __restrict__ candidateClassesData,
+    int* __restrict__ candidateAnchorsData, float* __restrict__ candidateKeypointsData)
+{
+    int elementIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
+
+    if (elementIdx >= param.numScoreElements || imageIdx >= param.batchSize)
+    {
+        return;
+    }
+
+    // Only the candidates that NMS would look at are gathered.
+    if (elementIdx >= min(topNumData[imageIdx], param.numSelectedBoxes))
+    {
+        return;
+    }
+
+    // Each candidate is decoded once, and stored in score order next to its neighbours, so that the NMS sweep only
+    // streams through these buffers instead of following the sorted indices back into the inputs on every iteration.
+    int classIdx;
+    int anchorIdx;
+    BoxCorner<T> box;
+    MapNMSData<T, Tb, Ti>(param, elementIdx, imageIdx, boxesInput, anchorsInput, topClassData, topAnchorsData,
+        sortedIndexData, classIdx, anchorIdx, box);
+    BoxCorner<T> reordered = box;
+    reordered.reorder();
+
+    Ti dataIdx = (Ti) imageIdx * param.numScoreElements + elementIdx;
+    candidateBoxesData[dataIdx] = box;
+    candidateAreasData[dataIdx] = reordered.area();
+    candidateClassesData[dataIdx] = classIdx;
+    candidateAnchorsData[dataIdx] = anchorIdx;
+
+    // With OKS suppression, the keypoints are gathered too, as fp32 (y, x, visible) triplets in the image frame.
+    if (candidateKeypointsData != nullptr)
+    {
+        const T* keypoints = keypointsInput + ((Ti) imageIdx * param.numAnchors + anchorIdx) * 3 * param.numKeypoints;
+        float* candidateKeypoints = candidateKeypointsData + dataIdx * 3 * param.numKeypoints;
+        const float* tileTransform = nullptr;
+        if (param.tilesPerImage > 1)
+        {
+            tileTransform = param.tileTransforms + 4 * (anchorIdx / (param.numAnchors / param.tilesPerImage));
+        }
+        for (int k = 0; k < param.numKeypoints; k++)
+        {
+            float y = (float) keypoints[3 * k + 0];
+            float x = (float) keypoints[3 * k + 1];
+            if (tileTransform != nullptr)
+            {
+                y = y * tileTransform[2] + tileTransform[0];
+                x = x * tileTransform[3] + tileTransform[1];
+            }
+            candidateKeypoints[3 * k + 0] = y;
+            candidateKeypoints[3 * k + 1] = x;
+            candidateKeypoints[3 * k + 2] = (float) keypoints[3 * k + 2] > 0.f ? 1.f : 0.f;
+        }
+    }
+}
+
+template <typename T, typename Ti>
+cudaError_t EfficientPoseNMSGatherLauncher(const EfficientPoseNMSParameters& param, int* topNumData,
+    int* sortedIndexData, int* topClassData, int* topAnchorsData, const void* boxesInput, const void* anchorsInput,
+    const void* keypointsInput, BoxCorner<T>* candidateBoxesData, float* candidateAreasData, int* candidateClassesData,
+    int* candidateAnchorsData, float* candidateKeypointsData, cudaStream_t stream)
+{
+    const unsigned int elementsPerBlock = 512;
+    const unsigned int imagesPerBlock = 1;
+    const unsigned int elementBlocks = (param.numScoreElements + elementsPerBlock - 1) / elementsPerBlock;
+    const unsigned int imageBlocks = (param.batchSize + imagesPerBlock - 1) / imagesPerBlock;
+    const dim3 blockSize = {elementsPerBlock, imagesPerBlock, 1};
+    const dim3 gridSize = {elementBlocks, imageBlocks, 1};
+
+    if (param.boxCoding == 0)
+    {
+        EfficientPoseNMSGather<T, BoxCorner<T>, Ti><<<gridSize, blockSize, 0, stream>>>(param, topNumData,
+            sortedIndexData, topClassData, topAnchorsData, (BoxCorner<T>*) boxesInput, (BoxCorner<T>*) anchorsInput,
+            (const T*) keypointsInput, candidateBoxesData, candidateAreasData, candidateClassesData,
+            candidateAnchorsData, candidateKeypointsData);
+    }
+    else if (param.boxCoding == 1)
+    {
+        // Note that the gathered boxes are always coded as BoxCorner<T>, regardless of the input coding type.
+        EfficientPoseNMSGather<T, BoxCenterSize<T>, Ti><<<gridSize, blockSize, 0, stream>>>(param, topNumData,
+            sortedIndexData, topClassData, topAnchorsData, (BoxCenterSize<T>*) boxesInput,
+            (BoxCenterSize<T>*) anchorsInput, (const T*) keypointsInput, candidateBoxesData, candidateAreasData,
+            candidateClassesData, candidateAnchorsData, candidateKeypointsData);
+    }
+
+    return cudaGetLastError();
+}
+
+template <typename T, typename Ti>
+__device__ void ReadKeypoint(EfficientPoseNMSParameters param, const T* __restrict__ keypointsInput, int imageIdx,
+    int anchorIdx, int k, float* keypoint)
+{
+    // The k'th (y, x, confidence) keypoint of the anchor, as given by the keypoints input, mapped to the image frame
+    // with tiled inference, same as the boxes. Unlike the gathered candidate keypoints, the confidence is kept as is.
+    const T* keypoints = keypointsInput + ((Ti) imageIdx * param.numAnchors + anchorIdx) * 3 * param.numKeypoints;
+    float y = (float) keypoints[3 * k + 0];
+    float x = (float) keypoints[3 * k + 1];
+    if (param.tilesPerImage > 1)
+    {
+        const float* tileTransform
+            = param.tileTransforms + 4 * (anchorIdx / (param.numAnchors / param.tilesPerImage));
+        y = y * tileTransform[2] + tileTransform[0];
+        x = x * tileTransform[3] + tileTransform[1];
+    }
+    keypoint[0] = y;
+    keypoint[1] = x;
+    keypoint[2] = (float) keypoints[3 * k + 2];
+}
+
+template <typename T, typename Ti>
 __device__ void WriteNMSResult(EfficientPoseNMSParameters param, int* __restrict__ numDetectionsOutput,
     T* __restrict__ nmsScoresOutput, int* __restrict__ nmsClassesOutput, BoxCorner<T>* __restrict__ nmsBoxesOutput,
-    T threadScore, int threadClass, BoxCorner<T> threadBox, int imageIdx, unsigned int resultsCounter)
+    T* __restrict__ nmsKptsOutput, const T* __restrict__ keypointsInput, T threadScore, int threadClass,
+    BoxCorner<T> threadBox, int threadAnchor, int imageIdx, unsigned int resultsCounter, unsigned int classCounter)
 {
-    int outputIdx = imageIdx * param.numOutputBoxes + resultsCounter - 1;
+    // Class major outputs are placed by the count of the class, which is only tracked with numOutputBoxesPerClass.
+    Ti outputIdx = (Ti) imageIdx * param.numOutputBoxes + resultsCounter - 1;
+    if (param.classMajorOutput)
+    {
+        outputIdx = ((Ti) imageIdx * param.numClasses + threadClass) * param.numOutputBoxesPerClass + classCounter - 1;
+    }
+    T score = threadScore;
     if (param.scoreSigmoid)
     {
-        nmsScoresOutput[outputIdx] = sigmoid_mp(threadScore);
+        score = sigmoid_mp(threadScore);
     }
     else if (param.scoreBits > 0)
     {
-        nmsScoresOutput[outputIdx] = add_mp(threadScore, (T) -1);
+        score = add_mp(threadScore, (T) -1);
+    }
+    BoxCorner<T> box = param.clipBoxes ? threadBox.clip((T) 0, (T) 1) : threadBox;
+    if (param.packedOutput)
+    {
+        // The boxes output holds the packed records, and there are no other outputs to write. The packed record only
+        // holds the first keypoint, which is zero without OKS suppression.
+        float keypoint[3] = {0.f, 0.f, 0.f};
+        if (keypointsInput != nullptr)
+        {
+            ReadKeypoint<T, Ti>(param, keypointsInput, imageIdx, threadAnchor, 0, keypoint);
+        }
+        ((EfficientPoseNMSPackedDetection*) nmsBoxesOutput)[outputIdx]
+            = EfficientPoseNMSPackDetection((float) box.y1, (float) box.x1, (float) box.y2, (float) box.x2, keypoint,
+                (float) score, threadClass, param.packedImageHeight, param.packedImageWidth);
     }
     else
     {
-        nmsScoresOutput[outputIdx] = threadScore;
+        nmsScoresOutput[outputIdx] = score;
+        nmsClassesOutput[outputIdx] = threadClass;
+        nmsBoxesOutput[outputIdx] = box;
+        // Without OKS suppression, the single keypoint of each row stays as cleared.
+        if (keypointsInput != nullptr && nmsKptsOutput != nullptr)
+        {
+            T* kpts = nmsKptsOutput + outputIdx * 3 * param.numKeypoints;
+            for (int k = 0; k < param.numKeypoints; k++)
+            {
+                float keypoint[3];
+                ReadKeypoint<T, Ti>(param, keypointsInput, imageIdx, threadAnchor, k, keypoint);
+                kpts[3 * k + 0] = (T) keypoint[0];
+                kpts[3 * k + 1] = (T) keypoint[1];
+                kpts[3 * k + 2] = (T) keypoint[2];
+            }
+        }
     }
-    nmsClassesOutput[outputIdx] = threadClass;
-    if (param.clipBoxes)
+    if (param.classMajorOutput)
     {
-        nmsBoxesOutput[outputIdx] = threadBox.clip((T) 0, (T) 1);
+        numDetectionsOutput[imageIdx * param.numClasses + threadClass] = classCounter;
     }
     else
     {
-        nmsBoxesOutput[outputIdx] = threadBox;
+        numDetectionsOutput[imageIdx] = resultsCounter;
     }
-    numDetectionsOutput[imageIdx] = resultsCounter;
 }
 
-__device__ void WriteONNXResult(EfficientPoseNMSParameters param, int* outputIndexData, int* __restrict__ nmsIndicesOutput,
-    int imageIdx, int threadClass, int boxIdxMap)
+template <typename Ti>
+__device__ void WriteONNXResult(EfficientPoseNMSParameters param, int* __restrict__ outputIndexData,
+    int* __restrict__ onnxPositionsData, int imageIdx, int idx, unsigned int resultsCounter)
 {
-    int index = boxIdxMap % param.numAnchors;
-    int idx = atomicAdd((unsigned int*) &outputIndexData[0], 1);
-    nmsIndicesOutput[idx * 3 + 0] = imageIdx;
-    nmsIndicesOutput[idx * 3 + 1] = threadClass;
-    nmsIndicesOutput[idx * 3 + 2] = index;
+    // The ONNX indices are packed back to back across the batch, which can only be done once the number of results of
+    // every image is known. Until then, only the sorted position of each result is kept, in a per-image segment.
+    onnxPositionsData[(Ti) imageIdx * param.numScoreElements + resultsCounter - 1] = idx;
+    outputIndexData[imageIdx] = resultsCounter;
+}
+
+__global__ void EfficientPoseNMSONNXOffsets(
+    EfficientPoseNMSParameters param, const int* __restrict__ outputIndexData, int* __restrict__ outputOffsetData)
+{
+    // Exclusive prefix sum of the per-image result counts, which gives each image the start of its output segment.
+    typedef cub::BlockScan<int, NMS_MERGE_THREADS> BlockScan;
+    __shared__ typename BlockScan::TempStorage scanStorage;
+
+    int offsetBase = 0;
+    for (int chunk = 0; chunk < param.batchSize; chunk += blockDim.x)
+    {
+        int imageIdx = chunk + threadIdx.x;
+        int count = imageIdx < param.batchSize ? outputIndexData[imageIdx] : 0;
+        int offset;
+        int total;
+        BlockScan(scanStorage).ExclusiveSum(count, offset, total);
+        if (imageIdx < param.batchSize)
+        {
+            outputOffsetData[imageIdx] = offsetBase + offset;
+        }
+        offsetBase += total;
+        __syncthreads();
+    }
 }
 
-__global__ void PadONNXResult(EfficientPoseNMSParameters param, int* outputIndexData, int* __restrict__ nmsIndicesOutput)
+template <typename Ti>
+__global__ void EfficientPoseNMSONNXResult(EfficientPoseNMSParameters param, const int* __restrict__ outputIndexData,
+    const int* __restrict__ outputOffsetData, const int* __restrict__ onnxPositionsData,
+    const int* __restrict__ candidateClassesData, const int* __restrict__ candidateAnchorsData,
+    int* __restrict__ nmsIndicesOutput)
 {
-    if (threadIdx.x > 0)
+    Ti outputIdx = (Ti) blockDim.x * blockIdx.x + threadIdx.x;
+    if (outputIdx >= (Ti) param.batchSize * param.numOutputBoxes)
     {
         return;
     }
-    int pidx = outputIndexData[0] - 1;
-    if (pidx < 0)
+
+    int numOutputs = outputOffsetData[param.batchSize - 1] + outputIndexData[param.batchSize - 1];
+    if (numOutputs == 0)
     {
+        nmsIndicesOutput[outputIdx * 3 + 0] = -1;
+        nmsIndicesOutput[outputIdx * 3 + 1] = -1;
+        nmsIndicesOutput[outputIdx * 3 + 2] = -1;
         return;
     }
-    for (int idx = pidx + 1; idx < param.batchSize * param.numOutputBoxes; idx++)
+
+    // Each output past the last result is padded with a copy of the last result.
+    int resultIdx = outputIdx < numOutputs ? (int) outputIdx : numOutputs - 1;
+
+    // Find the image of this result, which is the last one with an output segment starting at or before it. Images
+    // without results have empty segments, so the image found always holds the result.
+    int imageIdx = 0;
+    int last = param.batchSize - 1;
+    while (imageIdx < last)
     {
-        nmsIndicesOutput[idx * 3 + 0] = nmsIndicesOutput[pidx * 3 + 0];
-        nmsIndicesOutput[idx * 3 + 1] = nmsIndicesOutput[pidx * 3 + 1];
-        nmsIndicesOutput[idx * 3 + 2] = nmsIndicesOutput[pidx * 3 + 2];
+        int mid = (imageIdx + last + 1) / 2;
+        if (outputOffsetData[mid] <= resultIdx)
+        {
+            imageIdx = mid;
+        }
+        else
+        {
+            last = mid - 1;
+        }
     }
+
+    Ti imageOffset = (Ti) imageIdx * param.numScoreElements;
+    Ti idxSort = imageOffset + onnxPositionsData[imageOffset + resultIdx - outputOffsetData[imageIdx]];
+    nmsIndicesOutput[outputIdx * 3 + 0] = imageIdx;
+    nmsIndicesOutput[outputIdx * 3 + 1] = candidateClassesData[idxSort];
+    nmsIndicesOutput[outputIdx * 3 + 2] = candidateAnchorsData[idxSort];
 }
 
-template <typename T, typename Tb>
+template <typename T, typename Ti>
 __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* topNumData, int* outputIndexData,
-    int* outputClassData, const int* sortedIndexData, const T* __restrict__ sortedScoresData,
-    const int* __restrict__ topClassData, const int* __restrict__ topAnchorsData, const Tb* __restrict__ boxesInput,
-    const Tb* __restrict__ anchorsInput, int* __restrict__ numDetectionsOutput, T* __restrict__ nmsScoresOutput,
-    int* __restrict__ nmsClassesOutput, int* __restrict__ nmsIndicesOutput, BoxCorner<T>* __restrict__ nmsBoxesOutput)
+    int* outputClassData, const T* __restrict__ sortedScoresData, const BoxCorner<T>* __restrict__ candidateBoxesData,
+    const float* __restrict__ candidateAreasData, const int* __restrict__ candidateClassesData,
+    const int* __restrict__ candidateAnchorsData, const float* __restrict__ candidateKeypointsData,
+    const T* __restrict__ keypointsInput, const int* __restrict__ classPositionsData,
+    const int* __restrict__ classStartData, const int* __restrict__ classEndData, int* __restrict__ keepData,
+    int* __restrict__ numDetectionsOutput, T* __restrict__ nmsScoresOutput, int* __restrict__ nmsClassesOutput,
+    int* __restrict__ onnxPositionsData, BoxCorner<T>* __restrict__ nmsBoxesOutput, T* __restrict__ nmsKptsOutput)
 {
     unsigned int thread = threadIdx.x;
     unsigned int imageIdx = blockIdx.y;
@@ -190,6 +451,20 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
     }
 
     int numSelectedBoxes = min(topNumData[imageIdx], param.numSelectedBoxes);
+    Ti candidateOffset = (Ti) imageIdx * param.numScoreElements;
+
+    // When partitioned by class, each block only sweeps the candidates of the class given by blockIdx.x. These are
+    // found in score order in the class segment of classPositionsData, which maps to the sorted candidate indices.
+    // Kept boxes are then only flagged in keepData, and merged back in score order by EfficientPoseNMSClassMerge.
+    const int* segmentPositions = nullptr;
+    if (keepData != nullptr)
+    {
+        int classCounterIdx = imageIdx * param.numClasses + blockIdx.x;
+        segmentPositions
+            = classPositionsData + (Ti) imageIdx * param.numScoreElements + classStartData[classCounterIdx];
+        numSelectedBoxes = classEndData[classCounterIdx] - classStartData[classCounterIdx];
+    }
+
     int numTiles = (numSelectedBoxes + tileSize - 1) / tileSize;
     if (thread >= numSelectedBoxes)
     {
@@ -209,14 +484,24 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
     T threadScore[NMS_TILES];
     int threadClass[NMS_TILES];
     BoxCorner<T> threadBox[NMS_TILES];
-    int boxIdxMap[NMS_TILES];
+    float threadArea[NMS_TILES];
+    // With OKS suppression, the keypoints of each box stay in the candidate buffer, and are read from there.
+    const float* threadKeypoints[NMS_TILES];
     for (int tile = 0; tile < numTiles; tile++)
     {
         threadState[tile] = 0;
         boxIdx[tile] = thread + tile * blockDim.x;
-        MapNMSData<T, Tb>(param, boxIdx[tile], imageIdx, boxesInput, anchorsInput, topClassData, topAnchorsData,
-            topNumData, sortedScoresData, sortedIndexData, threadScore[tile], threadClass[tile], threadBox[tile],
-            boxIdxMap[tile]);
+        if (boxIdx[tile] < numSelectedBoxes)
+        {
+            int sortIdx = segmentPositions != nullptr ? segmentPositions[boxIdx[tile]] : boxIdx[tile];
+            threadKeypoints[tile] = candidateKeypointsData != nullptr
+                ? candidateKeypointsData + (candidateOffset + sortIdx) * 3 * param.numKeypoints
+                : nullptr;
+            threadScore[tile] = sortedScoresData[candidateOffset + sortIdx];
+            threadClass[tile] = candidateClassesData[candidateOffset + sortIdx];
+            threadBox[tile] = candidateBoxesData[candidateOffset + sortIdx];
+            threadArea[tile] = candidateAreasData[candidateOffset + sortIdx];
+        }
     }
 
     // Iterate through all boxes to NMS against.
@@ -240,7 +525,9 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
             {
                 // As this box will be kept, this is a good place to find what index in the results buffer it
                 // should have, as this allows to perform an early loop exit if there are enough results.
-                if (resultsCounter >= param.numOutputBoxes)
+                if (resultsCounter >= param.numOutputBoxes
+                    || (segmentPositions != nullptr && param.numOutputBoxesPerClass >= 0
+                        && resultsCounter >= param.numOutputBoxesPerClass))
                 {
                     blockState = -2; // -2 => Signal all threads to do an early loop exit.
                 }
@@ -257,26 +544,35 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
                     // class on this image has not been reached yet. Other than (possibly) skipping the write, this
                     // won't affect anything else in the NMS threading.
                     bool write = true;
+                    unsigned int classCounter = 0;
                     if (param.numOutputBoxesPerClass >= 0)
                     {
                         int classCounterIdx = imageIdx * param.numClasses + threadClass[tile];
                         write = (outputClassData[classCounterIdx] < param.numOutputBoxesPerClass);
-                        outputClassData[classCounterIdx]++;
+                        classCounter = ++outputClassData[classCounterIdx];
                     }
                     if (write)
                     {
                         // This branch is visited by one thread per iteration, so it's safe to do non-atomic increments.
                         resultsCounter++;
-                        if (param.outputONNXIndices)
+                        // Class major outputs need no merge, as each class block writes straight into its own slots.
+                        if (segmentPositions != nullptr && !param.classMajorOutput)
                         {
-                            WriteONNXResult(
-                                param, outputIndexData, nmsIndicesOutput, imageIdx, threadClass[tile], boxIdxMap[tile]);
+                            keepData[(Ti) imageIdx * param.numScoreElements + segmentPositions[i]] = 1;
+                        }
+                        else if (param.outputONNXIndices)
+                        {
+                            WriteONNXResult<Ti>(
+                                param, outputIndexData, onnxPositionsData, imageIdx, i, resultsCounter);
                         }
                         else
                         {
-                            WriteNMSResult<T>(param, numDetectionsOutput, nmsScoresOutput, nmsClassesOutput,
-                                nmsBoxesOutput, threadScore[tile], threadClass[tile], threadBox[tile], imageIdx,
-                                resultsCounter);
+                            // The anchor is only needed for the keypoints, so it is read here rather than kept.
+                            Ti candidateIdx = candidateOffset + (segmentPositions != nullptr ? segmentPositions[i] : i);
+                            WriteNMSResult<T, Ti>(param, numDetectionsOutput, nmsScoresOutput, nmsClassesOutput,
+                                nmsBoxesOutput, nmsKptsOutput, keypointsInput, threadScore[tile], threadClass[tile],
+                                threadBox[tile], candidateAnchorsData[candidateIdx], imageIdx, resultsCounter,
+                                classCounter);
                         }
                     }
                 }
@@ -304,13 +600,15 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
 
         // Grab a box and class to test the current box against. The test box corresponds to iteration i,
         // therefore it will have a lower index than the current thread box, and will therefore have a higher score
-        // than the current box because it's located "before" in the sorted score list.
-        T testScore;
-        int testClass;
-        BoxCorner<T> testBox;
-        int testBoxIdxMap;
-        MapNMSData<T, Tb>(param, i, imageIdx, boxesInput, anchorsInput, topClassData, topAnchorsData, topNumData,
-            sortedScoresData, sortedIndexData, testScore, testClass, testBox, testBoxIdxMap);
+        // than the current box because it's located "before" in the sorted score list. The test box was already
+        // decoded by EfficientPoseNMSGather, so this only reads the next entry of the candidate buffers.
+        Ti testIdx = candidateOffset + (segmentPositions != nullptr ? segmentPositions[i] : i);
+        T testScore = sortedScoresData[testIdx];
+        int testClass = candidateClassesData[testIdx];
+        BoxCorner<T> testBox = candidateBoxesData[testIdx];
+        float testArea = candidateAreasData[testIdx];
+        const float* testKeypoints
+            = candidateKeypointsData != nullptr ? candidateKeypointsData + testIdx * 3 * param.numKeypoints : nullptr;
 
         for (int tile = 0; tile < numTiles; tile++)
         {
@@ -327,7 +625,11 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
                 threadState[tile] == 0 &&          // Make sure this box hasn't been either dropped or kept already;
                 ignoreClass &&                     // Compare only boxes of matching classes when classAgnostic is false;
                 lte_mp(threadScore[tile], testScore) && // Make sure the sorting order of scores is as expected;
-                IOU<T>(param, threadBox[tile], testBox) >= param.iouThreshold) // And... IOU overlap.
+                // And... IOU overlap, or keypoint similarity with OKS suppression.
+                (IOU<T>(param, threadBox[tile], threadArea[tile], testBox, testArea) >= param.iouThreshold
+                    || (testKeypoints != nullptr
+                        && OKS(param, threadKeypoints[tile], threadArea[tile], testKeypoints, testArea)
+                            >= param.oksThreshold)))
             {
                 // Current box overlaps with the box tested in this iteration, this box will be skipped.
                 threadState[tile] = -1; // -1 => Mark this box's thread to be dropped.
@@ -336,11 +638,152 @@ __global__ void EfficientPoseNMS(EfficientPoseNMSParameters param, const int* to
     }
 }
 
-template <typename T>
-cudaError_t EfficientPoseNMSLauncher(EfficientPoseNMSParameters& param, int* topNumData, int* outputIndexData,
-    int* outputClassData, int* sortedIndexData, T* sortedScoresData, int* topClassData, int* topAnchorsData,
-    const void* boxesInput, const void* anchorsInput, int* numDetectionsOutput, T* nmsScoresOutput,
-    int* nmsClassesOutput, int* nmsIndicesOutput, void* nmsBoxesOutput, cudaStream_t stream)
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSClassMerge(EfficientPoseNMSParameters param, const int* topNumData,
+    int* outputIndexData, const T* __restrict__ sortedScoresData, const BoxCorner<T>* __restrict__ candidateBoxesData,
+    const int* __restrict__ candidateClassesData, const int* __restrict__ candidateAnchorsData,
+    const T* __restrict__ keypointsInput, const int* __restrict__ keepData, int* __restrict__ numDetectionsOutput,
+    T* __restrict__ nmsScoresOutput, int* __restrict__ nmsClassesOutput, int* __restrict__ onnxPositionsData,
+    BoxCorner<T>* __restrict__ nmsBoxesOutput, T* __restrict__ nmsKptsOutput)
+{
+    // Writes out the boxes kept by the class partitioned NMS. One block per image walks the keep flags in score
+    // order, and a block wide prefix sum gives each kept box its position in the results.
+    typedef cub::BlockScan<int, NMS_MERGE_THREADS> BlockScan;
+    __shared__ typename BlockScan::TempStorage scanStorage;
+
+    int imageIdx = blockIdx.x;
+    int numSelectedBoxes = min(topNumData[imageIdx], param.numSelectedBoxes);
+    int resultsBase = 0;
+    for (int chunk = 0; chunk < numSelectedBoxes && resultsBase < param.numOutputBoxes; chunk += blockDim.x)
+    {
+        int idx = chunk + threadIdx.x;
+        int keep = idx < numSelectedBoxes ? keepData[(Ti) imageIdx * param.numScoreElements + idx] : 0;
+        int rank;
+        int total;
+        BlockScan(scanStorage).ExclusiveSum(keep, rank, total);
+        if (keep && resultsBase + rank < param.numOutputBoxes)
+        {
+            if (param.outputONNXIndices)
+            {
+                WriteONNXResult<Ti>(param, outputIndexData, onnxPositionsData, imageIdx, idx, resultsBase + rank + 1);
+            }
+            else
+            {
+                Ti candidateIdx = (Ti) imageIdx * param.numScoreElements + idx;
+                // The merge only runs for the score ordered layout, so there is no class count to pass.
+                WriteNMSResult<T, Ti>(param, numDetectionsOutput, nmsScoresOutput, nmsClassesOutput, nmsBoxesOutput,
+                    nmsKptsOutput, keypointsInput, sortedScoresData[candidateIdx], candidateClassesData[candidateIdx],
+                    candidateBoxesData[candidateIdx], candidateAnchorsData[candidateIdx], imageIdx,
+                    resultsBase + rank + 1, 0);
+            }
+        }
+        resultsBase += total;
+        __syncthreads();
+    }
+
+    if (threadIdx.x == 0)
+    {
+        // The results are counted from several threads, so settle the count on the final value.
+        int* countData = param.outputONNXIndices ? outputIndexData : numDetectionsOutput;
+        countData[imageIdx] = min(resultsBase, param.numOutputBoxes);
+    }
+}
+
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSCompactResult(EfficientPoseNMSParameters param, const int* numDetectionsOutput,
+    int* nmsOffsetsOutput, T* nmsScoresOutput, int* nmsClassesOutput, BoxCorner<T>* nmsBoxesOutput, T* nmsKptsOutput,
+    int numKeypointElements)
+{
+    // Packs the per-image result rows, which the NMS kernel wrote at imageIdx * numOutputBoxes, into one flat array.
+    // This runs as a single block and walks the images in order. Rows only ever move towards lower addresses, and
+    // every chunk is fully read before it is written, so the packing can be done in place.
+    // With packedOutput, the rows are the packed records in nmsBoxesOutput, see WriteNMSResult.
+    // The keypoint rows, of numKeypointElements values each, are moved one value per thread. Without OKS suppression,
+    // nothing was written to them, so they are cleared instead, the same as the padded output is.
+    EfficientPoseNMSPackedDetection* nmsPackedOutput
+        = param.packedOutput ? (EfficientPoseNMSPackedDetection*) nmsBoxesOutput : nullptr;
+    Ti offset = 0;
+    for (int imageIdx = 0; imageIdx < param.batchSize; imageIdx++)
+    {
+        int count = min(numDetectionsOutput[imageIdx], param.numOutputBoxes);
+        if (nmsOffsetsOutput != nullptr && threadIdx.x == 0)
+        {
+            nmsOffsetsOutput[imageIdx] = (int) offset;
+        }
+        Ti srcOffset = (Ti) imageIdx * param.numOutputBoxes;
+        if (nmsKptsOutput != nullptr && nmsPackedOutput == nullptr && param.oksThreshold < 0.f)
+        {
+            for (int idx = threadIdx.x; idx < count; idx += blockDim.x)
+            {
+                nmsKptsOutput[(offset + idx) * 3 + 0] = (T) 0;
+                nmsKptsOutput[(offset + idx) * 3 + 1] = (T) 0;
+                nmsKptsOutput[(offset + idx) * 3 + 2] = (T) 0;
+            }
+        }
+        else if (nmsKptsOutput != nullptr && nmsPackedOutput == nullptr)
+        {
+            Ti numValues = (Ti) count * numKeypointElements;
+            for (Ti chunk = 0; offset != srcOffset && chunk < numValues; chunk += blockDim.x)
+            {
+                Ti idx = chunk + threadIdx.x;
+                T value;
+                if (idx < numValues)
+                {
+                    value = nmsKptsOutput[srcOffset * numKeypointElements + idx];
+                }
+                __syncthreads();
+                if (idx < numValues)
+                {
+                    nmsKptsOutput[offset * numKeypointElements + idx] = value;
+                }
+                __syncthreads();
+            }
+        }
+        for (int chunk = 0; offset != srcOffset && chunk < count; chunk += blockDim.x)
+        {
+            int idx = chunk + threadIdx.x;
+            T score;
+            int classIdx;
+            BoxCorner<T> box;
+            EfficientPoseNMSPackedDetection packed;
+            if (idx < count && nmsPackedOutput != nullptr)
+            {
+                packed = nmsPackedOutput[srcOffset + idx];
+            }
+            else if (idx < count)
+            {
+                score = nmsScoresOutput[srcOffset + idx];
+                classIdx = nmsClassesOutput[srcOffset + idx];
+                box = nmsBoxesOutput[srcOffset + idx];
+            }
+            __syncthreads();
+            if (idx < count && nmsPackedOutput != nullptr)
+            {
+                nmsPackedOutput[offset + idx] = packed;
+            }
+            else if (idx < count)
+            {
+                nmsScoresOutput[offset + idx] = score;
+                nmsClassesOutput[offset + idx] = classIdx;
+                nmsBoxesOutput[offset + idx] = box;
+            }
+            __syncthreads();
+        }
+        offset += count;
+    }
+    if (nmsOffsetsOutput != nullptr && threadIdx.x == 0)
+    {
+        nmsOffsetsOutput[param.batchSize] = (int) offset;
+    }
+}
+
+template <typename T, typename Ti>
+cudaError_t EfficientPoseNMSLauncher(const EfficientPoseNMSParameters& param, int* topNumData, int* outputIndexData,
+    int* outputClassData, T* sortedScoresData, BoxCorner<T>* candidateBoxesData, float* candidateAreasData,
+    int* candidateClassesData, int* candidateAnchorsData, float* candidateKeypointsData, int* classPositionsData,
+    int* classStartData, int* classEndData, int* keepData, int* outputOffsetData, int* onnxPositionsData,
+    int* numDetectionsOutput, T* nmsScoresOutput, int* nmsClassesOutput, int* nmsIndicesOutput, int* nmsOffsetsOutput,
+    void* nmsBoxesOutput, T* nmsKptsOutput, const T* keypointsInput, cudaStream_t stream)
 {
     unsigned int tileSize = param.numSelectedBoxes / NMS_TILES;
     if (param.numSelectedBoxes <= 512)
@@ -352,46 +795,105 @@ cudaError_t EfficientPoseNMSLauncher(EfficientPoseNMSParameters& param, int* top
         tileSize = 256;
     }
 
+    // With class partitioning, there is one block per class and image, otherwise a single block per image.
+    const unsigned int classBlocks = keepData != nullptr ? param.numClasses : 1;
     const dim3 blockSize = {tileSize, 1, 1};
-    const dim3 gridSize = {1, (unsigned int) param.batchSize, 1};
-
-    if (param.boxCoding == 0)
+    const dim3 gridSize = {classBlocks, (unsigned int) param.batchSize, 1};
+
+    // Note that nmsBoxesOutput is always coded as BoxCorner<T>, regardless of the input coding type.
+    EfficientPoseNMS<T, Ti><<<gridSize, blockSize, 0, stream>>>(param, topNumData, outputIndexData, outputClassData,
+        sortedScoresData, candidateBoxesData, candidateAreasData, candidateClassesData, candidateAnchorsData,
+        candidateKeypointsData, keypointsInput, classPositionsData, classStartData, classEndData, keepData,
+        numDetectionsOutput, nmsScoresOutput, nmsClassesOutput, onnxPositionsData, (BoxCorner<T>*) nmsBoxesOutput,
+        nmsKptsOutput);
+    if (keepData != nullptr && !param.classMajorOutput)
     {
-        EfficientPoseNMS<T, BoxCorner<T>><<<gridSize, blockSize, 0, stream>>>(param, topNumData, outputIndexData,
-            outputClassData, sortedIndexData, sortedScoresData, topClassData, topAnchorsData,
-            (BoxCorner<T>*) boxesInput, (BoxCorner<T>*) anchorsInput, numDetectionsOutput, nmsScoresOutput,
-            nmsClassesOutput, nmsIndicesOutput, (BoxCorner<T>*) nmsBoxesOutput);
-    }
-    else if (param.boxCoding == 1)
-    {
-        // Note that nmsBoxesOutput is always coded as BoxCorner<T>, regardless of the input coding type.
-        EfficientPoseNMS<T, BoxCenterSize<T>><<<gridSize, blockSize, 0, stream>>>(param, topNumData, outputIndexData,
-            outputClassData, sortedIndexData, sortedScoresData, topClassData, topAnchorsData,
-            (BoxCenterSize<T>*) boxesInput, (BoxCenterSize<T>*) anchorsInput, numDetectionsOutput, nmsScoresOutput,
-            nmsClassesOutput, nmsIndicesOutput, (BoxCorner<T>*) nmsBoxesOutput);
+        EfficientPoseNMSClassMerge<T, Ti><<<param.batchSize, NMS_MERGE_THREADS, 0, stream>>>(param, topNumData,
+            outputIndexData, sortedScoresData, candidateBoxesData, candidateClassesData, candidateAnchorsData,
+            keypointsInput, keepData, numDetectionsOutput, nmsScoresOutput, nmsClassesOutput, onnxPositionsData,
+            (BoxCorner<T>*) nmsBoxesOutput, nmsKptsOutput);
     }
 
     if (param.outputONNXIndices)
     {
-        PadONNXResult<<<1, 1, 0, stream>>>(param, outputIndexData, nmsIndicesOutput);
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::onnxPad");
+        // The output segment of each image follows from the result counts, so that every output index (including
+        // the padding) can then be written independently, in a stable image and score order.
+        const unsigned int outputsPerBlock = 512;
+        const unsigned int outputBlocks
+            = ((size_t) param.batchSize * param.numOutputBoxes + outputsPerBlock - 1) / outputsPerBlock;
+        EfficientPoseNMSONNXOffsets<<<1, NMS_MERGE_THREADS, 0, stream>>>(param, outputIndexData, outputOffsetData);
+        EfficientPoseNMSONNXResult<Ti><<<outputBlocks, outputsPerBlock, 0, stream>>>(param, outputIndexData,
+            outputOffsetData, onnxPositionsData, candidateClassesData, candidateAnchorsData, nmsIndicesOutput);
+    }
+    else if (param.compactOutput)
+    {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::compact");
+        EfficientPoseNMSCompactResult<T, Ti><<<1, 256, 0, stream>>>(param, numDetectionsOutput, nmsOffsetsOutput,
+            nmsScoresOutput, nmsClassesOutput, (BoxCorner<T>*) nmsBoxesOutput, nmsKptsOutput,
+            3 * EfficientPoseNMSOutputKeypoints(param));
     }
 
     return cudaGetLastError();
 }
 
-__global__ void EfficientPoseNMSFilterSegments(EfficientPoseNMSParameters param, const int* __restrict__ topNumData,
-    int* __restrict__ topOffsetsStartData, int* __restrict__ topOffsetsEndData)
+__global__ void EfficientPoseNMSFilterSegments(EfficientPoseNMSParameters param, int sortChunkImages,
+    const int* __restrict__ topNumData, int* __restrict__ topOffsetsStartData, int* __restrict__ topOffsetsEndData)
 {
-    int imageIdx = threadIdx.x;
-    if (imageIdx > param.batchSize)
+    int imageIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    if (imageIdx >= param.batchSize)
     {
         return;
     }
-    topOffsetsStartData[imageIdx] = imageIdx * param.numScoreElements;
-    topOffsetsEndData[imageIdx] = imageIdx * param.numScoreElements + topNumData[imageIdx];
+    // Segment offsets are relative to the first image of the sort chunk, see EfficientPoseNMSSortChunkImages.
+    int segmentStart = (imageIdx % sortChunkImages) * param.numScoreElements;
+    topOffsetsStartData[imageIdx] = segmentStart;
+    topOffsetsEndData[imageIdx] = segmentStart + topNumData[imageIdx];
 }
 
-template <typename T>
+template <typename T, typename Ti>
+__device__ void FilterSelect(EfficientPoseNMSParameters param, int imageIdx, T score, int classIdx, int anchorIdx,
+    int* __restrict__ topNumData, int* __restrict__ topIndexData, int* __restrict__ topAnchorsData,
+    T* __restrict__ topScoresData, int* __restrict__ topClassData)
+{
+    // Use an atomic to find an open slot where to write the selected anchor data.
+    if (topNumData[imageIdx] >= param.numScoreElements)
+    {
+        return;
+    }
+    int selectedIdx = atomicAdd((unsigned int*) &topNumData[imageIdx], 1);
+    if (selectedIdx >= param.numScoreElements)
+    {
+        topNumData[imageIdx] = param.numScoreElements;
+        return;
+    }
+
+    // Shape of topScoresData / topClassData: [batchSize, numScoreElements]
+    Ti topIdx = (Ti) imageIdx * param.numScoreElements + selectedIdx;
+
+    if (param.scoreBits > 0)
+    {
+        score = add_mp(score, (T) 1);
+        if (gt_mp(score, (T) (2.f - 1.f / 1024.f)))
+        {
+            // Ensure the incremented score fits in the mantissa without changing the exponent
+            score = (2.f - 1.f / 1024.f);
+        }
+    }
+
+    topScoresData[topIdx] = score;
+    if (param.numClasses == 1)
+    {
+        // The anchor is the candidate id, so the sort directly yields the anchors, see MapNMSData.
+        topIndexData[topIdx] = anchorIdx;
+        return;
+    }
+    topIndexData[topIdx] = selectedIdx;
+    topAnchorsData[topIdx] = anchorIdx;
+    topClassData[topIdx] = classIdx;
+}
+
+template <typename T, typename Ti>
 __global__ void EfficientPoseNMSFilter(EfficientPoseNMSParameters param, const T* __restrict__ scoresInput,
     int* __restrict__ topNumData, int* __restrict__ topIndexData, int* __restrict__ topAnchorsData,
     T* __restrict__ topScoresData, int* __restrict__ topClassData)
@@ -406,16 +908,17 @@ __global__ void EfficientPoseNMSFilter(EfficientPoseNMSParameters param, const T
     }
 
     // Shape of scoresInput: [batchSize, numAnchors, numClasses]
-    int scoresInputIdx = imageIdx * param.numScoreElements + elementIdx;
+    Ti scoresInputIdx = (Ti) imageIdx * param.numScoreElements + elementIdx;
 
     // For each class, check its corresponding score if it crosses the threshold, and if so select this anchor,
     // and keep track of the maximum score and the corresponding (argmax) class id
     T score = scoresInput[scoresInputIdx];
     if (gte_mp(score, (T) param.scoreThreshold))
     {
-        // Unpack the class and anchor index from the element index
-        int classIdx = elementIdx % param.numClasses;
-        int anchorIdx = elementIdx / param.numClasses;
+        // Unpack the class and anchor index from the element index, which is the anchor itself for a single class.
+        const bool singleClass = param.numClasses == 1;
+        int classIdx = singleClass ? 0 : elementIdx % param.numClasses;
+        int anchorIdx = singleClass ? elementIdx : elementIdx / param.numClasses;
 
         // If this is a background class, ignore it.
         if (classIdx == param.backgroundClass)
@@ -423,42 +926,87 @@ __global__ void EfficientPoseNMSFilter(EfficientPoseNMSParameters param, const T
             return;
         }
 
-        // Use an atomic to find an open slot where to write the selected anchor data.
-        if (topNumData[imageIdx] >= param.numScoreElements)
-        {
-            return;
-        }
-        int selectedIdx = atomicAdd((unsigned int*) &topNumData[imageIdx], 1);
-        if (selectedIdx >= param.numScoreElements)
-        {
-            topNumData[imageIdx] = param.numScoreElements;
-            return;
-        }
+        FilterSelect<T, Ti>(param, imageIdx, score, classIdx, anchorIdx, topNumData, topIndexData, topAnchorsData,
+            topScoresData, topClassData);
+    }
+}
 
-        // Shape of topScoresData / topClassData: [batchSize, numScoreElements]
-        int topIdx = imageIdx * param.numScoreElements + selectedIdx;
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSArgmaxFilter(EfficientPoseNMSParameters param, const T* __restrict__ scoresInput,
+    int* __restrict__ topNumData, int* __restrict__ topIndexData, int* __restrict__ topAnchorsData,
+    T* __restrict__ topScoresData, int* __restrict__ topClassData)
+{
+    int anchorIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
 
-        if (param.scoreBits > 0)
+    // Boundary Conditions
+    if (anchorIdx >= param.numAnchors || imageIdx >= param.batchSize)
+    {
+        return;
+    }
+
+    // Each anchor is reduced to its highest scoring (non background) class, so that at most one candidate per anchor
+    // reaches the sort and NMS. Ties keep the lowest class.
+    Ti scoresInputIdx = (Ti) imageIdx * param.numScoreElements + (Ti) anchorIdx * param.numClasses;
+    int classIdx = -1;
+    T score = 0;
+    for (int c = 0; c < param.numClasses; c++)
+    {
+        T classScore = scoresInput[scoresInputIdx + c];
+        if (c != param.backgroundClass && (classIdx < 0 || gt_mp(classScore, score)))
         {
-            score = add_mp(score, (T) 1);
-            if (gt_mp(score, (T) (2.f - 1.f / 1024.f)))
-            {
-                // Ensure the incremented score fits in the mantissa without changing the exponent
-                score = (2.f - 1.f / 1024.f);
-            }
+            classIdx = c;
+            score = classScore;
         }
+    }
 
-        topIndexData[topIdx] = selectedIdx;
-        topAnchorsData[topIdx] = anchorIdx;
-        topScoresData[topIdx] = score;
-        topClassData[topIdx] = classIdx;
+    if (classIdx >= 0 && gte_mp(score, (T) param.scoreThreshold))
+    {
+        FilterSelect<T, Ti>(param, imageIdx, score, classIdx, anchorIdx, topNumData, topIndexData, topAnchorsData,
+            topScoresData, topClassData);
     }
 }
 
-template <typename T>
-__global__ void EfficientPoseNMSDenseIndex(EfficientPoseNMSParameters param, int* __restrict__ topNumData,
-    int* __restrict__ topIndexData, int* __restrict__ topAnchorsData, int* __restrict__ topOffsetsStartData,
-    int* __restrict__ topOffsetsEndData, T* __restrict__ topScoresData, int* __restrict__ topClassData)
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSSparseFilter(EfficientPoseNMSParameters param, const T* __restrict__ scoresInput,
+    const int* __restrict__ candidateIndicesInput, const int* __restrict__ candidateCountsInput,
+    int* __restrict__ topNumData, int* __restrict__ topIndexData, int* __restrict__ topAnchorsData,
+    T* __restrict__ topScoresData, int* __restrict__ topClassData)
+{
+    int listIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
+
+    // Boundary Conditions
+    if (listIdx >= param.numScoreElements || imageIdx >= param.batchSize || listIdx >= candidateCountsInput[imageIdx])
+    {
+        return;
+    }
+
+    // Shape of scoresInput: [batchSize, numScoreElements], and of candidateIndicesInput: [batchSize,
+    // numScoreElements, 2], holding the (anchor, class) of each listed score. The listed candidates go through the
+    // same tests as the dense ones, and the ones outside of the anchors or classes are dropped.
+    Ti listInputIdx = (Ti) imageIdx * param.numScoreElements + listIdx;
+    int anchorIdx = candidateIndicesInput[2 * listInputIdx];
+    int classIdx = candidateIndicesInput[2 * listInputIdx + 1];
+    if (anchorIdx < 0 || anchorIdx >= param.numAnchors || classIdx < 0 || classIdx >= param.numClasses
+        || classIdx == param.backgroundClass)
+    {
+        return;
+    }
+
+    T score = scoresInput[listInputIdx];
+    if (gte_mp(score, (T) param.scoreThreshold))
+    {
+        FilterSelect<T, Ti>(param, imageIdx, score, classIdx, anchorIdx, topNumData, topIndexData, topAnchorsData,
+            topScoresData, topClassData);
+    }
+}
+
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSDenseIndex(EfficientPoseNMSParameters param, int sortChunkImages,
+    int* __restrict__ topNumData, int* __restrict__ topIndexData, int* __restrict__ topAnchorsData,
+    int* __restrict__ topOffsetsStartData, int* __restrict__ topOffsetsEndData, T* __restrict__ topScoresData,
+    int* __restrict__ topClassData)
 {
     int elementIdx = blockDim.x * blockIdx.x + threadIdx.x;
     int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
@@ -468,9 +1016,10 @@ __global__ void EfficientPoseNMSDenseIndex(EfficientPoseNMSParameters param, int
         return;
     }
 
-    int dataIdx = imageIdx * param.numScoreElements + elementIdx;
-    int anchorIdx = elementIdx / param.numClasses;
-    int classIdx = elementIdx % param.numClasses;
+    Ti dataIdx = (Ti) imageIdx * param.numScoreElements + elementIdx;
+    const bool singleClass = param.numClasses == 1;
+    int anchorIdx = singleClass ? elementIdx : elementIdx / param.numClasses;
+    int classIdx = singleClass ? 0 : elementIdx % param.numClasses;
     if (param.scoreBits > 0)
     {
         T score = topScoresData[dataIdx];
@@ -507,20 +1056,24 @@ __global__ void EfficientPoseNMSDenseIndex(EfficientPoseNMSParameters param, int
     }
 
     topIndexData[dataIdx] = elementIdx;
-    topAnchorsData[dataIdx] = anchorIdx;
-    topClassData[dataIdx] = classIdx;
+    if (!singleClass)
+    {
+        topAnchorsData[dataIdx] = anchorIdx;
+        topClassData[dataIdx] = classIdx;
+    }
 
     if (elementIdx == 0)
     {
         // Saturate counters
         topNumData[imageIdx] = param.numScoreElements;
-        topOffsetsStartData[imageIdx] = imageIdx * param.numScoreElements;
-        topOffsetsEndData[imageIdx] = (imageIdx + 1) * param.numScoreElements;
+        topOffsetsStartData[imageIdx] = (imageIdx % sortChunkImages) * param.numScoreElements;
+        topOffsetsEndData[imageIdx] = (imageIdx % sortChunkImages + 1) * param.numScoreElements;
     }
 }
 
-template <typename T>
-cudaError_t EfficientPoseNMSFilterLauncher(EfficientPoseNMSParameters& param, const T* scoresInput, int* topNumData,
+template <typename T, typename Ti>
+cudaError_t EfficientPoseNMSFilterLauncher(const EfficientPoseNMSParameters& param, int sortChunkImages,
+    const T* scoresInput, const int* candidateIndicesInput, const int* candidateCountsInput, int* topNumData,
     int* topIndexData, int* topAnchorsData, int* topOffsetsStartData, int* topOffsetsEndData, T* topScoresData,
     int* topClassData, cudaStream_t stream)
 {
@@ -531,86 +1084,411 @@ cudaError_t EfficientPoseNMSFilterLauncher(EfficientPoseNMSParameters& param, co
     const dim3 blockSize = {elementsPerBlock, imagesPerBlock, 1};
     const dim3 gridSize = {elementBlocks, imageBlocks, 1};
 
+    // With sigmoid scores, param.scoreThreshold is already in the raw score space, see EfficientPoseNMSInference.
     float kernelSelectThreshold = 0.007f;
     if (param.scoreSigmoid)
     {
-        // Inverse Sigmoid
-        if (param.scoreThreshold <= 0.f)
-        {
-            param.scoreThreshold = -(1 << 15);
-        }
-        else
-        {
-            param.scoreThreshold = logf(param.scoreThreshold / (1.f - param.scoreThreshold));
-        }
         kernelSelectThreshold = logf(kernelSelectThreshold / (1.f - kernelSelectThreshold));
-        // Disable Score Bits Optimization
-        param.scoreBits = -1;
     }
 
-    if (param.scoreThreshold < kernelSelectThreshold)
+    if (param.sparseInput)
+    {
+        // The candidates are already listed, so only the listed ones are tested, and there is no dense path.
+        EfficientPoseNMSSparseFilter<T, Ti><<<gridSize, blockSize, 0, stream>>>(param, scoresInput,
+            candidateIndicesInput, candidateCountsInput, topNumData, topIndexData, topAnchorsData, topScoresData,
+            topClassData);
+
+        const unsigned int segmentBlocks = (param.batchSize + 255) / 256;
+        EfficientPoseNMSFilterSegments<<<segmentBlocks, 256, 0, stream>>>(
+            param, sortChunkImages, topNumData, topOffsetsStartData, topOffsetsEndData);
+    }
+    else if (param.classArgmax && param.numClasses > 1)
+    {
+        // With at most one candidate per anchor, the sparse selection is always used.
+        const unsigned int anchorBlocks = (param.numAnchors + elementsPerBlock - 1) / elementsPerBlock;
+        const dim3 anchorGridSize = {anchorBlocks, imageBlocks, 1};
+        EfficientPoseNMSArgmaxFilter<T, Ti><<<anchorGridSize, blockSize, 0, stream>>>(
+            param, scoresInput, topNumData, topIndexData, topAnchorsData, topScoresData, topClassData);
+
+        const unsigned int segmentBlocks = (param.batchSize + 255) / 256;
+        EfficientPoseNMSFilterSegments<<<segmentBlocks, 256, 0, stream>>>(
+            param, sortChunkImages, topNumData, topOffsetsStartData, topOffsetsEndData);
+    }
+    else if (param.scoreThreshold < kernelSelectThreshold)
     {
         // A full copy of the buffer is necessary because sorting will scramble the input data otherwise.
         PLUGIN_CHECK_CUDA(cudaMemcpyAsync(topScoresData, scoresInput,
-            param.batchSize * param.numScoreElements * sizeof(T), cudaMemcpyDeviceToDevice, stream));
+            (size_t) param.batchSize * param.numScoreElements * sizeof(T), cudaMemcpyDeviceToDevice, stream));
 
-        EfficientPoseNMSDenseIndex<T><<<gridSize, blockSize, 0, stream>>>(param, topNumData, topIndexData, topAnchorsData,
-            topOffsetsStartData, topOffsetsEndData, topScoresData, topClassData);
+        EfficientPoseNMSDenseIndex<T, Ti><<<gridSize, blockSize, 0, stream>>>(param, sortChunkImages, topNumData,
+            topIndexData, topAnchorsData, topOffsetsStartData, topOffsetsEndData, topScoresData, topClassData);
     }
     else
     {
-        EfficientPoseNMSFilter<T><<<gridSize, blockSize, 0, stream>>>(
+        EfficientPoseNMSFilter<T, Ti><<<gridSize, blockSize, 0, stream>>>(
             param, scoresInput, topNumData, topIndexData, topAnchorsData, topScoresData, topClassData);
 
-        EfficientPoseNMSFilterSegments<<<1, param.batchSize, 0, stream>>>(
-            param, topNumData, topOffsetsStartData, topOffsetsEndData);
+        const unsigned int segmentBlocks = (param.batchSize + 255) / 256;
+        EfficientPoseNMSFilterSegments<<<segmentBlocks, 256, 0, stream>>>(
+            param, sortChunkImages, topNumData, topOffsetsStartData, topOffsetsEndData);
+    }
+
+    return cudaGetLastError();
+}
+
+__device__ __inline__ unsigned int ScoreBitsKey(const float score, const int scoreBits)
+{
+    return (__float_as_uint(score) >> (23 - scoreBits)) & ((1u << scoreBits) - 1);
+}
+
+__device__ __inline__ unsigned int ScoreBitsKey(const __half score, const int scoreBits)
+{
+    return (__half_as_ushort(score) >> (10 - scoreBits)) & ((1u << scoreBits) - 1);
+}
+
+__device__ __inline__ unsigned int WarpPeers(const unsigned int key, const bool valid)
+{
+    // The lanes of the warp with a valid key equal to that of this lane, or none for an invalid lane.
+#if __CUDA_ARCH__ >= 700
+    unsigned int peers = __match_any_sync(0xFFFFFFFFu, valid ? key : 0xFFFFFFFFu);
+    return valid ? peers : 0u;
+#else
+    unsigned int peers = 0u;
+    unsigned int remaining = __ballot_sync(0xFFFFFFFFu, valid);
+    while (remaining != 0u)
+    {
+        unsigned int leaderKey = __shfl_sync(0xFFFFFFFFu, key, __ffs(remaining) - 1);
+        unsigned int group = __ballot_sync(0xFFFFFFFFu, valid && key == leaderKey);
+        if (valid && key == leaderKey)
+        {
+            peers = group;
+        }
+        remaining &= ~group;
+    }
+    return peers;
+#endif
+}
+
+template <typename T, typename Ti>
+__global__ void EfficientPoseNMSCountingSort(EfficientPoseNMSParameters param,
+    const int* __restrict__ topOffsetsStartData, const int* __restrict__ topOffsetsEndData,
+    const T* __restrict__ topScoresData, const int* __restrict__ topIndexData, T* __restrict__ sortedScoresData,
+    int* __restrict__ sortedIndexData)
+{
+    // With the score bits optimization, only the top scoreBits bits of the mantissa take part in the sort, so there
+    // are at most 1024 distinct keys. Each block sorts the segment of one image with a shared memory histogram,
+    // a block wide prefix sum and a stable scatter, instead of the multiple passes of the radix sort.
+    typedef cub::BlockScan<int, COUNTING_SORT_THREADS> BlockScan;
+    __shared__ typename BlockScan::TempStorage scanStorage;
+    __shared__ int bucketOffsets[COUNTING_SORT_THREADS];
+
+    // The segment offsets are relative to the sort chunk, so only the segment length is taken from them.
+    int imageIdx = blockIdx.x;
+    Ti segmentStart = (Ti) imageIdx * param.numScoreElements;
+    Ti segmentEnd = segmentStart + (topOffsetsEndData[imageIdx] - topOffsetsStartData[imageIdx]);
+    int numBuckets = 1 << param.scoreBits;
+
+    bucketOffsets[threadIdx.x] = 0;
+    __syncthreads();
+    for (Ti idx = segmentStart + threadIdx.x; idx < segmentEnd; idx += blockDim.x)
+    {
+        atomicAdd(&bucketOffsets[ScoreBitsKey(topScoresData[idx], param.scoreBits)], 1);
+    }
+    __syncthreads();
+
+    // Buckets are scanned from the highest key down, as the scores are sorted in descending order.
+    int bucket = numBuckets - 1 - (int) threadIdx.x;
+    int count = bucket >= 0 ? bucketOffsets[bucket] : 0;
+    int offset;
+    BlockScan(scanStorage).ExclusiveSum(count, offset);
+    __syncthreads();
+    if (bucket >= 0)
+    {
+        bucketOffsets[bucket] = offset;
+    }
+    __syncthreads();
+
+    // Equal keys keep their order in the segment, as in the radix sort, so that ties are sorted deterministically.
+    // The segment is scattered in chunks of one element per thread, and the warps of a chunk take turns, in order.
+    // Within a warp, the lanes with the same key take consecutive slots of their bucket in lane order, and the lowest
+    // of them then moves the bucket offset past them all.
+    unsigned int warpIdx = threadIdx.x / 32;
+    unsigned int lanesBelow = (1u << (threadIdx.x % 32)) - 1;
+    for (Ti chunk = segmentStart; chunk < segmentEnd; chunk += blockDim.x)
+    {
+        Ti idx = chunk + threadIdx.x;
+        bool valid = idx < segmentEnd;
+        T score;
+        unsigned int key = 0;
+        if (valid)
+        {
+            score = topScoresData[idx];
+            key = ScoreBitsKey(score, param.scoreBits);
+        }
+        unsigned int peers = WarpPeers(key, valid);
+        for (unsigned int turn = 0; turn < blockDim.x / 32; turn++)
+        {
+            if (warpIdx == turn)
+            {
+                if (valid)
+                {
+                    Ti sortedIdx = segmentStart + bucketOffsets[key] + __popc(peers & lanesBelow);
+                    sortedScoresData[sortedIdx] = score;
+                    sortedIndexData[sortedIdx] = topIndexData[idx];
+                }
+                __syncwarp();
+                if (valid && (peers & lanesBelow) == 0u)
+                {
+                    bucketOffsets[key] += __popc(peers);
+                }
+            }
+            __syncthreads();
+        }
+    }
+}
+
+template <typename T, typename Ti>
+cudaError_t EfficientPoseNMSCountingSortLauncher(const EfficientPoseNMSParameters& param, int* topOffsetsStartData,
+    int* topOffsetsEndData, cub::DoubleBuffer<T>& scoresDB, cub::DoubleBuffer<int>& indexDB, cudaStream_t stream)
+{
+    EfficientPoseNMSCountingSort<T, Ti><<<param.batchSize, COUNTING_SORT_THREADS, 0, stream>>>(param,
+        topOffsetsStartData, topOffsetsEndData, scoresDB.Current(), indexDB.Current(), scoresDB.Alternate(),
+        indexDB.Alternate());
+
+    // Same convention as the cub sorts, the sorted data is found in the current buffers.
+    scoresDB.selector ^= 1;
+    indexDB.selector ^= 1;
+
+    return cudaGetLastError();
+}
+
+int EfficientPoseNMSSortChunkImages(int batchSize, int numScoreElements)
+{
+    // The cub segmented sorts take the number of items as an int, so when the whole batch is too large for that, the
+    // batch is sorted in chunks of as many images as fit. Segment offsets are relative to the start of their chunk.
+    return std::max(1, std::min(batchSize, INT_MAX / std::max(1, numScoreElements)));
+}
+
+template <typename Tk, typename Tv>
+cudaError_t EfficientPoseNMSSegmentedSortLauncher(const EfficientPoseNMSParameters& param, bool descending, int endBit,
+    int* segmentStartData, int* segmentEndData, cub::DoubleBuffer<Tk>& keysDB, cub::DoubleBuffer<Tv>& valuesDB,
+    void* sortedWorkspaceData, size_t sortedWorkspaceSize, cudaStream_t stream)
+{
+    const int chunkImages = EfficientPoseNMSSortChunkImages(param.batchSize, param.numScoreElements);
+    int selector = keysDB.selector;
+    for (int chunkStart = 0; chunkStart < param.batchSize; chunkStart += chunkImages)
+    {
+        const int numImages = std::min(chunkImages, param.batchSize - chunkStart);
+        const size_t chunkOffset = (size_t) chunkStart * param.numScoreElements;
+        cub::DoubleBuffer<Tk> chunkKeysDB(keysDB.d_buffers[0] + chunkOffset, keysDB.d_buffers[1] + chunkOffset);
+        cub::DoubleBuffer<Tv> chunkValuesDB(valuesDB.d_buffers[0] + chunkOffset, valuesDB.d_buffers[1] + chunkOffset);
+        chunkKeysDB.selector = keysDB.selector;
+        chunkValuesDB.selector = valuesDB.selector;
+        cudaError_t status;
+        if (descending)
+        {
+            status = cub::DeviceSegmentedRadixSort::SortPairsDescending(sortedWorkspaceData, sortedWorkspaceSize,
+                chunkKeysDB, chunkValuesDB, numImages * param.numScoreElements, numImages,
+                segmentStartData + chunkStart, segmentEndData + chunkStart, 0, endBit, stream);
+        }
+        else
+        {
+            status = cub::DeviceSegmentedRadixSort::SortPairs(sortedWorkspaceData, sortedWorkspaceSize, chunkKeysDB,
+                chunkValuesDB, numImages * param.numScoreElements, numImages, segmentStartData + chunkStart,
+                segmentEndData + chunkStart, 0, endBit, stream);
+        }
+        if (status != cudaSuccess)
+        {
+            return status;
+        }
+        // Every chunk goes through the same number of passes, so they all end up in the same buffer.
+        selector = chunkKeysDB.selector;
+    }
+    keysDB.selector = selector;
+    valuesDB.selector = selector;
+
+    return cudaSuccess;
+}
+
+template <typename Ti>
+__global__ void EfficientPoseNMSClassKeys(EfficientPoseNMSParameters param, int sortChunkImages,
+    const int* __restrict__ topNumData, const int* __restrict__ candidateClassesData, int* __restrict__ classKeysData,
+    int* __restrict__ classPositionsData, int* __restrict__ partitionStartData, int* __restrict__ partitionEndData)
+{
+    int elementIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
+
+    if (elementIdx >= param.numScoreElements || imageIdx >= param.batchSize)
+    {
+        return;
+    }
+
+    // Only the candidates that NMS would look at take part in the partition.
+    int numSelectedBoxes = min(topNumData[imageIdx], param.numSelectedBoxes);
+    if (elementIdx == 0)
+    {
+        partitionStartData[imageIdx] = (imageIdx % sortChunkImages) * param.numScoreElements;
+        partitionEndData[imageIdx] = (imageIdx % sortChunkImages) * param.numScoreElements + numSelectedBoxes;
+    }
+    if (elementIdx >= numSelectedBoxes)
+    {
+        return;
+    }
+
+    Ti dataIdx = (Ti) imageIdx * param.numScoreElements + elementIdx;
+    classKeysData[dataIdx] = candidateClassesData[dataIdx];
+    classPositionsData[dataIdx] = elementIdx;
+}
+
+template <typename Ti>
+__global__ void EfficientPoseNMSClassSegments(EfficientPoseNMSParameters param, const int* __restrict__ topNumData,
+    const int* __restrict__ classKeysData, int* __restrict__ classStartData, int* __restrict__ classEndData)
+{
+    int elementIdx = blockDim.x * blockIdx.x + threadIdx.x;
+    int imageIdx = blockDim.y * blockIdx.y + threadIdx.y;
+
+    if (elementIdx >= param.numScoreElements || imageIdx >= param.batchSize)
+    {
+        return;
+    }
+
+    int numSelectedBoxes = min(topNumData[imageIdx], param.numSelectedBoxes);
+    if (elementIdx >= numSelectedBoxes)
+    {
+        return;
+    }
+
+    // The keys are sorted, so each class segment starts and ends where the key changes. Classes without candidates
+    // keep the cleared (empty) segment.
+    Ti dataIdx = (Ti) imageIdx * param.numScoreElements + elementIdx;
+    int classIdx = classKeysData[dataIdx];
+    int classCounterIdx = imageIdx * param.numClasses + classIdx;
+    if (elementIdx == 0 || classKeysData[dataIdx - 1] != classIdx)
+    {
+        classStartData[classCounterIdx] = elementIdx;
+    }
+    if (elementIdx == numSelectedBoxes - 1 || classKeysData[dataIdx + 1] != classIdx)
+    {
+        classEndData[classCounterIdx] = elementIdx + 1;
+    }
+}
+
+size_t EfficientPoseNMSClassSortWorkspaceSize(int batchSize, int numScoreElements)
+{
+    int sortChunkImages = EfficientPoseNMSSortChunkImages(batchSize, numScoreElements);
+    size_t sortedWorkspaceSize = 0;
+    cub::DoubleBuffer<int> keysDB(nullptr, nullptr);
+    cub::DoubleBuffer<int> valuesDB(nullptr, nullptr);
+    cub::DeviceSegmentedRadixSort::SortPairs(nullptr, sortedWorkspaceSize, keysDB, valuesDB,
+        sortChunkImages * numScoreElements, sortChunkImages, (const int*) nullptr, (const int*) nullptr);
+    return sortedWorkspaceSize;
+}
+
+template <typename Ti>
+cudaError_t EfficientPoseNMSClassPartitionLauncher(const EfficientPoseNMSParameters& param, int* topNumData,
+    int* candidateClassesData, int* partitionStartData, int* partitionEndData, int* classStartData, int* classEndData,
+    cub::DoubleBuffer<int>& classKeysDB, cub::DoubleBuffer<int>& classPositionsDB, void* sortedWorkspaceData,
+    size_t sortedWorkspaceSize, cudaStream_t stream)
+{
+    const unsigned int elementsPerBlock = 512;
+    const unsigned int imagesPerBlock = 1;
+    const unsigned int elementBlocks = (param.numScoreElements + elementsPerBlock - 1) / elementsPerBlock;
+    const unsigned int imageBlocks = (param.batchSize + imagesPerBlock - 1) / imagesPerBlock;
+    const dim3 blockSize = {elementsPerBlock, imagesPerBlock, 1};
+    const dim3 gridSize = {elementBlocks, imageBlocks, 1};
+
+    EfficientPoseNMSClassKeys<Ti><<<gridSize, blockSize, 0, stream>>>(param,
+        EfficientPoseNMSSortChunkImages(param.batchSize, param.numScoreElements), topNumData, candidateClassesData,
+        classKeysDB.Current(), classPositionsDB.Current(), partitionStartData, partitionEndData);
+
+    // Radix sorting is stable, so the candidates of each class remain in descending score order.
+    int classBits = 1;
+    while ((1 << classBits) < param.numClasses)
+    {
+        classBits++;
+    }
+    cudaError_t status = EfficientPoseNMSSegmentedSortLauncher<int, int>(param, false, classBits, partitionStartData,
+        partitionEndData, classKeysDB, classPositionsDB, sortedWorkspaceData, sortedWorkspaceSize, stream);
+    if (status != cudaSuccess)
+    {
+        return status;
     }
 
+    EfficientPoseNMSClassSegments<Ti><<<gridSize, blockSize, 0, stream>>>(
+        param, topNumData, classKeysDB.Current(), classStartData, classEndData);
+
     return cudaGetLastError();
 }
 
 template <typename T>
 size_t EfficientPoseNMSSortWorkspaceSize(int batchSize, int numScoreElements)
 {
+    int sortChunkImages = EfficientPoseNMSSortChunkImages(batchSize, numScoreElements);
     size_t sortedWorkspaceSize = 0;
     cub::DoubleBuffer<T> keysDB(nullptr, nullptr);
     cub::DoubleBuffer<int> valuesDB(nullptr, nullptr);
     cub::DeviceSegmentedRadixSort::SortPairsDescending(nullptr, sortedWorkspaceSize, keysDB, valuesDB,
-        numScoreElements, batchSize, (const int*) nullptr, (const int*) nullptr);
+        sortChunkImages * numScoreElements, sortChunkImages, (const int*) nullptr, (const int*) nullptr);
     return sortedWorkspaceSize;
 }
 
-size_t EfficientPoseNMSWorkspaceSize(int batchSize, int numScoreElements, int numClasses, DataType datatype)
+size_t EfficientPoseNMSWorkspaceSize(int batchSize, int numScoreElements, int numClasses, DataType datatype,
+    int numKeypoints)
 {
     size_t total = 0;
     const size_t align = 256;
     // Counters
     // 3 for Filtering
-    // 1 for Output Indexing
+    // 2 for Output Indexing
     // C for Max per Class Limiting
-    size_t size = (3 + 1 + numClasses) * batchSize * sizeof(int);
+    // 2 * C + 2 for Class Partitioning
+    size_t size = (3 + 2 + numClasses + 2 * numClasses + 2) * (size_t) batchSize * sizeof(int);
     total += size + (size % align ? align - (size % align) : 0);
-    // Int Buffers
-    for (int i = 0; i < 4; i++)
+    // Int Buffers, without the class and anchor buffers for a single class
+    for (int i = 0; i < (numClasses > 1 ? 4 : 2); i++)
     {
-        size = batchSize * numScoreElements * sizeof(int);
+        size = (size_t) batchSize * numScoreElements * sizeof(int);
         total += size + (size % align ? align - (size % align) : 0);
     }
     // Float Buffers
     for (int i = 0; i < 2; i++)
     {
-        size = batchSize * numScoreElements * dataTypeSize(datatype);
+        size = (size_t) batchSize * numScoreElements * dataTypeSize(datatype);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+    // Candidate Buffers: boxes, areas, classes and anchors
+    size = (size_t) batchSize * numScoreElements * 4 * dataTypeSize(datatype);
+    total += size + (size % align ? align - (size % align) : 0);
+    for (int i = 0; i < 3; i++)
+    {
+        size = (size_t) batchSize * numScoreElements * sizeof(int);
         total += size + (size % align ? align - (size % align) : 0);
     }
-    // Sort Workspace
+    // Sort Workspace, which is shared by the score sort and the class partition sort
+    size = 0;
     if (datatype == DataType::kHALF)
     {
         size = EfficientPoseNMSSortWorkspaceSize<__half>(batchSize, numScoreElements);
-        total += size + (size % align ? align - (size % align) : 0);
     }
     else if (datatype == DataType::kFLOAT)
     {
         size = EfficientPoseNMSSortWorkspaceSize<float>(batchSize, numScoreElements);
+    }
+    if (numClasses > 1)
+    {
+        size = std::max(size, EfficientPoseNMSClassSortWorkspaceSize(batchSize, numScoreElements));
+    }
+    total += size + (size % align ? align - (size % align) : 0);
+    // Class Partition Buffers
+    for (int i = 0; numClasses > 1 && i < 4; i++)
+    {
+        size = (size_t) batchSize * numScoreElements * sizeof(int);
+        total += size + (size % align ? align - (size % align) : 0);
+    }
+    // Candidate Keypoints, only for OKS suppression
+    if (numKeypoints > 0)
+    {
+        size = (size_t) batchSize * numScoreElements * 3 * numKeypoints * sizeof(float);
         total += size + (size % align ? align - (size % align) : 0);
     }
 
@@ -628,23 +1506,50 @@ T* EfficientPoseNMSWorkspace(void* workspace, size_t& offset, size_t elements)
     return buffer;
 }
 
-template <typename T>
+template <typename T, typename Ti>
 pluginStatus_t EfficientPoseNMSDispatch(EfficientPoseNMSParameters param, const void* boxesInput, const void* scoresInput,
-    const void* anchorsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput,
-    void* nmsClassesOutput, void* nmsIndicesOutput, void* workspace, cudaStream_t stream)
+    const int* candidateIndicesInput, const int* candidateCountsInput, const void* anchorsInput,
+    const void* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput,
+    void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    void* workspace, cudaStream_t stream)
 {
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS");
+
     // Clear Outputs (not all elements will get overwritten by the kernels, so safer to clear everything out)
-    if (param.outputONNXIndices)
+    // The ONNX indices are always written in full by EfficientPoseNMSONNXResult, so they only need clearing when
+    // there is nothing to run NMS on.
     {
-        CSC(cudaMemsetAsync(nmsIndicesOutput, 0xFF, param.batchSize * param.numOutputBoxes * 3 * sizeof(int), stream), STATUS_FAILURE);
-    }
-    else
-    {
-        CSC(cudaMemsetAsync(numDetectionsOutput, 0x00, param.batchSize * sizeof(int), stream), STATUS_FAILURE);
-        CSC(cudaMemsetAsync(nmsScoresOutput, 0x00, param.batchSize * param.numOutputBoxes * sizeof(T), stream), STATUS_FAILURE);
-        CSC(cudaMemsetAsync(nmsBoxesOutput, 0x00, param.batchSize * param.numOutputBoxes * 4 * sizeof(T), stream), STATUS_FAILURE);
-        CSC(cudaMemsetAsync(nmsKptsOutput, 0x00, param.batchSize * param.numOutputBoxes * 3 * sizeof(T), stream), STATUS_FAILURE);
-        CSC(cudaMemsetAsync(nmsClassesOutput, 0x00, param.batchSize * param.numOutputBoxes * sizeof(int), stream), STATUS_FAILURE);
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::clearOutputs");
+        if (param.outputONNXIndices)
+        {
+            if (param.numScoreElements < 1)
+            {
+                CSC(cudaMemsetAsync(nmsIndicesOutput, 0xFF, (size_t) param.batchSize * param.numOutputBoxes * 3 * sizeof(int), stream), STATUS_FAILURE);
+            }
+        }
+        else if (param.compactOutput)
+        {
+            // Compacted results are only valid up to the total detection count, so only the counters need clearing.
+            CSC(cudaMemsetAsync(numDetectionsOutput, 0x00, param.batchSize * sizeof(int), stream), STATUS_FAILURE);
+            if (nmsOffsetsOutput != nullptr)
+            {
+                CSC(cudaMemsetAsync(nmsOffsetsOutput, 0x00, (param.batchSize + 1) * sizeof(int), stream), STATUS_FAILURE);
+            }
+        }
+        else if (param.packedOutput)
+        {
+            CSC(cudaMemsetAsync(numDetectionsOutput, 0x00, param.batchSize * sizeof(int), stream), STATUS_FAILURE);
+            CSC(cudaMemsetAsync(nmsBoxesOutput, 0x00, (size_t) param.batchSize * param.numOutputBoxes * sizeof(EfficientPoseNMSPackedDetection), stream), STATUS_FAILURE);
+        }
+        else
+        {
+            const int numCounts = param.classMajorOutput ? param.numClasses : 1;
+            CSC(cudaMemsetAsync(numDetectionsOutput, 0x00, (size_t) param.batchSize * numCounts * sizeof(int), stream), STATUS_FAILURE);
+            CSC(cudaMemsetAsync(nmsScoresOutput, 0x00, (size_t) param.batchSize * param.numOutputBoxes * sizeof(T), stream), STATUS_FAILURE);
+            CSC(cudaMemsetAsync(nmsBoxesOutput, 0x00, (size_t) param.batchSize * param.numOutputBoxes * 4 * sizeof(T), stream), STATUS_FAILURE);
+            CSC(cudaMemsetAsync(nmsKptsOutput, 0x00, (size_t) param.batchSize * param.numOutputBoxes * 3 * EfficientPoseNMSOutputKeypoints(param) * sizeof(T), stream), STATUS_FAILURE);
+            CSC(cudaMemsetAsync(nmsClassesOutput, 0x00, (size_t) param.batchSize * param.numOutputBoxes * sizeof(int), stream), STATUS_FAILURE);
+        }
     }
 
     // Empty Inputs
@@ -655,60 +1560,215 @@ pluginStatus_t EfficientPoseNMSDispatch(EfficientPoseNMSParameters param, const
 
     // Counters Workspace
     size_t workspaceOffset = 0;
-    int countersTotalSize = (3 + 1 + param.numClasses) * param.batchSize;
+    size_t countersTotalSize = (size_t) (3 + 2 + param.numClasses + 2 * param.numClasses + 2) * param.batchSize;
     int* topNumData = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, countersTotalSize);
     int* topOffsetsStartData = topNumData + param.batchSize;
     int* topOffsetsEndData = topNumData + 2 * param.batchSize;
     int* outputIndexData = topNumData + 3 * param.batchSize;
-    int* outputClassData = topNumData + 4 * param.batchSize;
+    int* outputOffsetData = topNumData + 4 * param.batchSize;
+    int* outputClassData = topNumData + 5 * param.batchSize;
+    int* classStartData = outputClassData + param.numClasses * param.batchSize;
+    int* classEndData = classStartData + param.numClasses * param.batchSize;
+    int* partitionStartData = classEndData + param.numClasses * param.batchSize;
+    int* partitionEndData = partitionStartData + param.batchSize;
     CSC(cudaMemsetAsync(topNumData, 0x00, countersTotalSize * sizeof(int), stream), STATUS_FAILURE);
     cudaError_t status = cudaGetLastError();
     CSC(status, STATUS_FAILURE);
 
     // Other Buffers Workspace
+    const size_t numScoreBuffer = (size_t) param.batchSize * param.numScoreElements;
     int* topIndexData
-        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
-    int* topClassData
-        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
-    int* topAnchorsData
-        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
+        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+    // With a single class, the class of every candidate is 0 and its anchor is its element index, so these are not
+    // needed, see EfficientPoseNMSFilter.
+    int* topClassData = nullptr;
+    int* topAnchorsData = nullptr;
+    if (param.numClasses > 1)
+    {
+        topClassData = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+        topAnchorsData = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+    }
     int* sortedIndexData
-        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
-    T* topScoresData = EfficientPoseNMSWorkspace<T>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
+        = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+    T* topScoresData = EfficientPoseNMSWorkspace<T>(workspace, workspaceOffset, numScoreBuffer);
     T* sortedScoresData
-        = EfficientPoseNMSWorkspace<T>(workspace, workspaceOffset, param.batchSize * param.numScoreElements);
+        = EfficientPoseNMSWorkspace<T>(workspace, workspaceOffset, numScoreBuffer);
     size_t sortedWorkspaceSize = EfficientPoseNMSSortWorkspaceSize<T>(param.batchSize, param.numScoreElements);
+    if (param.numClasses > 1)
+    {
+        sortedWorkspaceSize = std::max(
+            sortedWorkspaceSize, EfficientPoseNMSClassSortWorkspaceSize(param.batchSize, param.numScoreElements));
+    }
     char* sortedWorkspaceData = EfficientPoseNMSWorkspace<char>(workspace, workspaceOffset, sortedWorkspaceSize);
     cub::DoubleBuffer<T> scoresDB(topScoresData, sortedScoresData);
     cub::DoubleBuffer<int> indexDB(topIndexData, sortedIndexData);
 
+    // Candidate Workspace
+    // The candidates NMS looks at, decoded and laid out in score order by EfficientPoseNMSGather.
+    BoxCorner<T>* candidateBoxesData
+        = EfficientPoseNMSWorkspace<BoxCorner<T>>(workspace, workspaceOffset, numScoreBuffer);
+    float* candidateAreasData = EfficientPoseNMSWorkspace<float>(workspace, workspaceOffset, numScoreBuffer);
+    int* candidateClassesData = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+    int* candidateAnchorsData = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+
+    // Class Partition Workspace
+    // Without class agnostic NMS, classes never suppress each other, so each class can be swept independently.
+    bool classPartitioned = !param.classAgnostic && param.numClasses > 1;
+    cub::DoubleBuffer<int> classKeysDB(nullptr, nullptr);
+    cub::DoubleBuffer<int> classPositionsDB(nullptr, nullptr);
+    if (classPartitioned)
+    {
+        int* classKeysData[2];
+        int* classPositionsData[2];
+        for (int i = 0; i < 2; i++)
+        {
+            classKeysData[i]
+                = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+            classPositionsData[i]
+                = EfficientPoseNMSWorkspace<int>(workspace, workspaceOffset, numScoreBuffer);
+        }
+        classKeysDB = cub::DoubleBuffer<int>(classKeysData[0], classKeysData[1]);
+        classPositionsDB = cub::DoubleBuffer<int>(classPositionsData[0], classPositionsData[1]);
+    }
+
+    // Candidate Keypoints Workspace, only for OKS suppression
+    float* candidateKeypointsData = nullptr;
+    if (param.oksThreshold >= 0.f)
+    {
+        candidateKeypointsData = EfficientPoseNMSWorkspace<float>(
+            workspace, workspaceOffset, numScoreBuffer * 3 * param.numKeypoints);
+    }
+
     // Kernels
-    status = EfficientPoseNMSFilterLauncher<T>(param, (T*) scoresInput, topNumData, topIndexData, topAnchorsData,
-        topOffsetsStartData, topOffsetsEndData, topScoresData, topClassData, stream);
-    CSC(status, STATUS_FAILURE);
+    {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::filter");
+        status = EfficientPoseNMSFilterLauncher<T, Ti>(param,
+            EfficientPoseNMSSortChunkImages(param.batchSize, param.numScoreElements), (T*) scoresInput,
+            candidateIndicesInput, candidateCountsInput, topNumData, topIndexData, topAnchorsData, topOffsetsStartData,
+            topOffsetsEndData, topScoresData, topClassData, stream);
+        CSC(status, STATUS_FAILURE);
+    }
 
-    status = cub::DeviceSegmentedRadixSort::SortPairsDescending(sortedWorkspaceData, sortedWorkspaceSize, scoresDB,
-        indexDB, param.batchSize * param.numScoreElements, param.batchSize, topOffsetsStartData, topOffsetsEndData,
-        param.scoreBits > 0 ? (10 - param.scoreBits) : 0, param.scoreBits > 0 ? 10 : sizeof(T) * 8, stream);
-    CSC(status, STATUS_FAILURE);
+    {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::sort");
+        if (param.scoreBits > 0)
+        {
+            status = EfficientPoseNMSCountingSortLauncher<T, Ti>(
+                param, topOffsetsStartData, topOffsetsEndData, scoresDB, indexDB, stream);
+        }
+        else
+        {
+            status = EfficientPoseNMSSegmentedSortLauncher<T, int>(param, true, sizeof(T) * 8, topOffsetsStartData,
+                topOffsetsEndData, scoresDB, indexDB, sortedWorkspaceData, sortedWorkspaceSize, stream);
+        }
+        CSC(status, STATUS_FAILURE);
+    }
 
-    status = EfficientPoseNMSLauncher<T>(param, topNumData, outputIndexData, outputClassData, indexDB.Current(),
-        scoresDB.Current(), topClassData, topAnchorsData, boxesInput, anchorsInput, (int*) numDetectionsOutput,
-        (T*) nmsScoresOutput, (int*) nmsClassesOutput, (int*) nmsIndicesOutput, nmsBoxesOutput, stream);
+    {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::gather");
+        status = EfficientPoseNMSGatherLauncher<T, Ti>(param, topNumData, indexDB.Current(), topClassData,
+            topAnchorsData, boxesInput, anchorsInput, keypointsInput, candidateBoxesData, candidateAreasData,
+            candidateClassesData, candidateAnchorsData, candidateKeypointsData, stream);
+        CSC(status, STATUS_FAILURE);
+    }
+
+    int* keepData = nullptr;
+    if (classPartitioned)
+    {
+        EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::classPartition");
+        status = EfficientPoseNMSClassPartitionLauncher<Ti>(param, topNumData, candidateClassesData,
+            partitionStartData, partitionEndData, classStartData, classEndData, classKeysDB, classPositionsDB,
+            sortedWorkspaceData, sortedWorkspaceSize, stream);
+        CSC(status, STATUS_FAILURE);
+
+        // The sorted class keys are not needed once the class segments are known, so they hold the keep flags.
+        keepData = classKeysDB.Alternate();
+        CSC(cudaMemsetAsync(keepData, 0x00, numScoreBuffer * sizeof(int), stream), STATUS_FAILURE);
+    }
+
+    EFFICIENT_POSE_NMS_TRACE_SCOPE("EfficientPoseNMS::nms");
+    status = EfficientPoseNMSLauncher<T, Ti>(param, topNumData, outputIndexData, outputClassData, scoresDB.Current(),
+        candidateBoxesData, candidateAreasData, candidateClassesData, candidateAnchorsData, candidateKeypointsData,
+        classPositionsDB.Current(),
+        classStartData, classEndData, keepData, outputOffsetData, indexDB.Alternate(), (int*) numDetectionsOutput,
+        (T*) nmsScoresOutput, (int*) nmsClassesOutput, (int*) nmsIndicesOutput, (int*) nmsOffsetsOutput, nmsBoxesOutput,
+        (T*) nmsKptsOutput, param.oksThreshold >= 0.f ? (const T*) keypointsInput : nullptr, stream);
     CSC(status, STATUS_FAILURE);
 
     return STATUS_SUCCESS;
 }
 
-pluginStatus_t EfficientPoseNMSInference(EfficientPoseNMSParameters param, const void* boxesInput, const void* scoresInput,
-    const void* anchorsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput,
-    void* nmsClassesOutput, void* nmsIndicesOutput, void* workspace, cudaStream_t stream)
+template <typename T>
+pluginStatus_t EfficientPoseNMSIndexDispatch(EfficientPoseNMSParameters param, const void* boxesInput,
+    const void* scoresInput, const int* candidateIndicesInput, const int* candidateCountsInput,
+    const void* anchorsInput, const void* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput,
+    void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    void* workspace, cudaStream_t stream)
 {
+    // 64-bit indexing costs registers and integer throughput in every kernel, so it is only used when needed.
+    if (EfficientPoseNMSLargeIndexing(param))
+    {
+        return EfficientPoseNMSDispatch<T, int64_t>(param, boxesInput, scoresInput, candidateIndicesInput,
+            candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+            nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace, stream);
+    }
+    return EfficientPoseNMSDispatch<T, int>(param, boxesInput, scoresInput, candidateIndicesInput,
+        candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+        nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace, stream);
+}
+
+// Shared by both entry points. The candidate indices and counts are only given with sparse input.
+pluginStatus_t EfficientPoseNMSRun(EfficientPoseNMSParameters param, const void* boxesInput, const void* scoresInput,
+    const int* candidateIndicesInput, const int* candidateCountsInput, const void* anchorsInput,
+    const void* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput,
+    void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput, void* workspace,
+    cudaStream_t stream)
+{
+    // The parameters are this call's own copy, and everything derived from them for all the stages is resolved here.
+    // Nothing below ever writes back to the configured parameters, so one plugin instance can serve any number of
+    // concurrent calls.
+    param.sparseInput = candidateCountsInput != nullptr;
+    // The candidates are sorted before NMS, so a swept candidates budget is the same as fewer selected boxes. Only the
+    // host implementation has the IOU test and time budgets.
+    if (param.maxSweptCandidates > 0)
+    {
+        param.numSelectedBoxes = std::min(param.numSelectedBoxes, param.maxSweptCandidates);
+    }
+    if (param.classMajorOutput)
+    {
+        if (param.numOutputBoxesPerClass < 1 || param.outputONNXIndices || param.compactOutput || param.packedOutput)
+        {
+            return STATUS_BAD_PARAM;
+        }
+        // Every class has its own slots, which are never truncated by a total.
+        param.numOutputBoxes = param.numClasses * param.numOutputBoxesPerClass;
+    }
+    if (param.oksThreshold >= 0.f && (keypointsInput == nullptr || param.numKeypoints < 1
+        || param.numKeypoints > EFFICIENT_POSE_NMS_MAX_KEYPOINTS))
+    {
+        return STATUS_BAD_PARAM;
+    }
+    if (param.scoreSigmoid)
+    {
+        // Inverse Sigmoid, so that the raw scores can be compared directly
+        if (param.scoreThreshold <= 0.f)
+        {
+            param.scoreThreshold = -(1 << 15);
+        }
+        else
+        {
+            param.scoreThreshold = logf(param.scoreThreshold / (1.f - param.scoreThreshold));
+        }
+        // Disable Score Bits Optimization
+        param.scoreBits = -1;
+    }
+
     if (param.datatype == DataType::kFLOAT)
     {
         param.scoreBits = -1;
-        return EfficientPoseNMSDispatch<float>(param, boxesInput, scoresInput, anchorsInput, numDetectionsOutput,
-            nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, workspace, stream);
+        return EfficientPoseNMSIndexDispatch<float>(param, boxesInput, scoresInput, candidateIndicesInput,
+            candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+            nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace, stream);
     }
     else if (param.datatype == DataType::kHALF)
     {
@@ -716,11 +1776,37 @@ pluginStatus_t EfficientPoseNMSInference(EfficientPoseNMSParameters param, const
         {
             param.scoreBits = -1;
         }
-        return EfficientPoseNMSDispatch<__half>(param, boxesInput, scoresInput, anchorsInput, numDetectionsOutput,
-            nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, workspace, stream);
+        return EfficientPoseNMSIndexDispatch<__half>(param, boxesInput, scoresInput, candidateIndicesInput,
+            candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+            nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace, stream);
     }
     else
     {
         return STATUS_NOT_SUPPORTED;
     }
 }
+
+pluginStatus_t EfficientPoseNMSInference(EfficientPoseNMSParameters param, const void* boxesInput, const void* scoresInput,
+    const void* anchorsInput, const void* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput,
+    void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    void* workspace, cudaStream_t stream)
+{
+    return EfficientPoseNMSRun(param, boxesInput, scoresInput, nullptr, nullptr, anchorsInput, keypointsInput,
+        numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput,
+        nmsOffsetsOutput, workspace, stream);
+}
+
+pluginStatus_t EfficientPoseNMSSparseInference(EfficientPoseNMSParameters param, const void* boxesInput,
+    const void* candidateScoresInput, const void* candidateIndicesInput, const void* candidateCountsInput,
+    const void* anchorsInput, const void* keypointsInput, void* numDetectionsOutput, void* nmsBoxesOutput,
+    void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* nmsOffsetsOutput,
+    void* workspace, cudaStream_t stream)
+{
+    if (candidateIndicesInput == nullptr || candidateCountsInput == nullptr)
+    {
+        return STATUS_BAD_PARAM;
+    }
+    return EfficientPoseNMSRun(param, boxesInput, candidateScoresInput, (const int*) candidateIndicesInput,
+        (const int*) candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput,
+        nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nmsIndicesOutput, nmsOffsetsOutput, workspace, stream);
+}
@@ -185,6 +185,13 @@ struct __align__(4 * sizeof(T)) BoxCorner
         return {add_mp(y1, anchor.y1), add_mp(x1, anchor.x1), add_mp(y2, anchor.y2), add_mp(x2, anchor.x2)};
     }
 
+    __device__ BoxCorner<T> transform(float offsetY, float offsetX, float scaleY, float scaleX) const
+    {
+        // Computed in fp32, as the offsets of large images are beyond the precision of fp16.
+        return {(T) ((float) y1 * scaleY + offsetY), (T) ((float) x1 * scaleX + offsetX),
+            (T) ((float) y2 * scaleY + offsetY), (T) ((float) x2 * scaleX + offsetX)};
+    }
+
     __device__ float area() const
     {
         T w = sub_mp(x2, x1);
@@ -22,11 +22,28 @@
 
 #include "efficientPoseNMSParameters.h"
 
-size_t EfficientPoseNMSWorkspaceSize(
-    int32_t batchSize, int32_t numScoreElements, int32_t numClasses, nvinfer1::DataType datatype);
+// With OKS suppression, the workspace also holds the keypoints of the candidates, so numKeypoints must be given.
+size_t EfficientPoseNMSWorkspaceSize(int32_t batchSize, int32_t numScoreElements, int32_t numClasses,
+    nvinfer1::DataType datatype, int32_t numKeypoints = 0);
 
+// When param.compactOutput is set, the detections of all images are packed back to back at the start of the output
+// buffers instead of being padded to numOutputBoxes per image, and rows past the total count are left untouched.
+// nmsOffsetsOutput is optional, and if given receives batchSize + 1 ints with the first row of each image. The
+// keypoints output, if given, is compacted the same way. Its rows are 3 * EfficientPoseNMSOutputKeypoints(param) wide,
+// and hold the input keypoints of each detection with OKS suppression, or are cleared as in the padded output.
 pluginStatus_t EfficientPoseNMSInference(nvinfer1::plugin::EfficientPoseNMSParameters param, void const* boxesInput,
-    void const* scoresInput, void const* anchorsInput, void* numDetectionsOutput, void* nmsBoxesOutput, void* nmsKptsOutput,
-    void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput, void* workspace, cudaStream_t stream);
+    void const* scoresInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, cudaStream_t stream);
+
+// Same as EfficientPoseNMSInference, with a sparse candidate list per image instead of the dense scores input, see
+// EfficientPoseNMSParameters::sparseInput for its layout. The dense filter is skipped, and the listed candidates are
+// tested, sorted and suppressed as the dense ones would be. param.numScoreElements is the capacity of the lists, which
+// the workspace is sized for.
+pluginStatus_t EfficientPoseNMSSparseInference(nvinfer1::plugin::EfficientPoseNMSParameters param,
+    void const* boxesInput, void const* candidateScoresInput, void const* candidateIndicesInput,
+    void const* candidateCountsInput, void const* anchorsInput, void const* keypointsInput, void* numDetectionsOutput,
+    void* nmsBoxesOutput, void* nmsKptsOutput, void* nmsScoresOutput, void* nmsClassesOutput, void* nmsIndicesOutput,
+    void* nmsOffsetsOutput, void* workspace, cudaStream_t stream);
 
 #endif
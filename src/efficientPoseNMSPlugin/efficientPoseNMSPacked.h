@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_PACKED_H
+#define TRT_EFFICIENT_POSE_NMS_PACKED_H
+
+#include <cmath>
+#include <cstdint>
+
+// The packed detection output format, written instead of the boxes, keypoints, scores and classes outputs when
+// packedOutput is set. Packing is shared by the device and host implementations, and unpacking is meant for the
+// consumers of the output.
+
+#ifdef __CUDACC__
+#define EFFICIENT_POSE_NMS_HOST_DEVICE __host__ __device__
+#else
+#define EFFICIENT_POSE_NMS_HOST_DEVICE
+#endif
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// One detection in 16 bytes, against 36 bytes for the fp32 outputs.
+struct EfficientPoseNMSPackedDetection
+{
+    // The box (y1, x1, y2, x2) and the keypoint position (y, x), in pixels of a packedImageHeight x packedImageWidth
+    // image, rounded to nearest and saturated to the int16 range.
+    int16_t box[4];
+    int16_t keypoint[2];
+    // The keypoint confidence and the score, from [0, 1] to [0, 255].
+    uint8_t keypointConfidence;
+    uint8_t score;
+    uint16_t classIdx;
+};
+
+static_assert(sizeof(EfficientPoseNMSPackedDetection) == 16, "EfficientPoseNMSPackedDetection must be 16 bytes");
+
+EFFICIENT_POSE_NMS_HOST_DEVICE inline int16_t EfficientPoseNMSPackCoordinate(float value, int32_t size)
+{
+    float pixel = floorf(value * size + 0.5f);
+    // Written so that NaN saturates low.
+    pixel = !(pixel >= -32768.f) ? -32768.f : (pixel > 32767.f ? 32767.f : pixel);
+    return static_cast<int16_t>(pixel);
+}
+
+EFFICIENT_POSE_NMS_HOST_DEVICE inline uint8_t EfficientPoseNMSPackUnit(float value)
+{
+    value = !(value >= 0.f) ? 0.f : (value > 1.f ? 1.f : value);
+    return static_cast<uint8_t>(value * 255.f + 0.5f);
+}
+
+// Packs a detection from the values of the standard outputs, that is normalized coordinates and a score in [0, 1].
+EFFICIENT_POSE_NMS_HOST_DEVICE inline EfficientPoseNMSPackedDetection EfficientPoseNMSPackDetection(float y1, float x1,
+    float y2, float x2, float const* keypoint, float score, int32_t classIdx, int32_t imageHeight, int32_t imageWidth)
+{
+    EfficientPoseNMSPackedDetection packed;
+    packed.box[0] = EfficientPoseNMSPackCoordinate(y1, imageHeight);
+    packed.box[1] = EfficientPoseNMSPackCoordinate(x1, imageWidth);
+    packed.box[2] = EfficientPoseNMSPackCoordinate(y2, imageHeight);
+    packed.box[3] = EfficientPoseNMSPackCoordinate(x2, imageWidth);
+    packed.keypoint[0] = EfficientPoseNMSPackCoordinate(keypoint[0], imageHeight);
+    packed.keypoint[1] = EfficientPoseNMSPackCoordinate(keypoint[1], imageWidth);
+    packed.keypointConfidence = EfficientPoseNMSPackUnit(keypoint[2]);
+    packed.score = EfficientPoseNMSPackUnit(score);
+    packed.classIdx = static_cast<uint16_t>(classIdx);
+    return packed;
+}
+
+// Unpacks numDetections records back to the layout of the standard outputs: boxes as [numDetections, 4] and
+// keypoints as [numDetections, 3], in normalized coordinates, and scores and classes as [numDetections]. Coordinates
+// come back within half a pixel, and scores within 1 / 510, of the packed values.
+inline void EfficientPoseNMSUnpackDetections(EfficientPoseNMSPackedDetection const* packed, int32_t numDetections,
+    int32_t imageHeight, int32_t imageWidth, float* boxes, float* keypoints, float* scores, int32_t* classes)
+{
+    float const scaleY = 1.f / imageHeight;
+    float const scaleX = 1.f / imageWidth;
+    for (int32_t idx = 0; idx < numDetections; idx++)
+    {
+        EfficientPoseNMSPackedDetection const& detection = packed[idx];
+        boxes[idx * 4 + 0] = detection.box[0] * scaleY;
+        boxes[idx * 4 + 1] = detection.box[1] * scaleX;
+        boxes[idx * 4 + 2] = detection.box[2] * scaleY;
+        boxes[idx * 4 + 3] = detection.box[3] * scaleX;
+        keypoints[idx * 3 + 0] = detection.keypoint[0] * scaleY;
+        keypoints[idx * 3 + 1] = detection.keypoint[1] * scaleX;
+        keypoints[idx * 3 + 2] = detection.keypointConfidence * (1.f / 255.f);
+        scores[idx] = detection.score * (1.f / 255.f);
+        classes[idx] = detection.classIdx;
+    }
+}
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
@@ -18,7 +18,42 @@
 #ifndef TRT_EFFICIENT_POSE_NMS_PARAMETERS_H
 #define TRT_EFFICIENT_POSE_NMS_PARAMETERS_H
 
+#ifdef EFFICIENT_POSE_NMS_STANDALONE
+#include <cstdint>
+
+// The standalone host build (see core/CMakeLists.txt) does not depend on TensorRT, so it only declares the few
+// TensorRT types used by the host implementation, with the same values as in NvInferRuntimeBase.h and plugin.h.
+namespace nvinfer1
+{
+enum class DataType : int32_t
+{
+    kFLOAT = 0,
+    kHALF = 1,
+    kINT8 = 2,
+    kINT32 = 3
+};
+} // namespace nvinfer1
+
+typedef enum
+{
+    STATUS_SUCCESS = 0,
+    STATUS_FAILURE = 1,
+    STATUS_BAD_PARAM = 2,
+    STATUS_NOT_SUPPORTED = 3,
+    STATUS_NOT_INITIALIZED = 4
+} pluginStatus_t;
+#else
 #include "common/plugin.h"
+#endif
+
+// Maximum number of tiles per image for tiled inference, which bounds the size of the tile transforms parameter.
+#define EFFICIENT_POSE_NMS_MAX_TILES 64
+// Maximum number of keypoints per box for OKS suppression, which bounds the size of the keypoint sigmas parameter.
+#define EFFICIENT_POSE_NMS_MAX_KEYPOINTS 32
+// Version of the serialized parameters, which the plugins write ahead of the raw EfficientPoseNMSParameters. It must
+// be bumped with every change to the layout of the parameters, so that engines built with another layout are rejected
+// when deserialized, instead of being misread.
+#define EFFICIENT_POSE_NMS_SERIALIZATION_VERSION 1
 
 namespace nvinfer1
 {
@@ -38,14 +73,73 @@ struct EfficientPoseNMSParameters
     bool clipBoxes = false;
     int32_t boxCoding = 0;
     bool classAgnostic = false;
+    bool compactOutput = false;
+    // Reduce each anchor to its highest scoring class before thresholding, as in YOLOv8 style heads, instead of
+    // taking every anchor and class pair as a candidate.
+    bool classArgmax = false;
+    // Write each detection as one EfficientPoseNMSPackedDetection (see efficientPoseNMSPacked.h) into the boxes
+    // output, in pixels of a packedImageHeight x packedImageWidth image, and leave the keypoints, scores and classes
+    // outputs out.
+    bool packedOutput = false;
+    int32_t packedImageHeight = 1;
+    int32_t packedImageWidth = 1;
+    // Lay the standard outputs out class major, for consumers that index the detections by class: each class of each
+    // image gets its own numOutputBoxesPerClass slots, which must be positive, and its boxes are written there in score
+    // order. The num_detections output then holds [batchSize, numClasses] per class counts, numOutputBoxes is
+    // numClasses * numOutputBoxesPerClass, and the slots of class c are rows c * numOutputBoxesPerClass onwards of the
+    // [batchSize, numOutputBoxes, ...] boxes, keypoints, scores and classes outputs.
+    // Not compatible with the compact, packed or ONNX outputs.
+    bool classMajorOutput = false;
 
     // Related to NMS Internals
     int32_t numSelectedBoxes = 4096;
     int32_t scoreBits = -1;
     bool outputONNXIndices = false;
 
+    // Related to Tiled Inference
+    // With more than one tile per image, every tilesPerImage consecutive entries of the input batch hold the tiles of
+    // one image, and NMS runs once per image. For each tile, tileTransforms holds the (y offset, x offset, y scale,
+    // x scale) that maps its boxes to the image frame.
+    int32_t tilesPerImage = 1;
+    float tileTransforms[4 * EFFICIENT_POSE_NMS_MAX_TILES] = {};
+
+    // Related to OKS Suppression
+    // With a non negative oksThreshold, a keypoints input holds numKeypoints (y, x, confidence) triplets per anchor,
+    // in the same frame as the boxes, and a box is also suppressed when its object keypoint similarity with a higher
+    // scoring kept box reaches oksThreshold. An iouThreshold above 1 leaves OKS as the only criterion. The OKS is
+    // taken over the keypoints with a positive confidence in both boxes, with the mean of the two box areas as the
+    // object scale, and keypointSigmas as the per keypoint falloff, as in the COCO keypoint evaluation. The keypoints
+    // output then holds the keypoints of each detection, mapped to the image frame with tiled inference, instead of a
+    // single zero keypoint.
+    float oksThreshold = -1.F;
+    int32_t numKeypoints = 0;
+    float keypointSigmas[EFFICIENT_POSE_NMS_MAX_KEYPOINTS] = {};
+
+    // Related to NMS Budget
+    // For frames with a hard deadline, the NMS of each image can be bounded. When a budget runs out, NMS stops before
+    // its next candidate, and the boxes kept so far, which are the highest scoring of the full results, are written out
+    // as usual. The host profile reports the images that ran out (see EfficientPoseNMSHostProfile::budgetExhausted).
+    // With a positive maxSweptCandidates, only that many of the highest scoring candidates of each image are swept,
+    // by both implementations. The other two budgets only apply to the host implementation, and to each image as a
+    // whole, whose classes are then swept together in score order rather than independently: with a positive
+    // maxIouTests, the sweep of an image stops before a candidate whose tests could exceed that many IOU tests. With a
+    // positive nmsTimeBudget, in microseconds since the start of the call, the sweeps stop once it is over, so the
+    // results then depend on timing.
+    int32_t maxSweptCandidates = -1;
+    int32_t maxIouTests = -1;
+    int32_t nmsTimeBudget = -1;
+
+    // Related to Sparse Candidate Input
+    // Instead of dense [batchSize, numAnchors, numClasses] scores, the candidates of each image come as a list, such as
+    // from a model that already thresholds its scores: the scores input holds [batchSize, numScoreElements] scores, a
+    // candidate indices input holds the [batchSize, numScoreElements, 2] (anchor, class) of each score, and a candidate
+    // counts input holds the [batchSize] number of listed candidates of each image, up to numScoreElements. The boxes,
+    // anchors and keypoints inputs are still per anchor. Each (anchor, class) should be listed at most once.
+    bool sparseInput = false;
+
     // Related to Tensor Configuration
     // (These are set by the various plugin configuration methods, no need to define them during plugin creation.)
+    // With tiled inference, these describe the images, so an image holds the anchors of all its tiles back to back.
     int32_t batchSize = -1;
     int32_t numClasses = 1;
     int32_t numBoxElements = -1;
@@ -16,7 +16,9 @@
  */
 
 #include "efficientPoseNMSPlugin.h"
+#include "efficientPoseNMSIndexing.h"
 #include "efficientPoseNMSInference.h"
+#include "efficientPoseNMSPacked.h"
 
 using namespace nvinfer1;
 using nvinfer1::plugin::EfficientPoseNMSPlugin;
@@ -30,6 +32,91 @@ char const* const kEFFICIENT_NMS_PLUGIN_VERSION{"1"};
 char const* const kEFFICIENT_NMS_PLUGIN_NAME{"EfficientPoseNMS_TRT"};
 char const* const kEFFICIENT_NMS_ONNX_PLUGIN_VERSION{"1"};
 char const* const kEFFICIENT_NMS_ONNX_PLUGIN_NAME{"EfficientPoseNMS_ONNX_TRT"};
+
+// The outputs the plugin can bind.
+enum class NMSOutput : int32_t
+{
+    kNUM_DETECTIONS,
+    kBOXES,
+    kKEYPOINTS,
+    kSCORES,
+    kCLASSES,
+    kPACKED,
+    kOFFSETS,
+    kINDICES,
+};
+
+// The outputs of the plugin, in binding order. getNbOutputs(), getOutputDimensions(), getOutputDataType(),
+// supportsFormatCombination() and enqueue() all go through this table, so that they always agree on which output is
+// at which index.
+struct NMSOutputTable
+{
+    static constexpr int32_t kMAX_OUTPUTS{6};
+    int32_t nbOutputs{0};
+    NMSOutput outputs[kMAX_OUTPUTS];
+
+    void add(NMSOutput output)
+    {
+        outputs[nbOutputs++] = output;
+    }
+
+    NMSOutput at(int32_t index) const
+    {
+        PLUGIN_ASSERT(index >= 0 && index < nbOutputs);
+        return outputs[index];
+    }
+
+    // The index of the output, or -1 if the plugin does not bind it.
+    int32_t find(NMSOutput output) const
+    {
+        for (int32_t index = 0; index < nbOutputs; index++)
+        {
+            if (outputs[index] == output)
+            {
+                return index;
+            }
+        }
+        return -1;
+    }
+};
+
+NMSOutputTable getOutputTable(EfficientPoseNMSParameters const& param)
+{
+    NMSOutputTable table;
+    if (param.outputONNXIndices)
+    {
+        // ONNX NonMaxSuppression Compatibility: [0] detection_indices
+        table.add(NMSOutput::kINDICES);
+        return table;
+    }
+
+    table.add(NMSOutput::kNUM_DETECTIONS);
+    if (param.packedOutput)
+    {
+        // Packed Detections: [1] detection_packed
+        table.add(NMSOutput::kPACKED);
+    }
+    else
+    {
+        // Standard Plugin Implementation: [1] detection_boxes, [2] detection_keypoints, [3] detection_scores,
+        // [4] detection_classes
+        table.add(NMSOutput::kBOXES);
+        table.add(NMSOutput::kKEYPOINTS);
+        table.add(NMSOutput::kSCORES);
+        table.add(NMSOutput::kCLASSES);
+    }
+    // Compacted detections also have the [batch_size + 1] offsets of the rows of each image, after all the others.
+    if (param.compactOutput)
+    {
+        table.add(NMSOutput::kOFFSETS);
+    }
+    return table;
+}
+
+bool isIntegerOutput(NMSOutput output)
+{
+    return output != NMSOutput::kBOXES && output != NMSOutput::kKEYPOINTS && output != NMSOutput::kSCORES;
+}
 } // namespace
 
 EfficientPoseNMSPlugin::EfficientPoseNMSPlugin(EfficientPoseNMSParameters param)
@@ -44,7 +131,11 @@ EfficientPoseNMSPlugin::EfficientPoseNMSPlugin(void const* data, size_t length)
 
 void EfficientPoseNMSPlugin::deserialize(int8_t const* data, size_t length)
 {
+    // The parameters are stored raw, so they are only read back with the layout they were written with.
     auto const* d{data};
+    PLUGIN_VALIDATE(length >= sizeof(int32_t));
+    PLUGIN_VALIDATE(read<int32_t>(d) == EFFICIENT_POSE_NMS_SERIALIZATION_VERSION);
+    PLUGIN_VALIDATE(length == sizeof(int32_t) + sizeof(EfficientPoseNMSParameters));
     mParam = read<EfficientPoseNMSParameters>(d);
     PLUGIN_VALIDATE(d == data + length);
 }
@@ -61,14 +152,7 @@ char const* EfficientPoseNMSPlugin::getPluginVersion() const noexcept
 
 int32_t EfficientPoseNMSPlugin::getNbOutputs() const noexcept
 {
-    if (mParam.outputONNXIndices)
-    {
-        // ONNX NonMaxSuppression Compatibility
-        return 1;
-    }
-
-    // Standard Plugin Implementation
-    return 4;
+    return getOutputTable(mParam).nbOutputs;
 }
 
 int32_t EfficientPoseNMSPlugin::initialize() noexcept
@@ -98,12 +182,13 @@ void EfficientPoseNMSPlugin::terminate() noexcept {}
 
 size_t EfficientPoseNMSPlugin::getSerializationSize() const noexcept
 {
-    return sizeof(EfficientPoseNMSParameters);
+    return sizeof(int32_t) + sizeof(EfficientPoseNMSParameters);
 }
 
 void EfficientPoseNMSPlugin::serialize(void* buffer) const noexcept
 {
     char *d = reinterpret_cast<char*>(buffer), *a = d;
+    write(d, static_cast<int32_t>(EFFICIENT_POSE_NMS_SERIALIZATION_VERSION));
     write(d, mParam);
     PLUGIN_ASSERT(d == a + getSerializationSize());
 }
@@ -133,14 +218,9 @@ char const* EfficientPoseNMSPlugin::getPluginNamespace() const noexcept
 nvinfer1::DataType EfficientPoseNMSPlugin::getOutputDataType(
     int32_t index, nvinfer1::DataType const* inputTypes, int32_t nbInputs) const noexcept
 {
-    if (mParam.outputONNXIndices)
-    {
-        // ONNX NMS uses an integer output
-        return nvinfer1::DataType::kINT32;
-    }
-
-    // On standard NMS, num_detections and detection_classes use integer outputs
-    if (index == 0 || index == 3)
+    // The counts, classes, offsets and ONNX indices are integer outputs, and the packed detections are carried as raw
+    // int32 words.
+    if (isIntegerOutput(getOutputTable(mParam).at(index)))
     {
         return nvinfer1::DataType::kINT32;
     }
@@ -176,50 +256,85 @@ DimsExprs EfficientPoseNMSPlugin::getOutputDimensions(
         // expression. The corresponding parameter can not be set at this time, so the
         // value will be calculated again in configurePlugin() and the param overwritten.
         IDimensionExpr const* numOutputBoxes = exprBuilder.constant(mParam.numOutputBoxes);
-        if (mParam.padOutputBoxesPerClass && mParam.numOutputBoxesPerClass > 0)
+
+        // With tiled inference, there is one output per image, not per tile.
+        IDimensionExpr const* batchSize = inputs[0].d[0];
+        if (mParam.tilesPerImage > 1)
+        {
+            batchSize = exprBuilder.operation(
+                DimensionOperation::kFLOOR_DIV, *batchSize, *exprBuilder.constant(mParam.tilesPerImage));
+        }
+        // With sparse input, the number of classes is an attribute, as the scores are not laid out per class.
+        IDimensionExpr const* numClasses
+            = mParam.sparseInput ? exprBuilder.constant(mParam.numClasses) : inputs[1].d[2];
+        if (mParam.classMajorOutput)
+        {
+            // Class major outputs have numOutputBoxesPerClass slots for every class, back to back.
+            numOutputBoxes = exprBuilder.operation(
+                DimensionOperation::kPROD, *exprBuilder.constant(mParam.numOutputBoxesPerClass), *numClasses);
+        }
+        else if (mParam.padOutputBoxesPerClass && mParam.numOutputBoxesPerClass > 0)
         {
             IDimensionExpr const* numOutputBoxesPerClass = exprBuilder.constant(mParam.numOutputBoxesPerClass);
-            IDimensionExpr const* numClasses = inputs[1].d[2];
             numOutputBoxes = exprBuilder.operation(DimensionOperation::kMIN, *numOutputBoxes,
                 *exprBuilder.operation(DimensionOperation::kPROD, *numOutputBoxesPerClass, *numClasses));
         }
 
-        if (mParam.outputONNXIndices)
+        NMSOutput const output = getOutputTable(mParam).at(outputIndex);
+        if (output == NMSOutput::kINDICES)
         {
-            // ONNX NMS
-            PLUGIN_ASSERT(outputIndex == 0);
-
-            // detection_indices
+            // ONNX NMS: detection_indices
             out_dim.nbDims = 2;
-            out_dim.d[0] = exprBuilder.operation(DimensionOperation::kPROD, *inputs[0].d[0], *numOutputBoxes);
+            out_dim.d[0] = exprBuilder.operation(DimensionOperation::kPROD, *batchSize, *numOutputBoxes);
             out_dim.d[1] = exprBuilder.constant(3);
         }
+        else if (output == NMSOutput::kOFFSETS)
+        {
+            // detection_offsets: with compact output, the first row of each image, and the total
+            out_dim.nbDims = 1;
+            out_dim.d[0] = exprBuilder.operation(DimensionOperation::kSUM, *batchSize, *exprBuilder.constant(1));
+        }
+        else if (output == NMSOutput::kPACKED)
+        {
+            // detection_packed: one 16 byte EfficientPoseNMSPackedDetection per row
+            out_dim.nbDims = 3;
+            out_dim.d[0] = batchSize;
+            out_dim.d[1] = numOutputBoxes;
+            out_dim.d[2] = exprBuilder.constant(sizeof(EfficientPoseNMSPackedDetection) / sizeof(int32_t));
+        }
         else
         {
-            // Standard NMS
-            PLUGIN_ASSERT(outputIndex >= 0 && outputIndex <= 3);
+            // Standard and Class Major NMS
 
             // num_detections
-            if (outputIndex == 0)
+            if (output == NMSOutput::kNUM_DETECTIONS)
             {
                 out_dim.nbDims = 2;
-                out_dim.d[0] = inputs[0].d[0];
-                out_dim.d[1] = exprBuilder.constant(1);
+                out_dim.d[0] = batchSize;
+                out_dim.d[1] = mParam.classMajorOutput ? numClasses : exprBuilder.constant(1);
             }
             // detection_boxes
-            else if (outputIndex == 1)
+            else if (output == NMSOutput::kBOXES)
             {
                 out_dim.nbDims = 3;
-                out_dim.d[0] = inputs[0].d[0];
+                out_dim.d[0] = batchSize;
                 out_dim.d[1] = numOutputBoxes;
                 out_dim.d[2] = exprBuilder.constant(4);
             }
-            // detection_scores: outputIndex == 2
-            // detection_classes: outputIndex == 3
-            else if (outputIndex == 2 || outputIndex == 3)
+            // detection_keypoints: the (y, x, confidence) keypoints of each detection with OKS suppression, or a
+            // single zero keypoint otherwise
+            else if (output == NMSOutput::kKEYPOINTS)
+            {
+                out_dim.nbDims = 3;
+                out_dim.d[0] = batchSize;
+                out_dim.d[1] = numOutputBoxes;
+                out_dim.d[2] = exprBuilder.constant(3 * EfficientPoseNMSOutputKeypoints(mParam));
+            }
+            // detection_scores and detection_classes
+            else if (output == NMSOutput::kSCORES || output == NMSOutput::kCLASSES)
             {
                 out_dim.nbDims = 2;
-                out_dim.d[0] = inputs[0].d[0];
+                out_dim.d[0] = batchSize;
                 out_dim.d[1] = numOutputBoxes;
             }
         }
@@ -241,38 +356,25 @@ bool EfficientPoseNMSPlugin::supportsFormatCombination(
         return false;
     }
 
+    // With sparse input, the candidate indices and counts come right after the scores.
+    int32_t const nbSparseInputs = mParam.sparseInput ? 2 : 0;
     if (mParam.outputONNXIndices)
     {
         PLUGIN_ASSERT(nbInputs == 2);
-        PLUGIN_ASSERT(nbOutputs == 1);
-
-        // detection_indices output: int32_t
-        if (pos == 2)
-        {
-            return inOut[pos].type == DataType::kINT32;
-        }
-
-        // boxes and scores input: fp32 or fp16
-        return (inOut[pos].type == DataType::kHALF || inOut[pos].type == DataType::kFLOAT)
-            && (inOut[0].type == inOut[pos].type);
     }
-
-    PLUGIN_ASSERT(nbInputs == 2 || nbInputs == 3);
-    PLUGIN_ASSERT(nbOutputs == 4);
-    if (nbInputs == 2)
-    {
-        PLUGIN_ASSERT(0 <= pos && pos <= 5);
-    }
-    if (nbInputs == 3)
+    else
     {
-        PLUGIN_ASSERT(0 <= pos && pos <= 6);
+        PLUGIN_ASSERT(nbInputs >= 2 + nbSparseInputs && nbInputs <= 4 + nbSparseInputs);
     }
+    PLUGIN_ASSERT(nbOutputs == getNbOutputs());
+    PLUGIN_ASSERT(0 <= pos && pos < nbInputs + nbOutputs);
 
-    // num_detections and detection_classes output: int32_t
-    int32_t const posOut = pos - nbInputs;
-    if (posOut == 0 || posOut == 3)
+    // num_detections, detection_packed, detection_classes, detection_offsets and detection_indices output, and
+    // candidate_indices and candidate_counts input: int32_t
+    if (pos >= nbInputs ? isIntegerOutput(getOutputTable(mParam).at(pos - nbInputs))
+                        : (pos >= 2 && pos < 2 + nbSparseInputs))
     {
-        return inOut[pos].type == DataType::kINT32 && inOut[pos].format == PluginFormat::kLINEAR;
+        return inOut[pos].type == DataType::kINT32;
     }
 
     // all other inputs/outputs: fp32 or fp16
@@ -294,19 +396,40 @@ void EfficientPoseNMSPlugin::configurePlugin(
         }
         else
         {
-            // Accepts two or three inputs
+            // Accepts two or three inputs, plus the keypoints with OKS suppression
             // If two inputs: [0] boxes, [1] scores
             // If three inputs: [0] boxes, [1] scores, [2] anchors
-            PLUGIN_ASSERT(nbInputs == 2 || nbInputs == 3);
-            PLUGIN_ASSERT(nbOutputs == 4);
+            // With OKS suppression, the keypoints always come last, after the anchors if any
+            // With sparse input, [2] candidate_indices and [3] candidate_counts come before the anchors
+            int32_t const nbOtherInputs = (mParam.oksThreshold >= 0.F ? 1 : 0) + (mParam.sparseInput ? 2 : 0);
+            PLUGIN_ASSERT(nbInputs - nbOtherInputs == 2 || nbInputs - nbOtherInputs == 3);
+            PLUGIN_ASSERT(nbOutputs == getNbOutputs());
         }
         mParam.datatype = in[0].desc.type;
 
-        // Shape of scores input should be
-        // [batch_size, num_boxes, num_classes] or [batch_size, num_boxes, num_classes, 1]
-        PLUGIN_ASSERT(in[1].desc.dims.nbDims == 3 || (in[1].desc.dims.nbDims == 4 && in[1].desc.dims.d[3] == 1));
-        mParam.numScoreElements = in[1].desc.dims.d[1] * in[1].desc.dims.d[2];
-        mParam.numClasses = in[1].desc.dims.d[2];
+        if (mParam.sparseInput)
+        {
+            // Shape of scores input should be
+            // [batch_size, max_candidates] or [batch_size, max_candidates, 1]
+            // Shape of candidate_indices input should be [batch_size, max_candidates, 2], holding (anchor, class)
+            // Shape of candidate_counts input should be [batch_size] or [batch_size, 1]
+            // The number of classes is given by the num_classes attribute instead.
+            PLUGIN_ASSERT(in[1].desc.dims.nbDims == 2 || (in[1].desc.dims.nbDims == 3 && in[1].desc.dims.d[2] == 1));
+            PLUGIN_ASSERT(in[2].desc.dims.nbDims == 3 && in[2].desc.dims.d[2] == 2);
+            PLUGIN_ASSERT(in[2].desc.dims.d[1] == in[1].desc.dims.d[1]);
+            PLUGIN_ASSERT(in[3].desc.dims.nbDims == 1 || (in[3].desc.dims.nbDims == 2 && in[3].desc.dims.d[1] == 1));
+            mParam.numScoreElements = in[1].desc.dims.d[1];
+        }
+        else
+        {
+            // Shape of scores input should be
+            // [batch_size, num_boxes, num_classes] or [batch_size, num_boxes, num_classes, 1]
+            PLUGIN_ASSERT(in[1].desc.dims.nbDims == 3 || (in[1].desc.dims.nbDims == 4 && in[1].desc.dims.d[3] == 1));
+            mParam.numScoreElements = in[1].desc.dims.d[1] * in[1].desc.dims.d[2];
+            mParam.numClasses = in[1].desc.dims.d[2];
+        }
+        // Packed detections hold 16 bit class ids.
+        PLUGIN_ASSERT(!mParam.packedOutput || mParam.numClasses <= 65536);
 
         // When pad per class is set, the total output boxes size may need to be reduced.
         // This operation is also done in getOutputDimension(), but for dynamic shapes, the
@@ -318,6 +441,12 @@ void EfficientPoseNMSPlugin::configurePlugin(
                 mParam.numOutputBoxes = mParam.numOutputBoxesPerClass * mParam.numClasses;
             }
         }
+        // Class major outputs have numOutputBoxesPerClass slots for every class, whatever the total.
+        if (mParam.classMajorOutput)
+        {
+            PLUGIN_ASSERT(mParam.numOutputBoxesPerClass > 0);
+            mParam.numOutputBoxes = mParam.numOutputBoxesPerClass * mParam.numClasses;
+        }
 
         // Shape of boxes input should be
         // [batch_size, num_boxes, 4] or [batch_size, num_boxes, 1, 4] or [batch_size, num_boxes, num_classes, 4]
@@ -337,20 +466,41 @@ void EfficientPoseNMSPlugin::configurePlugin(
         }
         mParam.numAnchors = in[0].desc.dims.d[1];
 
-        if (nbInputs == 2)
+        // The keypoints and sparse candidate inputs are not part of the box decoder.
+        int32_t const anchorsIndex = mParam.sparseInput ? 4 : 2;
+        int32_t const nbBoxInputs = (mParam.oksThreshold >= 0.F ? nbInputs - 1 : nbInputs) - (anchorsIndex - 2);
+        if (nbBoxInputs == 2)
         {
             // Only two inputs are used, disable the fused box decoder
             mParam.boxDecoder = false;
         }
-        if (nbInputs == 3)
+        if (nbBoxInputs == 3)
         {
             // All three inputs are used, enable the box decoder
             // Shape of anchors input should be
             // Constant shape: [1, numAnchors, 4] or [batch_size, numAnchors, 4]
-            PLUGIN_ASSERT(in[2].desc.dims.nbDims == 3);
+            PLUGIN_ASSERT(in[anchorsIndex].desc.dims.nbDims == 3);
             mParam.boxDecoder = true;
-            mParam.shareAnchors = (in[2].desc.dims.d[0] == 1);
+            mParam.shareAnchors = (in[anchorsIndex].desc.dims.d[0] == 1);
+        }
+        if (mParam.oksThreshold >= 0.F)
+        {
+            // Shape of keypoints input should be
+            // [batch_size, num_boxes, num_keypoints * 3] or [batch_size, num_boxes, num_keypoints, 3], where the
+            // number of keypoints is that of the keypoint sigmas
+            Dims const& keypointDims = in[anchorsIndex + nbBoxInputs - 2].desc.dims;
+            PLUGIN_ASSERT(keypointDims.nbDims == 3 || (keypointDims.nbDims == 4 && keypointDims.d[3] == 3));
+            PLUGIN_ASSERT(keypointDims.d[1] == in[0].desc.dims.d[1]);
+            int32_t const numKeypointElements
+                = keypointDims.nbDims == 3 ? keypointDims.d[2] : keypointDims.d[2] * keypointDims.d[3];
+            PLUGIN_ASSERT(numKeypointElements == 3 * mParam.numKeypoints);
         }
+
+        // With tiled inference, each image holds the anchors of all its tiles back to back, which is how the
+        // [batch_size, num_boxes, ...] inputs are laid out in memory already.
+        mParam.numScoreElements *= mParam.tilesPerImage;
+        mParam.numBoxElements *= mParam.tilesPerImage;
+        mParam.numAnchors *= mParam.tilesPerImage;
     }
     catch (std::exception const& e)
     {
@@ -361,10 +511,18 @@ void EfficientPoseNMSPlugin::configurePlugin(
 size_t EfficientPoseNMSPlugin::getWorkspaceSize(
     PluginTensorDesc const* inputs, int32_t nbInputs, PluginTensorDesc const* outputs, int32_t nbOutputs) const noexcept
 {
-    int32_t batchSize = inputs[1].dims.d[0];
-    int32_t numScoreElements = inputs[1].dims.d[1] * inputs[1].dims.d[2];
+    int32_t batchSize = inputs[1].dims.d[0] / mParam.tilesPerImage;
+    int32_t numScoreElements = inputs[1].dims.d[1] * inputs[1].dims.d[2] * mParam.tilesPerImage;
     int32_t numClasses = inputs[1].dims.d[2];
-    return EfficientPoseNMSWorkspaceSize(batchSize, numScoreElements, numClasses, mParam.datatype);
+    if (mParam.sparseInput)
+    {
+        // The scores are [batch_size, max_candidates] or [batch_size, max_candidates, 1], and sparse input is never
+        // tiled.
+        numScoreElements = inputs[1].dims.d[1];
+        numClasses = mParam.numClasses;
+    }
+    int32_t numKeypoints = mParam.oksThreshold >= 0.F ? mParam.numKeypoints : 0;
+    return EfficientPoseNMSWorkspaceSize(batchSize, numScoreElements, numClasses, mParam.datatype, numKeypoints);
 }
 
 int32_t EfficientPoseNMSPlugin::enqueue(PluginTensorDesc const* inputDesc, PluginTensorDesc const* /* outputDesc */,
@@ -374,33 +532,54 @@ int32_t EfficientPoseNMSPlugin::enqueue(PluginTensorDesc const* inputDesc, Plugi
     {
         PLUGIN_VALIDATE(inputDesc != nullptr && inputs != nullptr && outputs != nullptr && workspace != nullptr);
 
-        mParam.batchSize = inputDesc[0].dims.d[0];
+        // The batch size is only known per call, so it goes into a copy of the parameters. The plugin itself is never
+        // modified here, so that concurrent calls on the same instance do not race.
+        PLUGIN_VALIDATE(inputDesc[0].dims.d[0] % mParam.tilesPerImage == 0);
+        EfficientPoseNMSParameters param = mParam;
+        param.batchSize = inputDesc[0].dims.d[0] / param.tilesPerImage;
 
-        if (mParam.outputONNXIndices)
+        // Outputs the layout does not bind are null, the packed detections are written into the boxes output.
+        NMSOutputTable const table = getOutputTable(param);
+        auto output = [&](NMSOutput kind) { return table.find(kind) < 0 ? nullptr : outputs[table.find(kind)]; };
+
+        if (param.outputONNXIndices)
         {
             // ONNX NonMaxSuppression Op Support
             void const* const boxesInput = inputs[0];
             void const* const scoresInput = inputs[1];
 
-            void* nmsIndicesOutput = outputs[0];
+            void* nmsIndicesOutput = output(NMSOutput::kINDICES);
 
-            return EfficientPoseNMSInference(mParam, boxesInput, scoresInput, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-                nmsIndicesOutput, workspace, stream);
+            return EfficientPoseNMSInference(param, boxesInput, scoresInput, nullptr, nullptr, nullptr, nullptr, nullptr,
+                nullptr, nullptr, nmsIndicesOutput, nullptr, workspace, stream);
         }
 
         // Standard NMS Operation
         void const* const boxesInput = inputs[0];
         void const* const scoresInput = inputs[1];
-        void const* const anchorsInput = mParam.boxDecoder ? inputs[2] : nullptr;
-
-        void* numDetectionsOutput = outputs[0];
-        void* nmsBoxesOutput = outputs[1];
-        void* nmsKptsOutput = outputs[2];
-        void* nmsScoresOutput = outputs[3];
-        void* nmsClassesOutput = outputs[4];
-
-        return EfficientPoseNMSInference(mParam, boxesInput, scoresInput, anchorsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
-            nmsScoresOutput, nmsClassesOutput, nullptr, workspace, stream);
+        void const* const candidateIndicesInput = param.sparseInput ? inputs[2] : nullptr;
+        void const* const candidateCountsInput = param.sparseInput ? inputs[3] : nullptr;
+        int32_t const anchorsIndex = param.sparseInput ? 4 : 2;
+        void const* const anchorsInput = param.boxDecoder ? inputs[anchorsIndex] : nullptr;
+        void const* const keypointsInput
+            = param.oksThreshold >= 0.F ? inputs[param.boxDecoder ? anchorsIndex + 1 : anchorsIndex] : nullptr;
+
+        void* numDetectionsOutput = output(NMSOutput::kNUM_DETECTIONS);
+        void* nmsBoxesOutput = param.packedOutput ? output(NMSOutput::kPACKED) : output(NMSOutput::kBOXES);
+        void* nmsKptsOutput = output(NMSOutput::kKEYPOINTS);
+        void* nmsScoresOutput = output(NMSOutput::kSCORES);
+        void* nmsClassesOutput = output(NMSOutput::kCLASSES);
+        void* nmsOffsetsOutput = output(NMSOutput::kOFFSETS);
+
+        if (param.sparseInput)
+        {
+            return EfficientPoseNMSSparseInference(param, boxesInput, scoresInput, candidateIndicesInput,
+                candidateCountsInput, anchorsInput, keypointsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
+                nmsScoresOutput, nmsClassesOutput, nullptr, nmsOffsetsOutput, workspace, stream);
+        }
+        return EfficientPoseNMSInference(param, boxesInput, scoresInput, anchorsInput, keypointsInput,
+            numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nullptr,
+            nmsOffsetsOutput, workspace, stream);
     }
     catch (std::exception const& e)
     {
@@ -422,6 +601,18 @@ EfficientPoseNMSPluginCreator::EfficientPoseNMSPluginCreator()
     mPluginAttributes.emplace_back(PluginField("score_activation", nullptr, PluginFieldType::kINT32, 1));
     mPluginAttributes.emplace_back(PluginField("class_agnostic", nullptr, PluginFieldType::kINT32, 1));
     mPluginAttributes.emplace_back(PluginField("box_coding", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("compact_output", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("class_argmax", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("packed_output", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("packed_image_size", nullptr, PluginFieldType::kINT32, 2));
+    mPluginAttributes.emplace_back(PluginField("score_bits", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("tiles_per_image", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("tile_transforms", nullptr, PluginFieldType::kFLOAT32, 0));
+    mPluginAttributes.emplace_back(PluginField("oks_threshold", nullptr, PluginFieldType::kFLOAT32, 1));
+    mPluginAttributes.emplace_back(PluginField("keypoint_sigmas", nullptr, PluginFieldType::kFLOAT32, 0));
+    mPluginAttributes.emplace_back(PluginField("sparse_input", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("num_classes", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("max_swept_candidates", nullptr, PluginFieldType::kINT32, 1));
     mFC.nbFields = mPluginAttributes.size();
     mFC.fields = mPluginAttributes.data();
 }
@@ -451,6 +642,9 @@ IPluginV2DynamicExt* EfficientPoseNMSPluginCreator::createPlugin(char const* nam
         plugin::validateRequiredAttributesExist({"score_threshold", "iou_threshold", "max_output_boxes",
                                                     "background_class", "score_activation", "box_coding"},
             fc);
+        int32_t numTileTransforms = 0;
+        bool packedImageSize = false;
+        bool numClassesSet = false;
         for (int32_t i{0}; i < fc->nbFields; ++i)
         {
             char const* attrName = fields[i].name;
@@ -499,7 +693,111 @@ IPluginV2DynamicExt* EfficientPoseNMSPluginCreator::createPlugin(char const* nam
                 PLUGIN_VALIDATE(boxCoding == 0 || boxCoding == 1);
                 mParam.boxCoding = boxCoding;
             }
+            if (!strcmp(attrName, "compact_output"))
+            {
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const compactOutput = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(compactOutput == 0 || compactOutput == 1);
+                mParam.compactOutput = static_cast<bool>(compactOutput);
+            }
+            if (!strcmp(attrName, "class_argmax"))
+            {
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const classArgmax = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(classArgmax == 0 || classArgmax == 1);
+                mParam.classArgmax = static_cast<bool>(classArgmax);
+            }
+            if (!strcmp(attrName, "packed_output"))
+            {
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const packedOutput = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(packedOutput == 0 || packedOutput == 1);
+                mParam.packedOutput = static_cast<bool>(packedOutput);
+            }
+            if (!strcmp(attrName, "packed_image_size"))
+            {
+                // Height and width, in pixels, which must fit the int16 packed coordinates.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                PLUGIN_VALIDATE(fields[i].length == 2);
+                auto const* packedSize = static_cast<int32_t const*>(fields[i].data);
+                PLUGIN_VALIDATE(packedSize[0] >= 1 && packedSize[0] <= 32767);
+                PLUGIN_VALIDATE(packedSize[1] >= 1 && packedSize[1] <= 32767);
+                mParam.packedImageHeight = packedSize[0];
+                mParam.packedImageWidth = packedSize[1];
+                packedImageSize = true;
+            }
+            if (!strcmp(attrName, "score_bits"))
+            {
+                // Only used with fp16 inputs, where scores are sorted on this many bits of the mantissa.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const scoreBits = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(scoreBits == -1 || (scoreBits >= 1 && scoreBits <= 10));
+                mParam.scoreBits = scoreBits;
+            }
+            if (!strcmp(attrName, "tiles_per_image"))
+            {
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const tilesPerImage = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(tilesPerImage >= 1 && tilesPerImage <= EFFICIENT_POSE_NMS_MAX_TILES);
+                mParam.tilesPerImage = tilesPerImage;
+            }
+            if (!strcmp(attrName, "tile_transforms"))
+            {
+                // Four values per tile: y offset, x offset, y scale, x scale.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kFLOAT32);
+                PLUGIN_VALIDATE(fields[i].length % 4 == 0 && fields[i].length <= 4 * EFFICIENT_POSE_NMS_MAX_TILES);
+                numTileTransforms = fields[i].length / 4;
+                memcpy(mParam.tileTransforms, fields[i].data, fields[i].length * sizeof(float));
+            }
+            if (!strcmp(attrName, "oks_threshold"))
+            {
+                // Negative disables OKS suppression.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kFLOAT32);
+                mParam.oksThreshold = *(static_cast<float const*>(fields[i].data));
+            }
+            if (!strcmp(attrName, "keypoint_sigmas"))
+            {
+                // One per keypoint, which also gives the number of keypoints of the keypoints input.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kFLOAT32);
+                PLUGIN_VALIDATE(fields[i].length >= 1 && fields[i].length <= EFFICIENT_POSE_NMS_MAX_KEYPOINTS);
+                auto const* keypointSigmas = static_cast<float const*>(fields[i].data);
+                for (int32_t j = 0; j < fields[i].length; j++)
+                {
+                    PLUGIN_VALIDATE(keypointSigmas[j] > 0.0F);
+                    mParam.keypointSigmas[j] = keypointSigmas[j];
+                }
+                mParam.numKeypoints = fields[i].length;
+            }
+            if (!strcmp(attrName, "sparse_input"))
+            {
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const sparseInput = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(sparseInput == 0 || sparseInput == 1);
+                mParam.sparseInput = static_cast<bool>(sparseInput);
+            }
+            if (!strcmp(attrName, "num_classes"))
+            {
+                // Only used with sparse input, where the scores input has no class dimension.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const numClasses = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(numClasses >= 1);
+                mParam.numClasses = numClasses;
+                numClassesSet = true;
+            }
+            if (!strcmp(attrName, "max_swept_candidates"))
+            {
+                // Bounds the NMS of each image to its highest scoring candidates, -1 for no bound.
+                PLUGIN_VALIDATE(fields[i].type == PluginFieldType::kINT32);
+                auto const maxSweptCandidates = *(static_cast<int32_t const*>(fields[i].data));
+                PLUGIN_VALIDATE(maxSweptCandidates == -1 || maxSweptCandidates >= 1);
+                mParam.maxSweptCandidates = maxSweptCandidates;
+            }
         }
+        PLUGIN_VALIDATE(mParam.tilesPerImage == 1 || numTileTransforms == mParam.tilesPerImage);
+        PLUGIN_VALIDATE(!mParam.packedOutput || packedImageSize);
+        PLUGIN_VALIDATE(mParam.oksThreshold < 0.0F || mParam.numKeypoints > 0);
+        // The listed candidates are neither tiled nor reduced per anchor.
+        PLUGIN_VALIDATE(!mParam.sparseInput || (numClassesSet && mParam.tilesPerImage == 1 && !mParam.classArgmax));
 
         auto* plugin = new EfficientPoseNMSPlugin(mParam);
         plugin->setPluginNamespace(mNamespace.c_str());
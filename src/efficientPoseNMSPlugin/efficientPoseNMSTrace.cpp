@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "efficientPoseNMSTrace.h"
+
+#ifdef EFFICIENT_POSE_NMS_TRACE
+
+#include <atomic>
+
+using namespace nvinfer1::plugin;
+
+namespace
+{
+
+std::atomic<EfficientPoseNMSTraceSink*> gTraceSink{nullptr};
+std::atomic<int32_t> gTraceThreadCount{0};
+
+int64_t toNanoseconds(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+EfficientPoseNMSChromeTraceSink::EfficientPoseNMSChromeTraceSink(char const* path)
+    : mFile(std::fopen(path, "w"))
+{
+    if (mFile != nullptr)
+    {
+        std::fputs("{\"traceEvents\":[\n", mFile);
+    }
+}
+
+EfficientPoseNMSChromeTraceSink::~EfficientPoseNMSChromeTraceSink()
+{
+    if (mFile != nullptr)
+    {
+        std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", mFile);
+        std::fclose(mFile);
+    }
+}
+
+void EfficientPoseNMSChromeTraceSink::record(char const* name, int64_t startTime, int64_t endTime, int32_t threadId)
+{
+    if (mFile == nullptr)
+    {
+        return;
+    }
+    // Complete ("X") events, with the times in microseconds as the format expects. The names are identifiers, which
+    // need no escaping.
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::fprintf(mFile, "%s{\"name\":\"%s\",\"cat\":\"EfficientPoseNMS\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"pid\":0,\"tid\":%d}",
+        mFirstEvent ? "" : ",\n", name, startTime / 1e3, (endTime - startTime) / 1e3, threadId);
+    mFirstEvent = false;
+}
+
+void setEfficientPoseNMSTraceSink(EfficientPoseNMSTraceSink* sink)
+{
+    gTraceSink.store(sink, std::memory_order_release);
+}
+
+int32_t getEfficientPoseNMSTraceThreadId()
+{
+    thread_local int32_t const threadId = gTraceThreadCount.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+EfficientPoseNMSTraceScope::EfficientPoseNMSTraceScope(char const* name)
+    : mName(name)
+    , mSink(gTraceSink.load(std::memory_order_acquire))
+{
+    // Without a sink, the range costs a single load.
+    if (mSink != nullptr)
+    {
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+EfficientPoseNMSTraceScope::~EfficientPoseNMSTraceScope()
+{
+    if (mSink != nullptr)
+    {
+        auto end = std::chrono::steady_clock::now();
+        mSink->record(mName, toNanoseconds(mStart), toNanoseconds(end), getEfficientPoseNMSTraceThreadId());
+    }
+}
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#endif
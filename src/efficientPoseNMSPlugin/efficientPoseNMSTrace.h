@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 1993-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRT_EFFICIENT_POSE_NMS_TRACE_H
+#define TRT_EFFICIENT_POSE_NMS_TRACE_H
+
+// Scoped range annotations, enabled by defining EFFICIENT_POSE_NMS_TRACE. Without it, EFFICIENT_POSE_NMS_TRACE_SCOPE
+// expands to nothing, and none of the declarations below exist.
+//
+// Each EFFICIENT_POSE_NMS_TRACE_SCOPE(name) records one range, from where it is declared to the end of its scope, on
+// the calling thread. Ranges are passed to the installed sink, if any. Note that the device stages are only
+// enqueued by the ranges they are recorded in, so their ranges hold the launch time, not the kernel time.
+
+#ifdef EFFICIENT_POSE_NMS_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+namespace nvinfer1
+{
+namespace plugin
+{
+
+// Receives the recorded ranges. Ranges are recorded from any thread, so implementations must be thread safe. Times
+// are in nanoseconds of std::chrono::steady_clock, and names are string literals.
+class EfficientPoseNMSTraceSink
+{
+public:
+    virtual ~EfficientPoseNMSTraceSink() = default;
+
+    virtual void record(char const* name, int64_t startTime, int64_t endTime, int32_t threadId) = 0;
+};
+
+// Writes the ranges as Chrome trace event JSON, which can be opened in chrome://tracing or Perfetto.
+class EfficientPoseNMSChromeTraceSink : public EfficientPoseNMSTraceSink
+{
+public:
+    explicit EfficientPoseNMSChromeTraceSink(char const* path);
+    ~EfficientPoseNMSChromeTraceSink() override;
+
+    EfficientPoseNMSChromeTraceSink(EfficientPoseNMSChromeTraceSink const&) = delete;
+    EfficientPoseNMSChromeTraceSink& operator=(EfficientPoseNMSChromeTraceSink const&) = delete;
+
+    bool isOpen() const
+    {
+        return mFile != nullptr;
+    }
+
+    void record(char const* name, int64_t startTime, int64_t endTime, int32_t threadId) override;
+
+private:
+    std::mutex mMutex;
+    FILE* mFile{nullptr};
+    bool mFirstEvent{true};
+};
+
+// Installs the sink that receives all ranges, or removes it with nullptr. The sink must outlive any range that is
+// still being recorded.
+void setEfficientPoseNMSTraceSink(EfficientPoseNMSTraceSink* sink);
+
+// Small sequential id of the calling thread, assigned on first use.
+int32_t getEfficientPoseNMSTraceThreadId();
+
+class EfficientPoseNMSTraceScope
+{
+public:
+    explicit EfficientPoseNMSTraceScope(char const* name);
+    ~EfficientPoseNMSTraceScope();
+
+    EfficientPoseNMSTraceScope(EfficientPoseNMSTraceScope const&) = delete;
+    EfficientPoseNMSTraceScope& operator=(EfficientPoseNMSTraceScope const&) = delete;
+
+private:
+    char const* mName;
+    EfficientPoseNMSTraceSink* mSink;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+} // namespace plugin
+} // namespace nvinfer1
+
+#define EFFICIENT_POSE_NMS_TRACE_CONCAT_(a, b) a##b
+#define EFFICIENT_POSE_NMS_TRACE_CONCAT(a, b) EFFICIENT_POSE_NMS_TRACE_CONCAT_(a, b)
+#define EFFICIENT_POSE_NMS_TRACE_SCOPE(name)                                                                           \
+    nvinfer1::plugin::EfficientPoseNMSTraceScope EFFICIENT_POSE_NMS_TRACE_CONCAT(efficientPoseNMSTraceScope, __LINE__)( \
+        name)
+
+#else
+
+#define EFFICIENT_POSE_NMS_TRACE_SCOPE(name)
+
+#endif
+
+#endif
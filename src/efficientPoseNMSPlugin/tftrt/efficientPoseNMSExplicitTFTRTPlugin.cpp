@@ -77,6 +77,7 @@ EfficientPoseNMSExplicitTFTRTPluginCreator::EfficientPoseNMSExplicitTFTRTPluginC
     mPluginAttributes.emplace_back(PluginField("score_threshold", nullptr, PluginFieldType::kFLOAT32, 1));
     mPluginAttributes.emplace_back(PluginField("pad_per_class", nullptr, PluginFieldType::kINT32, 1));
     mPluginAttributes.emplace_back(PluginField("clip_boxes", nullptr, PluginFieldType::kINT32, 1));
+    mPluginAttributes.emplace_back(PluginField("class_major_output", nullptr, PluginFieldType::kINT32, 1));
     mFC.nbFields = mPluginAttributes.size();
     mFC.fields = mPluginAttributes.data();
 }
@@ -135,7 +136,14 @@ IPluginV2DynamicExt* EfficientPoseNMSExplicitTFTRTPluginCreator::createPlugin(
                 PLUGIN_ASSERT(fields[i].type == PluginFieldType::kINT32);
                 mParam.clipBoxes = *(static_cast<const int32_t*>(fields[i].data));
             }
+            if (!strcmp(attrName, "class_major_output"))
+            {
+                // Gives every class its own max_output_size_per_class slots, with per class counts.
+                PLUGIN_ASSERT(fields[i].type == PluginFieldType::kINT32);
+                mParam.classMajorOutput = *(static_cast<const int32_t*>(fields[i].data));
+            }
         }
+        PLUGIN_ASSERT(!mParam.classMajorOutput || mParam.numOutputBoxesPerClass > 0);
 
         auto* plugin = new EfficientPoseNMSExplicitTFTRTPlugin(mParam);
         plugin->setPluginNamespace(mNamespace.c_str());
@@ -45,9 +45,13 @@ EfficientPoseNMSImplicitTFTRTPlugin::EfficientPoseNMSImplicitTFTRTPlugin(void co
 
 void EfficientPoseNMSImplicitTFTRTPlugin::deserialize(int8_t const* data, size_t length)
 {
+    // The parameters are stored raw, so they are only read back with the layout they were written with.
     auto const* d{data};
+    PLUGIN_VALIDATE(length >= sizeof(int32_t));
+    PLUGIN_VALIDATE(read<int32_t>(d) == EFFICIENT_POSE_NMS_SERIALIZATION_VERSION);
+    PLUGIN_VALIDATE(length == sizeof(int32_t) + sizeof(EfficientPoseNMSParameters));
     mParam = read<EfficientPoseNMSParameters>(d);
-    PLUGIN_ASSERT(d == data + length);
+    PLUGIN_VALIDATE(d == data + length);
 }
 
 const char* EfficientPoseNMSImplicitTFTRTPlugin::getPluginType() const noexcept
@@ -74,12 +78,13 @@ void EfficientPoseNMSImplicitTFTRTPlugin::terminate() noexcept {}
 
 size_t EfficientPoseNMSImplicitTFTRTPlugin::getSerializationSize() const noexcept
 {
-    return sizeof(EfficientPoseNMSParameters);
+    return sizeof(int32_t) + sizeof(EfficientPoseNMSParameters);
 }
 
 void EfficientPoseNMSImplicitTFTRTPlugin::serialize(void* buffer) const noexcept
 {
     char *d = reinterpret_cast<char*>(buffer), *a = d;
+    write(d, static_cast<int32_t>(EFFICIENT_POSE_NMS_SERIALIZATION_VERSION));
     write(d, mParam);
     PLUGIN_ASSERT(d == a + getSerializationSize());
 }
@@ -168,7 +173,9 @@ int32_t EfficientPoseNMSImplicitTFTRTPlugin::enqueue(int32_t batchSize, void con
 {
     try
     {
-        mParam.batchSize = batchSize;
+        // See EfficientPoseNMSPlugin::enqueue, the plugin is not modified so that concurrent calls do not race.
+        EfficientPoseNMSParameters param = mParam;
+        param.batchSize = batchSize;
 
         void const* const boxesInput = inputs[0];
         void const* const scoresInput = inputs[1];
@@ -180,8 +187,8 @@ int32_t EfficientPoseNMSImplicitTFTRTPlugin::enqueue(int32_t batchSize, void con
         void* nmsScoresOutput = outputs[3];
         void* nmsClassesOutput = outputs[4];
 
-        return EfficientPoseNMSInference(mParam, boxesInput, scoresInput, anchorsInput, numDetectionsOutput, nmsBoxesOutput, nmsKptsOutput,
-            nmsScoresOutput, nmsClassesOutput, nullptr, workspace, stream);
+        return EfficientPoseNMSInference(param, boxesInput, scoresInput, anchorsInput, nullptr, numDetectionsOutput,
+            nmsBoxesOutput, nmsKptsOutput, nmsScoresOutput, nmsClassesOutput, nullptr, nullptr, workspace, stream);
     }
     catch (const std::exception& e)
     {